@@ -23,12 +23,14 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/function.hpp>
 #include <boost/operators.hpp>
+#include <complex>
 #include <string>
+#include <vector>
 
 namespace uhd{ namespace convert{
 
     //! A conversion class that implements a conversion from inputs -> outputs.
-    class converter{
+    class UHD_API converter{
     public:
         typedef boost::shared_ptr<converter> sptr;
         typedef uhd::ref_vector<void *> output_type;
@@ -39,6 +41,25 @@ namespace uhd{ namespace convert{
         //! Set the scale factor (used in floating point conversions)
         virtual void set_scalar(const double) = 0;
 
+        /*!
+         * Set a sample correction to apply while converting.
+         *
+         * Only converters with a corrected output format (e.g. "fc32_corr")
+         * support this; all others throw uhd::not_implemented_error.
+         * For an input sample x = I + jQ, scaled by the scale factor,
+         * the output is gain * B(x - dc_offset), where B is the IQ balance
+         * I' = (1 + real(iq_balance))*I, Q' = Q + imag(iq_balance)*I.
+         *
+         * \param gain the complex gain applied last
+         * \param dc_offset the DC offset to remove (full scale units)
+         * \param iq_balance magnitude (real) and phase (imag) correction
+         */
+        virtual void set_correction(
+            const std::complex<double> &gain,
+            const std::complex<double> &dc_offset,
+            const std::complex<double> &iq_balance
+        );
+
         //! The public conversion method to convert inputs -> outputs
         UHD_INLINE void conv(const input_type &in, const output_type &out, const size_t num){
             if (num != 0) (*this)(in, out, num);
@@ -101,6 +122,34 @@ namespace uhd{ namespace convert{
         const priority_type prio = -1
     );
 
+    /*!
+     * Get the fastest converter factory function on this host.
+     *
+     * On first use, every registered priority for the ID is timed while
+     * converting buffers of the given size, and the fastest one wins.
+     * The winner is remembered for the life of the process and persisted
+     * in the UHD config directory, so later calls (also from other
+     * processes) skip the benchmark.
+     *
+     * \param id identify the conversion
+     * \param nsamps the number of items per conversion call (typically spp)
+     * \return the converter factory function
+     */
+    UHD_API function_type get_converter_tuned(
+        const id_type &id,
+        const size_t nsamps
+    );
+
+    //! Get the IDs of all registered converters
+    UHD_API std::vector<id_type> get_converter_ids(void);
+
+    /*!
+     * Get the priorities registered for a converter.
+     * \param id identify the conversion
+     * \return the registered priorities, in ascending order
+     */
+    UHD_API std::vector<priority_type> get_converter_priorities(const id_type &id);
+
     /*!
      * Register the size of a particular item.
      * \param format the item format
@@ -212,6 +212,49 @@ struct fs_path : std::string{
 UHD_API fs_path operator/(const fs_path &, const fs_path &);
 UHD_API fs_path operator/(const fs_path &, size_t);
 
+/*!
+ * The deferred property updates of property tree transactions.
+ * One queue is shared by a tree, its subtrees and their properties,
+ * each thread has its own transaction in it.
+ * See property_tree::begin_transaction().
+ */
+class UHD_API property_transaction_queue : boost::noncopyable{
+public:
+    typedef boost::shared_ptr<property_transaction_queue> sptr;
+    typedef boost::function<void(void)> update_type;
+
+    virtual ~property_transaction_queue(void) = 0;
+
+    //! Make a new queue without an open transaction
+    static sptr make(void);
+
+    //! Open a transaction for the calling thread, transactions nest
+    virtual void begin(void) = 0;
+
+    /*!
+     * Close a transaction of the calling thread.
+     * When the outermost one is closed, run the queued updates
+     * in rounds until no more updates are queued.
+     * \throws uhd::runtime_error when no transaction is open
+     */
+    virtual void commit(void) = 0;
+
+    /*!
+     * Queue the update of a property when the calling thread has a transaction open.
+     * A property that is already queued keeps its place and update.
+     * \param prop the property, identifies the update
+     * \param update applies the property's current desired value
+     * \return false when no transaction is open, the caller updates now
+     */
+    virtual bool defer(const void *prop, const update_type &update) = 0;
+
+    //! Run the queued update of a property now if the calling thread is committing
+    virtual void flush(const void *prop) = 0;
+
+    //! Drop the queued update of a property that goes away
+    virtual void forget(const void *prop) = 0;
+};
+
 /*!
  * The property tree provides a file system structure for accessing properties.
  */
@@ -238,6 +281,22 @@ public:
     //! Get an iterable to all things in the given path
     virtual std::vector<std::string> list(const fs_path &path) const = 0;
 
+    typedef boost::function<void(void)> lazy_init_type;
+
+    /*!
+     * Create a directory that is populated on first use:
+     * The directory is created and listed by its parent right away.
+     * Its init functions run once, in the order they were added,
+     * before anything at or below the path is first accessed,
+     * created, listed or checked for existence.
+     * The init functions use the tree as it is: calls they make do not
+     * run the init functions of other lazy directories.
+     * Removing the directory drops the init functions that did not run.
+     * \param path the directory to populate on first use
+     * \param init populates the directory, called at most once
+     */
+    virtual void create_lazy(const fs_path &path, const lazy_init_type &init) = 0;
+
     //! Create a new property entry in the tree
     template <typename T> property<T> &create(
         const fs_path &path,
@@ -246,7 +305,35 @@ public:
     //! Get access to a property in the tree
     template <typename T> property<T> &access(const fs_path &path);
 
+    /*!
+     * Begin a transaction on this tree, including its subtrees:
+     * Until the transaction is committed, setting a property from
+     * the calling thread only stores its desired value.
+     * Its desired subscribers, coercer and coerced subscribers
+     * are deferred, and a property that is set several times
+     * is only updated once, with its last value.
+     * get() returns the coerced values from before the transaction until then.
+     * Transactions nest; only the outermost commit applies the updates.
+     * Other threads are not affected, and set_coerced() is not deferred.
+     */
+    void begin_transaction(void);
+
+    /*!
+     * Commit a transaction:
+     * When this closes the outermost transaction, the deferred updates
+     * run once each, in the order their properties were first set.
+     * Properties set by those updates are deferred to the next round,
+     * so a property that depends on several others is updated once,
+     * after all of them. Reading a property with a deferred update
+     * during the commit applies the update first.
+     * An error stops the commit and the remaining updates are dropped.
+     */
+    void commit_transaction(void);
+
 private:
+    //! Internal get the transaction queue shared by the tree
+    virtual property_transaction_queue::sptr _transactions(void) const = 0;
+
     //! Internal create property with wild-card type
     virtual void _create(const fs_path &path, const boost::shared_ptr<void> &prop) = 0;
 
@@ -20,6 +20,7 @@
 
 #include <uhd/exception.hpp>
 #include <boost/foreach.hpp>
+#include <boost/bind.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <vector>
 
@@ -30,7 +31,10 @@ namespace uhd{ namespace /*anon*/{
 
 template <typename T> class property_impl : public property<T>{
 public:
-    property_impl<T>(property_tree::coerce_mode_t mode) : _coerce_mode(mode){
+    property_impl<T>(
+        property_tree::coerce_mode_t mode,
+        property_transaction_queue::sptr transactions = property_transaction_queue::sptr()
+    ) : _coerce_mode(mode), _transactions(transactions){
         if (_coerce_mode == property_tree::AUTO_COERCE) {
             _coercer = DEFAULT_COERCER;
         }
@@ -79,6 +83,14 @@ public:
 
     property<T> &set(const T &value){
         init_or_set_value(_value, value);
+        if (_transactions and _transactions->defer(
+            static_cast<property<T> *>(this), boost::bind(&property_impl<T>::_update_desired, this)
+        )) return *this;
+        this->_update_desired();
+        return *this;
+    }
+
+    void _update_desired(void){
         BOOST_FOREACH(typename property<T>::subscriber_type &dsub, _desired_subscribers){
             dsub(get_value_ref(_value)); //let errors propagate
         }
@@ -87,7 +99,6 @@ public:
         } else {
             if (_coerce_mode == property_tree::AUTO_COERCE) uhd::assertion_error("coercer missing for an auto coerced property");
         }
-        return *this;
     }
 
     property<T> &set_coerced(const T &value){
@@ -97,6 +108,7 @@ public:
     }
 
     const T get(void) const{
+        if (_transactions) _transactions->flush(static_cast<const property<T> *>(this));
         if (empty()) throw uhd::runtime_error("Cannot get() on an uninitialized (empty) property");
         if (not _publisher.empty()) {
             return _publisher();
@@ -136,6 +148,7 @@ private:
     }
 
     const property_tree::coerce_mode_t                  _coerce_mode;
+    const property_transaction_queue::sptr              _transactions;
     std::vector<typename property<T>::subscriber_type>  _desired_subscribers;
     std::vector<typename property<T>::subscriber_type>  _coerced_subscribers;
     typename property<T>::publisher_type                _publisher;
@@ -152,7 +165,7 @@ private:
 namespace uhd{
 
     template <typename T> property<T> &property_tree::create(const fs_path &path, coerce_mode_t coerce_mode){
-        this->_create(path, typename boost::shared_ptr<property<T> >(new property_impl<T>(coerce_mode)));
+        this->_create(path, typename boost::shared_ptr<property<T> >(new property_impl<T>(coerce_mode, this->_transactions())));
         return this->access<T>(path);
     }
 
@@ -25,6 +25,7 @@
 #include <uhd/types/ref_vector.hpp>
 #include <boost/utility.hpp>
 #include <boost/shared_ptr.hpp>
+#include <complex>
 #include <vector>
 #include <string>
 
@@ -89,6 +90,8 @@ struct UHD_API stream_args_t{
      *  - sc16 - Q16 I16
      *  - sc8 - Q8_1 I8_1 Q8_0 I8_0
      *  - sc12 (Only some devices)
+     *  - sc4 - Q4_3 I4_3 Q4_2 I4_2 Q4_1 I4_1 Q4_0 I4_0
+     *    (host converters and packet handling only, no device supports it yet)
      *
      * The following are not implemented, but are listed to demonstrate naming convention:
      *  - s16 - R16_1 R16_0
@@ -130,6 +133,37 @@ struct UHD_API stream_args_t{
      *
      * - noclear: Used by tx_dsp_core_200 and rx_dsp_core_200
      *
+     * - convert_autotune: set to 1 to pick the fastest registered converter
+     * on this host instead of the one with the highest static priority.
+     * All candidates are timed at the streamer's samples per packet on first
+     * use, and the choice is stored in the UHD config directory
+     * (see uhd::convert::get_converter_tuned()).
+     *
+     * - convert_nt: (RX only) controls the converters with non-temporal stores,
+     * which write the samples to memory without filling the cache
+     * (for large buffers that are not read back right away).
+     * "auto" (default) uses them for receive buffers of at least convert_nt_thresh bytes
+     * (default 4 MiB), "1" always and "0" never. They are only available
+     * for some formats (sc16 to fc32 with SSE2) and are not used together with
+     * host_correction, nco_freq or host-side resampling.
+     *
+     * - host_correction: set to 1 to apply a complex gain, DC offset and IQ balance
+     * correction on the host, fused into the RX conversion to fc32.
+     * The correction starts as identity and is updated with
+     * uhd::rx_streamer::set_host_correction().
+     *
+     * - nco_freq: shift all channels by this frequency in Hz on the host,
+     * while converting (samples are multiplied by exp(j*2*pi*nco_freq*t)).
+     * Use nco_freq0, nco_freq1, ... to set channels of the streamer individually.
+     * The phase follows the packet timestamps, so it is continuous across
+     * packets and calls. Requires the fc32 CPU format.
+     *
+     * - resamp_interp, resamp_decim: (RX only) resample the received samples on the host
+     * by resamp_interp/resamp_decim with a polyphase filter (resamp_taps taps per phase,
+     * default 32). The streamer then delivers samples at the device's RX rate times this
+     * ratio, and the metadata time spec refers to the resampled samples, including
+     * the filter delay. Requires the fc32 CPU format.
+     *
      * The following are not implemented, but are listed for conceptual purposes:
      * - function: magnitude or phase/magnitude
      * - units: numeric units like counts or dBm
@@ -244,6 +278,26 @@ public:
      * \param stream_cmd the stream command to issue
      */
     virtual void issue_stream_cmd(const stream_cmd_t &stream_cmd) = 0;
+
+    /*!
+     * Update the host-side sample correction for one channel.
+     * Requires a streamer created with the "host_correction" stream arg.
+     * This may be called from another thread while streaming;
+     * the new correction takes effect at the start of the next recv().
+     * See uhd::convert::converter::set_correction() for the parameters.
+     *
+     * \param chan the channel index on this streamer
+     * \param gain the complex gain
+     * \param dc_offset the DC offset to remove
+     * \param iq_balance magnitude (real) and phase (imag) correction
+     * \throws uhd::not_implemented_error without host correction support
+     */
+    virtual void set_host_correction(
+        const size_t chan,
+        const std::complex<double> &gain,
+        const std::complex<double> &dc_offset = 0.0,
+        const std::complex<double> &iq_balance = 0.0
+    );
 };
 
 /*!
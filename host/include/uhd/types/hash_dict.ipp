@@ -0,0 +1,170 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_UHD_TYPES_HASH_DICT_IPP
+#define INCLUDED_UHD_TYPES_HASH_DICT_IPP
+
+#include <uhd/exception.hpp>
+#include <boost/foreach.hpp>
+#include <boost/format.hpp>
+#include <boost/functional/hash.hpp>
+#include <algorithm>
+
+namespace uhd{
+
+    /*******************************************************************
+     * Index helpers:
+     * The index has a power of two number of slots, kept at most half
+     * full, and is probed linearly from the key's hash.
+     ******************************************************************/
+    template <typename Key, typename Val>
+    std::size_t hash_dict<Key, Val>::find(const Key &key) const{
+        if (_index.empty()) return _items.size();
+        const std::size_t mask = _index.size() - 1;
+        for (std::size_t i = boost::hash<Key>()(key) & mask;; i = (i + 1) & mask){
+            const std::size_t slot = _index[i];
+            if (slot == 0) return _items.size();
+            if (_items[slot-1].first == key) return slot-1;
+        }
+    }
+
+    template <typename Key, typename Val>
+    void hash_dict<Key, Val>::insert_index(const std::size_t pos){
+        const std::size_t mask = _index.size() - 1;
+        std::size_t i = boost::hash<Key>()(_items[pos].first) & mask;
+        while (_index[i] != 0) i = (i + 1) & mask;
+        _index[i] = pos + 1;
+    }
+
+    template <typename Key, typename Val>
+    void hash_dict<Key, Val>::rebuild_index(const std::size_t num_slots){
+        _index.assign(num_slots, 0);
+        for (std::size_t pos = 0; pos < _items.size(); pos++){
+            this->insert_index(pos);
+        }
+    }
+
+    /*******************************************************************
+     * Dict interface
+     ******************************************************************/
+    template <typename Key, typename Val>
+    hash_dict<Key, Val>::hash_dict(void){
+        /* NOP */
+    }
+
+    template <typename Key, typename Val> template <typename InputIterator>
+    hash_dict<Key, Val>::hash_dict(InputIterator first, InputIterator last){
+        for (; first != last; ++first){
+            (*this)[first->first] = first->second;
+        }
+    }
+
+    template <typename Key, typename Val>
+    std::size_t hash_dict<Key, Val>::size(void) const{
+        return _items.size();
+    }
+
+    template <typename Key, typename Val>
+    std::vector<Key> hash_dict<Key, Val>::keys(void) const{
+        std::vector<Key> keys;
+        keys.reserve(_items.size());
+        BOOST_FOREACH(const pair_t &p, _items){
+            keys.push_back(p.first);
+        }
+        return keys;
+    }
+
+    template <typename Key, typename Val>
+    std::vector<Val> hash_dict<Key, Val>::vals(void) const{
+        std::vector<Val> vals;
+        vals.reserve(_items.size());
+        BOOST_FOREACH(const pair_t &p, _items){
+            vals.push_back(p.second);
+        }
+        return vals;
+    }
+
+    template <typename Key, typename Val>
+    bool hash_dict<Key, Val>::has_key(const Key &key) const{
+        return this->find(key) != _items.size();
+    }
+
+    template <typename Key, typename Val>
+    const Val &hash_dict<Key, Val>::get(const Key &key, const Val &other) const{
+        const std::size_t pos = this->find(key);
+        if (pos == _items.size()) return other;
+        return _items[pos].second;
+    }
+
+    template <typename Key, typename Val>
+    const Val &hash_dict<Key, Val>::get(const Key &key) const{
+        const std::size_t pos = this->find(key);
+        if (pos == _items.size()) throw key_not_found<Key, Val>(key);
+        return _items[pos].second;
+    }
+
+    template <typename Key, typename Val>
+    void hash_dict<Key, Val>::set(const Key &key, const Val &val){
+        (*this)[key] = val;
+    }
+
+    template <typename Key, typename Val>
+    const Val &hash_dict<Key, Val>::operator[](const Key &key) const{
+        return this->get(key);
+    }
+
+    template <typename Key, typename Val>
+    Val &hash_dict<Key, Val>::operator[](const Key &key){
+        const std::size_t pos = this->find(key);
+        if (pos != _items.size()) return _items[pos].second;
+
+        _items.push_back(std::make_pair(key, Val()));
+        if (_items.size()*2 > _index.size()){
+            this->rebuild_index(std::max<std::size_t>(8, _index.size()*2));
+        }
+        else this->insert_index(_items.size()-1);
+        return _items.back().second;
+    }
+
+    template <typename Key, typename Val>
+    Val hash_dict<Key, Val>::pop(const Key &key){
+        const std::size_t pos = this->find(key);
+        if (pos == _items.size()) throw key_not_found<Key, Val>(key);
+        Val val = _items[pos].second;
+        _items.erase(_items.begin() + pos);
+        //positions after the popped entry have shifted
+        this->rebuild_index(_index.size());
+        return val;
+    }
+
+    template <typename Key, typename Val>
+    void hash_dict<Key, Val>::update(const hash_dict<Key, Val> &new_dict, bool fail_on_conflict)
+    {
+        BOOST_FOREACH(const pair_t &p, new_dict._items) {
+            if (fail_on_conflict and has_key(p.first) and get(p.first) != p.second) {
+                throw uhd::value_error(str(
+                    boost::format("Option merge conflict: %s:%s != %s:%s")
+                    % p.first % get(p.first) % p.first % p.second
+                ));
+            }
+            set(p.first, p.second);
+        }
+    }
+
+} //namespace uhd
+
+#endif /* INCLUDED_UHD_TYPES_HASH_DICT_IPP */
@@ -22,6 +22,8 @@
 #include <uhd/types/time_spec.hpp>
 #include <boost/cstdint.hpp>
 #include <boost/shared_ptr.hpp>
+#include <utility>
+#include <vector>
 
 namespace uhd
 {
@@ -31,6 +33,7 @@ class UHD_API wb_iface
 public:
     typedef boost::shared_ptr<wb_iface> sptr;
     typedef boost::uint32_t wb_addr_type;
+    typedef std::vector<std::pair<wb_addr_type, boost::uint32_t> > poke32_batch_type;
 
     virtual ~wb_iface(void);
 
@@ -62,6 +65,23 @@ public:
      */
     virtual boost::uint32_t peek32(const wb_addr_type addr);
 
+    /*!
+     * Write several registers (32 bits), in order.
+     * Interfaces that can keep several writes in flight override
+     * this, the default calls poke32() for every register.
+     * \param pokes the address and 32bit data of every write
+     */
+    virtual void poke32_batch(const poke32_batch_type &pokes);
+
+    /*!
+     * Read several registers (32 bits), in order.
+     * Interfaces that can keep several reads in flight override
+     * this, the default calls peek32() for every register.
+     * \param addrs the addresses
+     * \return the 32bit data of every address
+     */
+    virtual std::vector<boost::uint32_t> peek32_batch(const std::vector<wb_addr_type> &addrs);
+
     /*!
      * Write a register (16 bits)
      * \param addr the address
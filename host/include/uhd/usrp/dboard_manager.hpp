@@ -114,6 +114,7 @@ public:
      * \param gdboard_id the id of the grand-dboard
      * \param iface the custom dboard interface
      * \param subtree the subtree to load with props
+     * \param defer_init make each subdev on first use of its frontend
      * \return an sptr to the new dboard manager
      */
     static sptr make(
@@ -121,7 +122,8 @@ public:
         dboard_id_t tx_dboard_id,
         dboard_id_t gdboard_id,
         dboard_iface::sptr iface,
-        property_tree::sptr subtree
+        property_tree::sptr subtree,
+        const bool defer_init = false
     );
 };
 
@@ -31,6 +31,7 @@
 #define UHD_USRP_MULTI_USRP_GPIO_API
 #define UHD_USRP_MULTI_USRP_REGISTER_API
 #define UHD_USRP_MULTI_USRP_FILTER_API
+#define UHD_USRP_MULTI_USRP_HOP_SCHEDULE_API
 
 #include <uhd/config.hpp>
 #include <uhd/device.hpp>
@@ -276,6 +277,73 @@ public:
      */
     virtual void clear_command_time(size_t mboard = ALL_MBOARDS) = 0;
 
+    /*!
+     * One timed setting of a hop schedule.
+     */
+    struct hop_t{
+        //! The setting to change at the hop time
+        enum setting_t{
+            SETTING_FREQ = int('f'),
+            SETTING_GAIN = int('g')
+        };
+
+        hop_t(
+            const time_spec_t &time = time_spec_t(0.0),
+            const size_t chan = 0,
+            const setting_t setting = SETTING_FREQ,
+            const double value = 0.0
+        ):
+            time(time), chan(chan), setting(setting), value(value)
+        {}
+
+        //! The command time of the hop
+        time_spec_t time;
+
+        //! The channel index 0 to N-1
+        size_t chan;
+
+        //! Which setting changes
+        setting_t setting;
+
+        //! The center frequency in Hz or the overall gain in dB
+        double value;
+    };
+
+    //! A list of timed hops
+    typedef std::vector<hop_t> hop_schedule_t;
+
+    /*!
+     * Run a schedule of timed RX frequency and gain hops.
+     *
+     * All hops are checked and prepared before the first one is sent:
+     * property paths and gain groups are resolved once, and frontends
+     * with fast lock profiles store one profile per hop frequency, so
+     * that a hop only recalls a profile. Frequency hops on other
+     * frontends tune like set_rx_freq() with a default tune request;
+     * the tune is worked out once per frequency and reused.
+     *
+     * The hops are sent in time order as timed commands. Since a timed
+     * command back-pressures the following ones, this call returns when
+     * the last hop is queued, which is when the command queue holds the
+     * remaining hops. The command time is cleared when it returns.
+     *
+     * Some frontends (the B200 codec) ignore the command time. On those,
+     * only frequency hops that fit into the fast lock profiles can be
+     * scheduled; other hops throw before anything is written.
+     *
+     * \param schedule the hops, in any order
+     * \throws uhd::not_implemented_error if a hop can't be timed
+     */
+    virtual void set_rx_hop_schedule(const hop_schedule_t &schedule) = 0;
+
+    /*!
+     * Run a schedule of timed TX frequency and gain hops.
+     * See set_rx_hop_schedule() for details.
+     * \param schedule the hops, in any order
+     * \throws uhd::not_implemented_error if a hop can't be timed
+     */
+    virtual void set_tx_hop_schedule(const hop_schedule_t &schedule) = 0;
+
     /*!
      * Issue a stream command to the usrp device.
      * This tells the usrp to send samples into the host.
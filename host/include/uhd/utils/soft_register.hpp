@@ -113,6 +113,8 @@ public:
 
     virtual void initialize(wb_iface& iface, bool sync = false) = 0;
     virtual void flush() = 0;
+    virtual bool begin_batch_flush(wb_iface& iface, wb_iface::poke32_batch_type& pokes) = 0;
+    virtual void end_batch_flush(bool written) = 0;
     virtual void refresh() = 0;
     virtual size_t get_bitwidth() = 0;
     virtual bool is_readable() = 0;
@@ -227,6 +229,32 @@ public:
         }
     }
 
+    /*!
+     * Queue the write of the soft-copy into a batch of 32-bit pokes for iface
+     * instead of writing it right away. Follows the flush mode just like flush().
+     * Returns false if the register cannot be batched (it is not a writable
+     * 32-bit register on iface) and must be flushed on its own.
+     * Otherwise end_batch_flush() must be called once the batch was sent
+     * or has failed. The soft-copy stays dirty until then.
+     */
+    UHD_INLINE bool begin_batch_flush(wb_iface& iface, wb_iface::poke32_batch_type& pokes)
+    {
+        if (not writable or _iface != &iface or get_bitwidth() != 32) return false;
+        if (_flush_mode == ALWAYS_FLUSH || _soft_copy.is_dirty()) {
+            pokes.push_back(std::make_pair(_wr_addr, static_cast<boost::uint32_t>(_soft_copy)));
+        }
+        return true;
+    }
+
+    /*!
+     * Finish a begin_batch_flush(). The soft-copy is marked clean only
+     * if the batch was written.
+     */
+    UHD_INLINE void end_batch_flush(bool written)
+    {
+        if (written) _soft_copy.mark_clean();
+    }
+
     /*!
      * Read the contents of the register from hardware and update the soft copy.
      */
@@ -345,6 +373,25 @@ public:
         soft_register_t<reg_data_t, readable, writable>::flush();
     }
 
+    /*!
+     * The register stays locked from a successful begin_batch_flush()
+     * until end_batch_flush(), so it cannot change while its write is
+     * on the way to hardware.
+     */
+    UHD_INLINE bool begin_batch_flush(wb_iface& iface, wb_iface::poke32_batch_type& pokes)
+    {
+        boost::unique_lock<boost::mutex> lock(_mutex);
+        if (not soft_register_t<reg_data_t, readable, writable>::begin_batch_flush(iface, pokes)) return false;
+        lock.release();
+        return true;
+    }
+
+    UHD_INLINE void end_batch_flush(bool written)
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex, boost::adopt_lock);
+        soft_register_t<reg_data_t, readable, writable>::end_batch_flush(written);
+    }
+
     UHD_INLINE void refresh()
     {
         boost::lock_guard<boost::mutex> lock(_mutex);
@@ -463,7 +510,7 @@ public:
  */
 class UHD_API soft_regmap_t : public soft_regmap_accessor_t, public boost::noncopyable {
 public:
-    soft_regmap_t(const std::string& name) : _name(name) {}
+    soft_regmap_t(const std::string& name) : _name(name), _iface(NULL) {}
     virtual ~soft_regmap_t() {};
 
     /*!
@@ -479,6 +526,7 @@ public:
      */
     void initialize(wb_iface& iface, bool sync = false) {
         boost::lock_guard<boost::mutex> lock(_mutex);
+        _iface = &iface;
         BOOST_FOREACH(soft_register_base* reg, _reglist) {
             reg->initialize(iface, sync);
         }
@@ -488,12 +536,31 @@ public:
      * Flush all registers to hardware.
      * The order of writing is the same as the order in
      * which registers were added to the map.
+     * The 32-bit writes are handed to the bus as batches
+     * (see wb_iface::poke32_batch). Registers are marked clean
+     * only once their batch was written.
+     * A batch is not one bus transaction: the radio control core
+     * still sends one packet per register and waits for every ack,
+     * it only keeps several of them in flight. Other buses write
+     * the registers one by one.
      */
     void flush() {
         boost::lock_guard<boost::mutex> lock(_mutex);
+        if (_iface == NULL) {
+            BOOST_FOREACH(soft_register_base* reg, _reglist) {
+                reg->flush();
+            }
+            return;
+        }
+        batch_flush_t batch(*_iface);
         BOOST_FOREACH(soft_register_base* reg, _reglist) {
-            reg->flush();
+            if (not batch.add(reg)) {
+                //Send what was batched so far to preserve the write order
+                batch.send();
+                reg->flush();
+            }
         }
+        batch.send();
     }
 
     /*!
@@ -557,9 +624,45 @@ private:
     typedef boost::unordered_map<std::string, soft_register_base*> regmap_t;
     typedef std::list<soft_register_base*>                         reglist_t;
 
+    /*!
+     * The registers of one batched write. Registers that were not
+     * sent when the batch goes out of scope (the write threw) are
+     * released without being marked clean.
+     */
+    class batch_flush_t : public boost::noncopyable {
+    public:
+        batch_flush_t(wb_iface& iface) : _iface(iface) {}
+        ~batch_flush_t() { end(false); }
+
+        UHD_INLINE bool add(soft_register_base* reg) {
+            if (not reg->begin_batch_flush(_iface, _pokes)) return false;
+            _regs.push_back(reg);
+            return true;
+        }
+
+        UHD_INLINE void send() {
+            if (not _pokes.empty()) _iface.poke32_batch(_pokes);
+            end(true);
+        }
+
+    private:
+        UHD_INLINE void end(bool written) {
+            BOOST_FOREACH(soft_register_base* reg, _regs) {
+                reg->end_batch_flush(written);
+            }
+            _regs.clear();
+            _pokes.clear();
+        }
+
+        wb_iface&                   _iface;
+        wb_iface::poke32_batch_type _pokes;
+        reglist_t                   _regs;
+    };
+
     const std::string   _name;
     regmap_t            _regmap;    //For lookups
     reglist_t           _reglist;   //To maintain order
+    wb_iface*           _iface;     //Bus of the last initialize, for batched flushes
     boost::mutex        _mutex;
 };
 
@@ -21,6 +21,7 @@
 #include <uhd/convert.hpp>
 #include <uhd/utils/static.hpp>
 #include <boost/cstdint.hpp>
+#include <algorithm>
 #include <complex>
 
 #define _DECLARE_CONVERTER(name, in_form, num_in, out_form, num_out, prio) \
@@ -92,6 +93,57 @@ typedef boost::uint32_t              item32_t;
 
 typedef item32_t (*xtox_t)(item32_t);
 
+/***********************************************************************
+ * Base for converters with a corrected output format (*_corr)
+ *  - The scale factor, IQ balance and complex gain are folded into
+ *    a 2x2 real matrix and the DC offset into an output offset:
+ *    out.re = m[0]*I + m[1]*Q + b[0], out.im = m[2]*I + m[3]*Q + b[1]
+ **********************************************************************/
+class corrected_converter : public uhd::convert::converter{
+public:
+    corrected_converter(void):
+        _scalar(1.0), _gain(1.0), _dc_offset(0.0), _iq_balance(0.0)
+    {
+        this->update();
+    }
+
+    void set_scalar(const double scalar){
+        _scalar = scalar;
+        this->update();
+    }
+
+    void set_correction(
+        const std::complex<double> &gain,
+        const std::complex<double> &dc_offset,
+        const std::complex<double> &iq_balance
+    ){
+        _gain = gain;
+        _dc_offset = dc_offset;
+        _iq_balance = iq_balance;
+        this->update();
+    }
+
+protected:
+    float _m[4], _b[2];
+
+private:
+    void update(void){
+        //gain matrix times the IQ balance matrix
+        const double gr = _gain.real(), gi = _gain.imag();
+        const double m00 = gr*(1.0 + _iq_balance.real()) - gi*_iq_balance.imag();
+        const double m01 = -gi;
+        const double m10 = gi*(1.0 + _iq_balance.real()) + gr*_iq_balance.imag();
+        const double m11 = gr;
+        _m[0] = float(m00*_scalar); _m[1] = float(m01*_scalar);
+        _m[2] = float(m10*_scalar); _m[3] = float(m11*_scalar);
+        _b[0] = float(-(m00*_dc_offset.real() + m01*_dc_offset.imag()));
+        _b[1] = float(-(m10*_dc_offset.real() + m11*_dc_offset.imag()));
+    }
+
+    double _scalar;
+    std::complex<double> _gain, _dc_offset, _iq_balance;
+};
+
 /***********************************************************************
  * Convert xx to items32 sc16 buffer
  **********************************************************************/
@@ -289,4 +341,88 @@ UHD_INLINE void item32_sc8_to_xx(
     }
 }
 
+/***********************************************************************
+ * Convert xx to items32 sc4 buffer
+ *  - One byte per sample, I in the upper nibble, Q in the lower nibble,
+ *    four samples per item, the first one in the most significant byte
+ *  - Values are rounded and saturated to [-8, 7]
+ **********************************************************************/
+template <typename T> UHD_INLINE boost::uint8_t xx_to_sc4_nibble(const T value){
+    const T clipped = std::max(T(-8), std::min(T(7), value));
+    return boost::uint8_t(int((clipped < 0)? clipped - T(0.5) : clipped + T(0.5)) & 0xf);
+}
+
+template <typename T> UHD_INLINE boost::uint8_t xx_to_sc4_x1(
+    const std::complex<T> &in, const double scale_factor
+){
+    return boost::uint8_t((xx_to_sc4_nibble<T>(in.real()*T(scale_factor)) << 4) |
+        xx_to_sc4_nibble<T>(in.imag()*T(scale_factor)));
+}
+
+//sc16 is scaled the same as in the sc16 to sc8 table converters
+template <> UHD_INLINE boost::uint8_t xx_to_sc4_x1(
+    const sc16_t &in, const double scale_factor
+){
+    const float scalar = float(scale_factor/32767.);
+    return boost::uint8_t((xx_to_sc4_nibble<float>(in.real()*scalar) << 4) |
+        xx_to_sc4_nibble<float>(in.imag()*scalar));
+}
+
+template <xtox_t to_wire, typename T>
+UHD_INLINE void xx_to_item32_sc4(
+    const std::complex<T> *input,
+    item32_t *output,
+    const size_t nsamps,
+    const double scale_factor
+){
+    for (size_t i = 0, j = 0; i < nsamps; i+=4, j++){
+        item32_t item = 0;
+        for (size_t k = 0; k < 4; k++){
+            const std::complex<T> in = (i+k < nsamps)? input[i+k] : std::complex<T>(0);
+            item |= item32_t(xx_to_sc4_x1(in, scale_factor)) << (24 - 8*k);
+        }
+        output[j] = to_wire(item);
+    }
+}
+
+/***********************************************************************
+ * Convert items32 sc4 buffer to xx
+ **********************************************************************/
+template <typename T> UHD_INLINE std::complex<T> item32_sc4_x1_to_xx(
+    const boost::uint8_t byte, const double scale_factor
+){
+    return std::complex<T>(
+        T((boost::int8_t(byte) >> 4)*float(scale_factor)),
+        T((boost::int8_t(byte << 4) >> 4)*float(scale_factor))
+    );
+}
+
+template <> UHD_INLINE sc16_t item32_sc4_x1_to_xx(
+    const boost::uint8_t byte, const double
+){
+    return sc16_t(
+        boost::int16_t(boost::int8_t(byte) >> 4),
+        boost::int16_t(boost::int8_t(byte << 4) >> 4)
+    );
+}
+
+template <xtox_t to_host, typename T>
+UHD_INLINE void item32_sc4_to_xx(
+    const item32_t *input,
+    std::complex<T> *output,
+    const size_t nsamps,
+    const double scale_factor
+){
+    //the input may start inside of an item, one byte per sample
+    size_t k = size_t(input) & 0x3;
+    input = reinterpret_cast<const item32_t *>(size_t(input) & ~0x3);
+
+    for (size_t i = 0; i < nsamps; k = 0){
+        const item32_t item = to_host(*input++);
+        for (; k < 4 and i < nsamps; k++, i++){
+            output[i] = item32_sc4_x1_to_xx<T>(boost::uint8_t(item >> (24 - 8*k)), scale_factor);
+        }
+    }
+}
+
 #endif /* INCLUDED_LIBUHD_CONVERT_COMMON_HPP */
@@ -0,0 +1,65 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * Generic implementation for sc16 -> fc32 with a fused correction
+ *  - Scale, IQ balance, DC offset and gain in a single pass
+ **********************************************************************/
+template <xtox_t tohost>
+class convert_sc16_item32_1_to_fc32_corr_1 : public corrected_converter{
+public:
+    void operator()(const input_type &inputs, const output_type &outputs, const size_t nsamps){
+        const item32_t *input = reinterpret_cast<const item32_t *>(inputs[0]);
+        fc32_t *output = reinterpret_cast<fc32_t *>(outputs[0]);
+
+        for (size_t i = 0; i < nsamps; i++){
+            const item32_t item = tohost(input[i]);
+            const float re = float(boost::int16_t(item >> 16));
+            const float im = float(boost::int16_t(item >> 0));
+            output[i] = fc32_t(
+                _m[0]*re + _m[1]*im + _b[0],
+                _m[2]*re + _m[3]*im + _b[1]
+            );
+        }
+    }
+};
+
+static converter::sptr make_convert_sc16_item32_be_1_to_fc32_corr_1(void){
+    return converter::sptr(new convert_sc16_item32_1_to_fc32_corr_1<uhd::ntohx>());
+}
+
+static converter::sptr make_convert_sc16_item32_le_1_to_fc32_corr_1(void){
+    return converter::sptr(new convert_sc16_item32_1_to_fc32_corr_1<uhd::wtohx>());
+}
+
+UHD_STATIC_BLOCK(register_convert_sc16_item32_1_to_fc32_corr_1){
+    uhd::convert::id_type id;
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+    id.output_format = "fc32_corr";
+
+    id.input_format = "sc16_item32_be";
+    uhd::convert::register_converter(id, &make_convert_sc16_item32_be_1_to_fc32_corr_1, PRIORITY_GENERAL);
+
+    id.input_format = "sc16_item32_le";
+    uhd::convert::register_converter(id, &make_convert_sc16_item32_le_1_to_fc32_corr_1, PRIORITY_GENERAL);
+}
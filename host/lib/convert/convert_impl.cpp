@@ -16,14 +16,29 @@
 //
 
 #include <uhd/convert.hpp>
+#include <uhd/version.hpp>
 #include <uhd/utils/log.hpp>
+#include <uhd/utils/msg.hpp>
+#include <uhd/utils/csv.hpp>
+#include <uhd/utils/paths.hpp>
 #include <uhd/utils/static.hpp>
 #include <uhd/types/dict.hpp>
+#include <uhd/types/hash_dict.hpp>
+#include <uhd/types/time_spec.hpp>
 #include <uhd/exception.hpp>
+#include <boost/asio/ip/host_name.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
 #include <boost/cstdint.hpp>
 #include <boost/format.hpp>
 #include <boost/foreach.hpp>
+#include <algorithm>
 #include <complex>
+#include <fstream>
+#include <map>
+#include <vector>
 
 using namespace uhd;
 
@@ -31,6 +46,12 @@ convert::converter::~converter(void){
     /* NOP */
 }
 
+void convert::converter::set_correction(
+    const std::complex<double> &, const std::complex<double> &, const std::complex<double> &
+){
+    throw uhd::not_implemented_error("this converter does not support sample corrections");
+}
+
 bool convert::operator==(const convert::id_type &lhs, const convert::id_type &rhs){
     return true
         and (lhs.input_format  == rhs.input_format)
@@ -66,10 +87,70 @@ std::string convert::id_type::to_string(void) const{
 
 /***********************************************************************
  * Setup the table registry
+ *  - Format strings are interned to small integers when registered,
+ *    so that an ID packs into one 64-bit key of a hash table.
+ *  - Every entry caches the factory that get_converter() returns
+ *    by default, so a lookup does not scan the priorities.
  **********************************************************************/
-typedef uhd::dict<convert::id_type, uhd::dict<convert::priority_type, convert::function_type> > fcn_table_type;
+typedef boost::unordered_map<std::string, boost::uint16_t> format_index_type;
+UHD_SINGLETON_FCN(format_index_type, get_format_index);
+
+struct fcn_entry_type{
+    convert::id_type id;
+    std::map<convert::priority_type, convert::function_type> fcns;
+    convert::priority_type default_prio;
+    convert::function_type default_fcn;
+};
+typedef boost::unordered_map<boost::uint64_t, fcn_entry_type> fcn_table_type;
 UHD_SINGLETON_FCN(fcn_table_type, get_table);
 
+//! The registered IDs in registration order
+typedef std::vector<convert::id_type> fcn_ids_type;
+UHD_SINGLETON_FCN(fcn_ids_type, get_table_ids);
+
+//! Get the index of a format, only registration adds new formats
+static bool get_format_key(const std::string &format, boost::uint64_t &key, const bool insert){
+    format_index_type &index = get_format_index();
+    format_index_type::const_iterator it = index.find(format);
+    if (it != index.end()){
+        key = it->second;
+        return true;
+    }
+    if (not insert) return false;
+    if (index.size() > 0xffff) throw uhd::value_error("too many converter formats registered");
+    const boost::uint16_t next = boost::uint16_t(index.size());
+    index[format] = next;
+    key = next;
+    return true;
+}
+
+//! Pack an ID into a table key: input format, output format, num inputs, num outputs
+static bool get_table_key(const convert::id_type &id, boost::uint64_t &key, const bool insert = false){
+    boost::uint64_t in_key, out_key;
+    if (id.num_inputs > 0xffff or id.num_outputs > 0xffff){
+        if (insert) throw uhd::value_error("too many converter inputs or outputs: " + id.to_string());
+        return false;
+    }
+    if (not get_format_key(id.input_format, in_key, insert)) return false;
+    if (not get_format_key(id.output_format, out_key, insert)) return false;
+    key = (in_key << 48) | (out_key << 32) | (boost::uint64_t(id.num_inputs) << 16) | boost::uint64_t(id.num_outputs);
+    return true;
+}
+
+static fcn_entry_type *find_entry(const convert::id_type &id){
+    boost::uint64_t key;
+    if (not get_table_key(id, key)) return NULL;
+    fcn_table_type::iterator it = get_table().find(key);
+    return (it == get_table().end())? NULL : &it->second;
+}
+
+static fcn_entry_type &get_entry(const convert::id_type &id){
+    fcn_entry_type *entry = find_entry(id);
+    if (entry == NULL) throw uhd::key_error(
+        "Cannot find a conversion routine for " + id.to_pp_string());
+    return *entry;
+}
+
 /***********************************************************************
  * The registry functions
  **********************************************************************/
@@ -78,7 +159,20 @@ void uhd::convert::register_converter(
     const function_type &fcn,
     const priority_type prio
 ){
-    get_table()[id][prio] = fcn;
+    boost::uint64_t key;
+    get_table_key(id, key, true);
+    fcn_table_type::iterator it = get_table().find(key);
+    if (it == get_table().end()){
+        it = get_table().insert(std::make_pair(key, fcn_entry_type())).first;
+        it->second.id = id;
+        get_table_ids().push_back(id);
+    }
+    fcn_entry_type &entry = it->second;
+    entry.fcns[prio] = fcn;
+
+    //the default is an explicit -1 registration, otherwise the highest prio
+    entry.default_prio = entry.fcns.count(-1)? -1 : entry.fcns.rbegin()->first;
+    entry.default_fcn = entry.fcns[entry.default_prio];
 
     //----------------------------------------------------------------//
     UHD_LOGV(always) << "register_converter: " << id.to_pp_string() << std::endl
@@ -95,43 +189,227 @@ convert::function_type convert::get_converter(
     const id_type &id,
     const priority_type prio
 ){
-    if (not get_table().has_key(id)) throw uhd::key_error(
-        "Cannot find a conversion routine for " + id.to_pp_string());
+    const fcn_entry_type &entry = get_entry(id);
 
-    //find a matching priority
-    priority_type best_prio = -1;
-    BOOST_FOREACH(priority_type prio_i, get_table()[id].keys()){
-        if (prio_i == prio) {
-            //----------------------------------------------------------------//
-            UHD_LOGV(always) << "get_converter: For converter ID: " << id.to_pp_string() << std::endl
-                << "Using prio: " << prio << std::endl
-                << std::endl
-            ;
-            //----------------------------------------------------------------//
-            return get_table()[id][prio];
-        }
-        best_prio = std::max(best_prio, prio_i);
+    //return the cached best prio
+    if (prio == -1){
+        //----------------------------------------------------------------//
+        UHD_LOGV(always) << "get_converter: For converter ID: " << id.to_pp_string() << std::endl
+            << "Using prio: " << entry.default_prio << std::endl
+            << std::endl
+        ;
+        //----------------------------------------------------------------//
+        return entry.default_fcn;
     }
 
-    //wanted a specific prio, didnt find
-    if (prio != -1) throw uhd::key_error(
+    //find a matching priority
+    std::map<priority_type, function_type>::const_iterator it = entry.fcns.find(prio);
+    if (it == entry.fcns.end()) throw uhd::key_error(
         "Cannot find a conversion routine [with prio] for " + id.to_pp_string());
 
     //----------------------------------------------------------------//
     UHD_LOGV(always) << "get_converter: For converter ID: " << id.to_pp_string() << std::endl
-        << "Using prio: " << best_prio << std::endl
+        << "Using prio: " << prio << std::endl
         << std::endl
     ;
     //----------------------------------------------------------------//
+    return it->second;
+}
+
+std::vector<convert::id_type> convert::get_converter_ids(void){
+    return get_table_ids();
+}
+
+std::vector<convert::priority_type> convert::get_converter_priorities(const id_type &id){
+    const fcn_entry_type &entry = get_entry(id);
+    std::vector<priority_type> prios;
+    for (std::map<priority_type, function_type>::const_iterator it = entry.fcns.begin(); it != entry.fcns.end(); ++it){
+        prios.push_back(it->first);
+    }
+    return prios;
+}
+
+/***********************************************************************
+ * Converter auto-tuning
+ *  - Time every registered priority at the requested buffer size.
+ *  - Keep the winner in memory and in a per-host file, keyed by
+ *    UHD version, conversion ID and buffer size.
+ **********************************************************************/
+typedef uhd::hash_dict<std::string, convert::priority_type> tuned_table_type;
+UHD_SINGLETON_FCN(tuned_table_type, get_tuned_table);
+static boost::mutex tuned_table_mutex;
+static bool tuned_table_loaded = false;
+
+//bytes per item for the largest item (fc64) so any format fits
+static const size_t tune_bytes_per_item = 16;
+//number of items converted per candidate and round
+static const size_t tune_items_per_round = 1 << 18;
+static const size_t tune_num_rounds = 3;
+
+static std::string get_tune_cache_path(void){
+    std::string host = "localhost";
+    try{
+        host = boost::asio::ip::host_name();
+    }
+    catch(...){}
+    const boost::filesystem::path path = boost::filesystem::path(uhd::get_app_path())
+        / ".uhd" / ("convert_tune_" + host + ".csv");
+    return path.string();
+}
+
+static std::string get_tune_key(const convert::id_type &id, const size_t nsamps){
+    return id.to_string() + " @ " + boost::lexical_cast<std::string>(nsamps);
+}
+
+//! Load the persisted selections, rows are: version, ID, nsamps, prio
+static void load_tune_cache(void){
+    std::ifstream cache_file(get_tune_cache_path().c_str());
+    if (not cache_file.good()) return;
+    const uhd::csv::rows_type rows = uhd::csv::to_rows(cache_file);
+    BOOST_FOREACH(const uhd::csv::row_type &row, rows){
+        if (row.size() != 4 or row[0] != uhd::get_version_string()) continue;
+        try{
+            get_tuned_table()[row[1] + " @ " + row[2]] =
+                boost::lexical_cast<convert::priority_type>(row[3]);
+        }
+        catch(const boost::bad_lexical_cast &){
+            continue;
+        }
+    }
+}
+
+static void store_tune_cache(
+    const convert::id_type &id, const size_t nsamps, const convert::priority_type prio
+){
+    try{
+        const boost::filesystem::path path(get_tune_cache_path());
+        boost::filesystem::create_directories(path.parent_path());
+        std::ofstream cache_file(path.string().c_str(), std::ios::app);
+        cache_file
+            << uhd::get_version_string() << ","
+            << id.to_string() << ","
+            << nsamps << ","
+            << prio << std::endl;
+    }
+    catch(const std::exception &e){
+        UHD_MSG(warning) << "Could not store converter selection: " << e.what() << std::endl;
+    }
+}
+
+//! Fill buffers with data that exercises the converters realistically
+static void init_tune_buffer(std::vector<char> &buff, const std::string &format){
+    boost::uint32_t lfsr = 0x1234567;
+    if (format.find("fc32") == 0){
+        float *samps = reinterpret_cast<float *>(&buff[0]);
+        for (size_t i = 0; i < buff.size()/sizeof(float); i++){
+            lfsr = lfsr*1664525 + 1013904223;
+            samps[i] = float(boost::int32_t(lfsr))/2147483648.f;
+        }
+    }
+    else if (format.find("fc64") == 0){
+        double *samps = reinterpret_cast<double *>(&buff[0]);
+        for (size_t i = 0; i < buff.size()/sizeof(double); i++){
+            lfsr = lfsr*1664525 + 1013904223;
+            samps[i] = double(boost::int32_t(lfsr))/2147483648.;
+        }
+    }
+    else{
+        for (size_t i = 0; i < buff.size(); i++){
+            lfsr = lfsr*1664525 + 1013904223;
+            buff[i] = char(lfsr >> 24);
+        }
+    }
+}
+
+static convert::priority_type tune_converter(const convert::id_type &id, const size_t nsamps){
+    std::vector<std::vector<char> > in_buffs(id.num_inputs, std::vector<char>(nsamps*tune_bytes_per_item));
+    std::vector<std::vector<char> > out_buffs(id.num_outputs, std::vector<char>(nsamps*tune_bytes_per_item));
+    std::vector<const void *> in_ptrs;
+    std::vector<void *> out_ptrs;
+    BOOST_FOREACH(std::vector<char> &buff, in_buffs){
+        init_tune_buffer(buff, id.input_format);
+        in_ptrs.push_back(&buff[0]);
+    }
+    BOOST_FOREACH(std::vector<char> &buff, out_buffs){
+        out_ptrs.push_back(&buff[0]);
+    }
+    const bool from_float = id.input_format.find("fc") == 0;
+    const size_t iterations = std::max<size_t>(1, tune_items_per_round/nsamps);
+
+    //create one instance per candidate, skipping placeholder entries
+    uhd::dict<convert::priority_type, convert::converter::sptr> candidates;
+    BOOST_FOREACH(convert::priority_type prio, convert::get_converter_priorities(id)){
+        if (prio < 0) continue;
+        convert::converter::sptr conv = get_entry(id).fcns[prio]();
+        conv->set_scalar(from_float? 32767. : 1/32767.);
+        conv->conv(in_ptrs, out_ptrs, nsamps); //warm up caches and tables
+        candidates[prio] = conv;
+    }
+    //nothing to choose from, let get_converter() pick the best prio
+    if (candidates.size() < 2) return -1;
+
+    //interleave the rounds so that transient load hits all candidates alike
+    uhd::dict<convert::priority_type, double> best_times;
+    for (size_t round = 0; round < tune_num_rounds; round++){
+        BOOST_FOREACH(convert::priority_type prio, candidates.keys()){
+            convert::converter::sptr conv = candidates[prio];
+            const time_spec_t start = time_spec_t::get_system_time();
+            for (size_t i = 0; i < iterations; i++){
+                conv->conv(in_ptrs, out_ptrs, nsamps);
+            }
+            const double elapsed = (time_spec_t::get_system_time() - start).get_real_secs();
+            if (not best_times.has_key(prio) or elapsed < best_times[prio]){
+                best_times[prio] = elapsed;
+            }
+        }
+    }
+
+    convert::priority_type best_prio = -1;
+    BOOST_FOREACH(convert::priority_type prio, best_times.keys()){
+        //----------------------------------------------------------------//
+        UHD_LOGV(always) << "tune_converter: " << id.to_string() << std::endl
+            << "    prio: " << prio << ", ns/item: "
+            << best_times[prio]*1e9/(iterations*nsamps) << std::endl
+            << std::endl
+        ;
+        //----------------------------------------------------------------//
+        if (best_prio == -1 or best_times[prio] < best_times[best_prio]){
+            best_prio = prio;
+        }
+    }
+    return best_prio;
+}
+
+convert::function_type convert::get_converter_tuned(
+    const id_type &id,
+    const size_t nsamps
+){
+    const fcn_entry_type &entry = get_entry(id);
+
+    boost::mutex::scoped_lock lock(tuned_table_mutex);
+    if (not tuned_table_loaded){
+        load_tune_cache();
+        tuned_table_loaded = true;
+    }
+
+    //use the stored selection when it still names a registered converter
+    const size_t tune_nsamps = std::max<size_t>(nsamps, 1);
+    const std::string key = get_tune_key(id, tune_nsamps);
+    if (get_tuned_table().has_key(key)){
+        const priority_type prio = get_tuned_table()[key];
+        if (prio == -1 or entry.fcns.count(prio)) return get_converter(id, prio);
+    }
 
-    //otherwise, return best prio
-    return get_table()[id][best_prio];
+    const priority_type prio = tune_converter(id, tune_nsamps);
+    get_tuned_table()[key] = prio;
+    store_tune_cache(id, tune_nsamps, prio);
+    return get_converter(id, prio);
 }
 
 /***********************************************************************
  * Mappings for item format to byte size for all items we can
  **********************************************************************/
-typedef uhd::dict<std::string, size_t> item_size_type;
+typedef uhd::hash_dict<std::string, size_t> item_size_type;
 UHD_SINGLETON_FCN(item_size_type, get_item_size_table);
 
 void convert::register_bytes_per_item(
@@ -164,6 +442,7 @@ UHD_STATIC_BLOCK(convert_register_item_sizes){
     convert::register_bytes_per_item("sc16", sizeof(std::complex<boost::int16_t>));
     convert::register_bytes_per_item("sc12", 3 * sizeof(std::complex<boost::int8_t>));
     convert::register_bytes_per_item("sc8", sizeof(std::complex<boost::int8_t>));
+    convert::register_bytes_per_item("sc4", sizeof(boost::uint8_t)); //two 4-bit components
 
     //register standard real types
     convert::register_bytes_per_item("f64", sizeof(double));
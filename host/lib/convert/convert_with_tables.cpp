@@ -18,7 +18,14 @@
 #include "convert_common.hpp"
 #include <uhd/utils/byteswap.hpp>
 #include <boost/math/special_functions/round.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+#include <typeinfo>
 #include <vector>
+#include <map>
 
 using namespace uhd::convert;
 
@@ -26,6 +33,51 @@ static const size_t sc16_table_len = size_t(1 << 16);
 
 typedef boost::uint16_t (*tohost16_type)(boost::uint16_t);
 
+/***********************************************************************
+ * Shared table cache
+ *  - Converters of the same type and scale factor share one table,
+ *    so many streamers do not each keep their own copy in the cache
+ *  - Tables are refcounted and freed with the last converter using them
+ **********************************************************************/
+template <typename table_type>
+class shared_table{
+public:
+    typedef boost::shared_ptr<const table_type> sptr;
+    typedef boost::function<void(table_type &)> fill_type;
+
+    /*!
+     * Get the table for a converter type and scale factor.
+     * \param owner the converter type requesting the table
+     * \param scalar the scale factor the table is made for
+     * \param fill fills a new table of sc16_table_len entries
+     */
+    static sptr get(const std::type_info &owner, const double scalar, const fill_type &fill){
+        static boost::mutex mutex;
+        static std::map<key_type, boost::weak_ptr<const table_type> > tables;
+        boost::mutex::scoped_lock lock(mutex);
+
+        const key_type key(owner.name(), scalar);
+        sptr table = tables[key].lock();
+        if (table) return table;
+
+        //drop the entries whose tables were released
+        for (typename std::map<key_type, boost::weak_ptr<const table_type> >::iterator
+            it = tables.begin(); it != tables.end();
+        ){
+            if (it->second.expired()) tables.erase(it++);
+            else ++it;
+        }
+
+        boost::shared_ptr<table_type> new_table(new table_type(sc16_table_len));
+        fill(*new_table);
+        tables[key] = new_table;
+        return new_table;
+    }
+
+private:
+    typedef std::pair<std::string, double> key_type;
+};
+
 /***********************************************************************
  * Implementation for sc16 to sc8 lookup table
  *  - Lookup the real and imaginary parts individually
@@ -33,15 +85,22 @@ typedef boost::uint16_t (*tohost16_type)(boost::uint16_t);
 template <bool swap>
 class convert_sc16_1_to_sc8_item32_1 : public converter{
 public:
-    convert_sc16_1_to_sc8_item32_1(void): _table(sc16_table_len){}
+    convert_sc16_1_to_sc8_item32_1(void){
+        this->set_scalar(1.0);
+    }
 
-    void set_scalar(const double scalar){
+    static void fill(std::vector<boost::uint8_t> &table, const double scalar){
         for (size_t i = 0; i < sc16_table_len; i++){
             const boost::int16_t val = boost::uint16_t(i);
-            _table[i] = boost::int8_t(boost::math::iround(val * scalar / 32767.));
+            table[i] = boost::int8_t(boost::math::iround(val * scalar / 32767.));
         }
     }
 
+    void set_scalar(const double scalar){
+        _table = shared_table<std::vector<boost::uint8_t> >::get(
+            typeid(*this), scalar, boost::bind(&fill, _1, scalar));
+    }
+
     void operator()(const input_type &inputs, const output_type &outputs, const size_t nsamps){
         const sc16_t *input = reinterpret_cast<const sc16_t *>(inputs[0]);
         item32_t *output = reinterpret_cast<item32_t *>(outputs[0]);
@@ -57,22 +116,23 @@ public:
     }
 
     item32_t lookup(const sc16_t &in0, const sc16_t &in1){
+        const std::vector<boost::uint8_t> &table = *_table;
         if (swap){ //hope this compiles out, its a template constant
             return
-            (item32_t(_table[boost::uint16_t(in1.real())]) << 16) |
-            (item32_t(_table[boost::uint16_t(in1.imag())]) << 24) |
-            (item32_t(_table[boost::uint16_t(in0.real())]) << 0) |
-            (item32_t(_table[boost::uint16_t(in0.imag())]) << 8) ;
+            (item32_t(table[boost::uint16_t(in1.real())]) << 16) |
+            (item32_t(table[boost::uint16_t(in1.imag())]) << 24) |
+            (item32_t(table[boost::uint16_t(in0.real())]) << 0) |
+            (item32_t(table[boost::uint16_t(in0.imag())]) << 8) ;
         }
         return
-            (item32_t(_table[boost::uint16_t(in1.real())]) << 8) |
-            (item32_t(_table[boost::uint16_t(in1.imag())]) << 0) |
-            (item32_t(_table[boost::uint16_t(in0.real())]) << 24) |
-            (item32_t(_table[boost::uint16_t(in0.imag())]) << 16) ;
+            (item32_t(table[boost::uint16_t(in1.real())]) << 8) |
+            (item32_t(table[boost::uint16_t(in1.imag())]) << 0) |
+            (item32_t(table[boost::uint16_t(in0.real())]) << 24) |
+            (item32_t(table[boost::uint16_t(in0.imag())]) << 16) ;
     }
 
 private:
-    std::vector<boost::uint8_t> _table;
+    shared_table<std::vector<boost::uint8_t> >::sptr _table;
 };
 
 /***********************************************************************
@@ -82,30 +142,38 @@ private:
 template <typename type, tohost16_type tohost, size_t re_shift, size_t im_shift>
 class convert_sc16_item32_1_to_fcxx_1 : public converter{
 public:
-    convert_sc16_item32_1_to_fcxx_1(void): _table(sc16_table_len){}
+    convert_sc16_item32_1_to_fcxx_1(void){
+        this->set_scalar(1.0);
+    }
 
-    void set_scalar(const double scalar){
+    static void fill(std::vector<type> &table, const double scalar){
         for (size_t i = 0; i < sc16_table_len; i++){
             const boost::uint16_t val = tohost(boost::uint16_t(i & 0xffff));
-            _table[i] = type(boost::int16_t(val)*scalar);
+            table[i] = type(boost::int16_t(val)*scalar);
         }
     }
 
+    void set_scalar(const double scalar){
+        _table = shared_table<std::vector<type> >::get(
+            typeid(*this), scalar, boost::bind(&fill, _1, scalar));
+    }
+
     void operator()(const input_type &inputs, const output_type &outputs, const size_t nsamps){
         const item32_t *input = reinterpret_cast<const item32_t *>(inputs[0]);
         std::complex<type> *output = reinterpret_cast<std::complex<type> *>(outputs[0]);
+        const std::vector<type> &table = *_table;
 
         for (size_t i = 0; i < nsamps; i++){
             const item32_t item = input[i];
             output[i] = std::complex<type>(
-                _table[boost::uint16_t(item >> re_shift)],
-                _table[boost::uint16_t(item >> im_shift)]
+                table[boost::uint16_t(item >> re_shift)],
+                table[boost::uint16_t(item >> im_shift)]
             );
         }
     }
 
 private:
-    std::vector<type> _table;
+    typename shared_table<std::vector<type> >::sptr _table;
 };
 
 /***********************************************************************
@@ -115,7 +183,9 @@ private:
 template <typename type, tohost16_type tohost, size_t lo_shift, size_t hi_shift>
 class convert_sc8_item32_1_to_fcxx_1 : public converter{
 public:
-    convert_sc8_item32_1_to_fcxx_1(void): _table(sc16_table_len){}
+    convert_sc8_item32_1_to_fcxx_1(void){
+        this->set_scalar(1.0);
+    }
 
     //special case for sc16 type, 32767 undoes float normalization
     static type conv(const boost::int8_t &num, const double scalar){
@@ -125,42 +195,48 @@ public:
         return type(num*scalar);
     }
 
-    void set_scalar(const double scalar){
+    static void fill(std::vector<std::complex<type> > &table, const double scalar){
         for (size_t i = 0; i < sc16_table_len; i++){
             const boost::uint16_t val = tohost(boost::uint16_t(i & 0xffff));
             const type real = conv(boost::int8_t(val >> 8), scalar);
             const type imag = conv(boost::int8_t(val >> 0), scalar);
-            _table[i] = std::complex<type>(real, imag);
+            table[i] = std::complex<type>(real, imag);
         }
     }
 
+    void set_scalar(const double scalar){
+        _table = shared_table<std::vector<std::complex<type> > >::get(
+            typeid(*this), scalar, boost::bind(&fill, _1, scalar));
+    }
+
     void operator()(const input_type &inputs, const output_type &outputs, const size_t nsamps){
         const item32_t *input = reinterpret_cast<const item32_t *>(size_t(inputs[0]) & ~0x3);
         std::complex<type> *output = reinterpret_cast<std::complex<type> *>(outputs[0]);
+        const std::vector<std::complex<type> > &table = *_table;
 
         size_t num_samps = nsamps;
 
         if ((size_t(inputs[0]) & 0x3) != 0){
             const item32_t item0 = *input++;
-            *output++ = _table[boost::uint16_t(item0 >> hi_shift)];
+            *output++ = table[boost::uint16_t(item0 >> hi_shift)];
             num_samps--;
         }
 
         const size_t num_pairs = num_samps/2;
         for (size_t i = 0, j = 0; i < num_pairs; i++, j+=2){
             const item32_t item_i = (input[i]);
-            output[j] = _table[boost::uint16_t(item_i >> lo_shift)];
-            output[j + 1] = _table[boost::uint16_t(item_i >> hi_shift)];
+            output[j] = table[boost::uint16_t(item_i >> lo_shift)];
+            output[j + 1] = table[boost::uint16_t(item_i >> hi_shift)];
         }
 
         if (num_samps != num_pairs*2){
             const item32_t item_n = input[num_pairs];
-            output[num_samps-1] = _table[boost::uint16_t(item_n >> lo_shift)];
+            output[num_samps-1] = table[boost::uint16_t(item_n >> lo_shift)];
         }
     }
 
 private:
-    std::vector<std::complex<type> > _table;
+    typename shared_table<std::vector<std::complex<type> > >::sptr _table;
 };
 
 /***********************************************************************
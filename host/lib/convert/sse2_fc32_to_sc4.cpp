@@ -0,0 +1,88 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+#include <emmintrin.h>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * fc32 -> sc4: 16 samples (4 items) per iteration,
+ * clipped to [-8, 7] before the conversion to integers.
+ **********************************************************************/
+//4 samples to one byte each, in the low byte of 32-bit lanes
+UHD_INLINE __m128i pack_fc32_4x_to_sc4(
+    const fc32_t *input, const __m128 &scalar, const __m128 &minf, const __m128 &maxf
+){
+    __m128 tmp0 = _mm_loadu_ps(reinterpret_cast<const float *>(input+0));
+    __m128 tmp1 = _mm_loadu_ps(reinterpret_cast<const float *>(input+2));
+    tmp0 = _mm_max_ps(_mm_min_ps(_mm_mul_ps(tmp0, scalar), maxf), minf);
+    tmp1 = _mm_max_ps(_mm_min_ps(_mm_mul_ps(tmp1, scalar), maxf), minf);
+
+    //16-bit I, Q pairs: I in the low half of each 32-bit lane
+    const __m128i iq = _mm_packs_epi32(_mm_cvtps_epi32(tmp0), _mm_cvtps_epi32(tmp1));
+    const __m128i ibits = _mm_and_si128(_mm_slli_epi32(iq, 4), _mm_set1_epi32(0xf0));
+    const __m128i qbits = _mm_and_si128(_mm_srli_epi32(iq, 16), _mm_set1_epi32(0x0f));
+    return _mm_or_si128(ibits, qbits);
+}
+
+template <const bool swap, xtox_t to_wire>
+UHD_INLINE void convert_fc32_1_to_sc4_item32_1(
+    const fc32_t *input, item32_t *output, const size_t nsamps, const double scale_factor
+){
+    const __m128 scalar = _mm_set_ps1(float(scale_factor));
+    const __m128 minf = _mm_set_ps1(-8.0f);
+    const __m128 maxf = _mm_set_ps1(7.0f);
+
+    size_t i = 0;
+    for (; i+15 < nsamps; i+=16){
+        /* convert and pack 4x4 samples into bytes in sample order */
+        const __m128i lo = _mm_packs_epi32(
+            pack_fc32_4x_to_sc4(input+i+0, scalar, minf, maxf),
+            pack_fc32_4x_to_sc4(input+i+4, scalar, minf, maxf));
+        const __m128i hi = _mm_packs_epi32(
+            pack_fc32_4x_to_sc4(input+i+8, scalar, minf, maxf),
+            pack_fc32_4x_to_sc4(input+i+12, scalar, minf, maxf));
+        __m128i tmpi = _mm_packus_epi16(lo, hi);
+
+        /* le items hold the first sample in the last byte */
+        if (swap){
+            tmpi = _mm_shufflelo_epi16(tmpi, _MM_SHUFFLE(2, 3, 0, 1));
+            tmpi = _mm_shufflehi_epi16(tmpi, _MM_SHUFFLE(2, 3, 0, 1));
+            tmpi = _mm_or_si128(_mm_srli_epi16(tmpi, 8), _mm_slli_epi16(tmpi, 8));
+        }
+
+        /* store to output */
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output+i/4), tmpi);
+    }
+
+    //convert remainder
+    xx_to_item32_sc4<to_wire>(input+i, output+i/4, nsamps-i, scale_factor);
+}
+
+DECLARE_CONVERTER(fc32, 1, sc4_item32_be, 1, PRIORITY_SIMD){
+    convert_fc32_1_to_sc4_item32_1<false, uhd::htonx>(
+        reinterpret_cast<const fc32_t *>(inputs[0]),
+        reinterpret_cast<item32_t *>(outputs[0]), nsamps, scale_factor);
+}
+
+DECLARE_CONVERTER(fc32, 1, sc4_item32_le, 1, PRIORITY_SIMD){
+    convert_fc32_1_to_sc4_item32_1<true, uhd::htowx>(
+        reinterpret_cast<const fc32_t *>(inputs[0]),
+        reinterpret_cast<item32_t *>(outputs[0]), nsamps, scale_factor);
+}
@@ -123,3 +123,210 @@ DECLARE_CONVERTER(sc16_item32_be, 1, fc32, 1, PRIORITY_SIMD){
     // convert any remaining samples
     item32_sc16_to_xx<uhd::htonx>(input+i, output+i, nsamps-i, scale_factor);
 }
+
+/***********************************************************************
+ * sc16 -> fc32 with a fused correction (see corrected_converter)
+ *  - Samples are unpacked as in the plain converters,
+ *    then one multiply-add per matrix diagonal and the offset
+ **********************************************************************/
+template <bool swap>
+class convert_sc16_item32_1_to_fc32_corr_1_sse2 : public corrected_converter{
+public:
+    void operator()(const input_type &inputs, const output_type &outputs, const size_t nsamps){
+        const item32_t *input = reinterpret_cast<const item32_t *>(inputs[0]);
+        fc32_t *output = reinterpret_cast<fc32_t *>(outputs[0]);
+
+        //values are unpacked into the upper 16 bits, undo that in the matrix
+        const float unpack = 1.f/(1 << 16);
+        const __m128 mdiag = _mm_setr_ps(_m[0]*unpack, _m[3]*unpack, _m[0]*unpack, _m[3]*unpack);
+        const __m128 mcross = _mm_setr_ps(_m[1]*unpack, _m[2]*unpack, _m[1]*unpack, _m[2]*unpack);
+        const __m128 offset = _mm_setr_ps(_b[0], _b[1], _b[0], _b[1]);
+        const __m128i zeroi = _mm_setzero_si128();
+
+        // this macro converts and corrects 4 values at a time using SSE intrinsics
+        #define convert_item32_1_to_fc32_corr_1_guts(_al_)                 \
+        for (; i+3 < nsamps; i+=4){                                         \
+            /* load from input */                                           \
+            __m128i tmpi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input+i)); \
+                                                                            \
+            /* get I/Q order in 16 bit words: byteswap or swap pairs */     \
+            if (swap){                                                      \
+                tmpi = _mm_or_si128(_mm_srli_epi16(tmpi, 8), _mm_slli_epi16(tmpi, 8)); \
+            }                                                               \
+            else{                                                           \
+                tmpi = _mm_shufflelo_epi16(tmpi, _MM_SHUFFLE(2, 3, 0, 1));  \
+                tmpi = _mm_shufflehi_epi16(tmpi, _MM_SHUFFLE(2, 3, 0, 1));  \
+            }                                                               \
+            __m128i tmpilo = _mm_unpacklo_epi16(zeroi, tmpi); /* value in upper 16 bits */ \
+            __m128i tmpihi = _mm_unpackhi_epi16(zeroi, tmpi);               \
+                                                                            \
+            /* convert, then I*m + Q*m' + b per output component */         \
+            __m128 tmplo = _mm_cvtepi32_ps(tmpilo);                         \
+            __m128 tmphi = _mm_cvtepi32_ps(tmpihi);                         \
+            __m128 crosslo = _mm_shuffle_ps(tmplo, tmplo, _MM_SHUFFLE(2, 3, 0, 1)); \
+            __m128 crosshi = _mm_shuffle_ps(tmphi, tmphi, _MM_SHUFFLE(2, 3, 0, 1)); \
+            tmplo = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tmplo, mdiag), _mm_mul_ps(crosslo, mcross)), offset); \
+            tmphi = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tmphi, mdiag), _mm_mul_ps(crosshi, mcross)), offset); \
+                                                                            \
+            /* store to output */                                           \
+            _mm_store ## _al_ ## ps(reinterpret_cast<float *>(output+i+0), tmplo); \
+            _mm_store ## _al_ ## ps(reinterpret_cast<float *>(output+i+2), tmphi); \
+        }                                                                   \
+
+        size_t i = 0;
+
+        // need to dispatch according to alignment for fastest conversion
+        switch (size_t(output) & 0xf){
+        case 0x0:
+            // the data is 16-byte aligned, so do the fast processing of the bulk of the samples
+            convert_item32_1_to_fc32_corr_1_guts(_)
+            break;
+        case 0x8:
+            // the first sample is 8-byte aligned - process it to align the remainder of the samples to 16-bytes
+            this->convert_tail(input, output, 1);
+            i++;
+            // do faster processing of the bulk of the samples now that we are 16-byte aligned
+            convert_item32_1_to_fc32_corr_1_guts(_)
+            break;
+        default:
+            // we are not 8 or 16-byte aligned, so do fast processing with the unaligned load and store
+            convert_item32_1_to_fc32_corr_1_guts(u_)
+        }
+
+        // convert any remaining samples
+        this->convert_tail(input+i, output+i, nsamps-i);
+    }
+
+private:
+    void convert_tail(const item32_t *input, fc32_t *output, const size_t nsamps){
+        for (size_t i = 0; i < nsamps; i++){
+            const item32_t item = swap? uhd::ntohx(input[i]) : uhd::wtohx(input[i]);
+            const float re = float(boost::int16_t(item >> 16));
+            const float im = float(boost::int16_t(item >> 0));
+            output[i] = fc32_t(
+                _m[0]*re + _m[1]*im + _b[0],
+                _m[2]*re + _m[3]*im + _b[1]
+            );
+        }
+    }
+};
+
+static converter::sptr make_convert_sc16_item32_be_1_to_fc32_corr_1_sse2(void){
+    return converter::sptr(new convert_sc16_item32_1_to_fc32_corr_1_sse2<true>());
+}
+
+static converter::sptr make_convert_sc16_item32_le_1_to_fc32_corr_1_sse2(void){
+    return converter::sptr(new convert_sc16_item32_1_to_fc32_corr_1_sse2<false>());
+}
+
+UHD_STATIC_BLOCK(register_convert_sc16_item32_1_to_fc32_corr_1_sse2){
+    uhd::convert::id_type id;
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+    id.output_format = "fc32_corr";
+
+    id.input_format = "sc16_item32_be";
+    uhd::convert::register_converter(id, &make_convert_sc16_item32_be_1_to_fc32_corr_1_sse2, PRIORITY_SIMD);
+
+    id.input_format = "sc16_item32_le";
+    uhd::convert::register_converter(id, &make_convert_sc16_item32_le_1_to_fc32_corr_1_sse2, PRIORITY_SIMD);
+}
+
+/***********************************************************************
+ * sc16 -> fc32 with non-temporal stores (fc32_nt)
+ *  - For large receive buffers that are not read back by this core:
+ *    the output bypasses the cache and the input is prefetched ahead
+ *  - Streaming stores need 16-byte alignment, otherwise fall back
+ *    to regular unaligned stores
+ **********************************************************************/
+#define convert_item32_1_to_fc32_1_nt_guts(_swap_, _store_)            \
+    for (; i+3 < nsamps; i+=4){                                         \
+        /* load from input, prefetch a few lines ahead */               \
+        _mm_prefetch(reinterpret_cast<const char *>(input+i+64), _MM_HINT_NTA); \
+        __m128i tmpi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input+i)); \
+                                                                        \
+        /* get I/Q order in 16 bit words: byteswap or swap pairs */     \
+        if (_swap_){                                                    \
+            tmpi = _mm_or_si128(_mm_srli_epi16(tmpi, 8), _mm_slli_epi16(tmpi, 8)); \
+        }                                                               \
+        else{                                                           \
+            tmpi = _mm_shufflelo_epi16(tmpi, _MM_SHUFFLE(2, 3, 0, 1));  \
+            tmpi = _mm_shufflehi_epi16(tmpi, _MM_SHUFFLE(2, 3, 0, 1));  \
+        }                                                               \
+        __m128i tmpilo = _mm_unpacklo_epi16(zeroi, tmpi); /* value in upper 16 bits */ \
+        __m128i tmpihi = _mm_unpackhi_epi16(zeroi, tmpi);               \
+                                                                        \
+        /* convert and scale */                                         \
+        __m128 tmplo = _mm_mul_ps(_mm_cvtepi32_ps(tmpilo), scalar);     \
+        __m128 tmphi = _mm_mul_ps(_mm_cvtepi32_ps(tmpihi), scalar);     \
+                                                                        \
+        /* store to output */                                           \
+        _store_(reinterpret_cast<float *>(output+i+0), tmplo);          \
+        _store_(reinterpret_cast<float *>(output+i+2), tmphi);          \
+    }                                                                   \
+
+DECLARE_CONVERTER(sc16_item32_le, 1, fc32_nt, 1, PRIORITY_SIMD){
+    const item32_t *input = reinterpret_cast<const item32_t *>(inputs[0]);
+    fc32_t *output = reinterpret_cast<fc32_t *>(outputs[0]);
+
+    const __m128 scalar = _mm_set_ps1(float(scale_factor)/(1 << 16));
+    const __m128i zeroi = _mm_setzero_si128();
+
+    size_t i = 0;
+
+    // need to dispatch according to alignment for streaming stores
+    switch (size_t(output) & 0xf){
+    case 0x0:
+        // the data is 16-byte aligned, so stream the bulk of the samples
+        convert_item32_1_to_fc32_1_nt_guts(false, _mm_stream_ps)
+        break;
+    case 0x8:
+        // the first sample is 8-byte aligned - process it to align the remainder of the samples to 16-bytes
+        item32_sc16_to_xx<uhd::htowx>(input, output, 1, scale_factor);
+        i++;
+        // stream the bulk of the samples now that we are 16-byte aligned
+        convert_item32_1_to_fc32_1_nt_guts(false, _mm_stream_ps)
+        break;
+    default:
+        convert_item32_1_to_fc32_1_nt_guts(false, _mm_storeu_ps)
+    }
+
+    // convert any remaining samples
+    item32_sc16_to_xx<uhd::htowx>(input+i, output+i, nsamps-i, scale_factor);
+
+    // make the streaming stores visible before the buffer is handed out
+    _mm_sfence();
+}
+
+DECLARE_CONVERTER(sc16_item32_be, 1, fc32_nt, 1, PRIORITY_SIMD){
+    const item32_t *input = reinterpret_cast<const item32_t *>(inputs[0]);
+    fc32_t *output = reinterpret_cast<fc32_t *>(outputs[0]);
+
+    const __m128 scalar = _mm_set_ps1(float(scale_factor)/(1 << 16));
+    const __m128i zeroi = _mm_setzero_si128();
+
+    size_t i = 0;
+
+    // need to dispatch according to alignment for streaming stores
+    switch (size_t(output) & 0xf){
+    case 0x0:
+        // the data is 16-byte aligned, so stream the bulk of the samples
+        convert_item32_1_to_fc32_1_nt_guts(true, _mm_stream_ps)
+        break;
+    case 0x8:
+        // the first sample is 8-byte aligned - process it to align the remainder of the samples to 16-bytes
+        item32_sc16_to_xx<uhd::htonx>(input, output, 1, scale_factor);
+        i++;
+        // stream the bulk of the samples now that we are 16-byte aligned
+        convert_item32_1_to_fc32_1_nt_guts(true, _mm_stream_ps)
+        break;
+    default:
+        convert_item32_1_to_fc32_1_nt_guts(true, _mm_storeu_ps)
+    }
+
+    // convert any remaining samples
+    item32_sc16_to_xx<uhd::htonx>(input+i, output+i, nsamps-i, scale_factor);
+
+    // make the streaming stores visible before the buffer is handed out
+    _mm_sfence();
+}
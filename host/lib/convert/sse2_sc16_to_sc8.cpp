@@ -0,0 +1,141 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+#include <uhd/utils/algorithm.hpp>
+#include <boost/math/special_functions/round.hpp>
+#include <emmintrin.h>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * sc16 -> sc8 with arithmetic instead of the 64 KiB lookup table:
+ * same scaling as the table converter (scale_factor/32767),
+ * but saturating instead of wrapping on overflow.
+ **********************************************************************/
+UHD_INLINE __m128 sc16_to_ps(const __m128i &in){
+    //sign extend 16 -> 32 bits
+    return _mm_cvtepi32_ps(_mm_srai_epi32(in, 16));
+}
+
+template <const int shuf>
+UHD_INLINE __m128i pack_sc16_8x(
+    const __m128i &in0, const __m128i &in1, const __m128 &scalar
+){
+    __m128i tmpi0 = _mm_cvtps_epi32(_mm_mul_ps(sc16_to_ps(_mm_unpacklo_epi16(in0, in0)), scalar));
+    tmpi0 = _mm_shuffle_epi32(tmpi0, shuf);
+    __m128i tmpi1 = _mm_cvtps_epi32(_mm_mul_ps(sc16_to_ps(_mm_unpackhi_epi16(in0, in0)), scalar));
+    tmpi1 = _mm_shuffle_epi32(tmpi1, shuf);
+    const __m128i lo = _mm_packs_epi32(tmpi0, tmpi1);
+
+    __m128i tmpi2 = _mm_cvtps_epi32(_mm_mul_ps(sc16_to_ps(_mm_unpacklo_epi16(in1, in1)), scalar));
+    tmpi2 = _mm_shuffle_epi32(tmpi2, shuf);
+    __m128i tmpi3 = _mm_cvtps_epi32(_mm_mul_ps(sc16_to_ps(_mm_unpackhi_epi16(in1, in1)), scalar));
+    tmpi3 = _mm_shuffle_epi32(tmpi3, shuf);
+    const __m128i hi = _mm_packs_epi32(tmpi2, tmpi3);
+
+    return _mm_packs_epi16(lo, hi);
+}
+
+//! Scale, round and saturate like the packs of the SIMD body
+UHD_INLINE item32_t sc16_to_sc8_sat(const short in, const double scalar){
+    return boost::uint8_t(uhd::clip(boost::math::iround(in*scalar), -128, 127));
+}
+
+template <xtox_t to_wire>
+UHD_INLINE void sc16_to_item32_sc8_tail(
+    const sc16_t *input, item32_t *output, const size_t nsamps, const double scalar
+){
+    for (size_t i = 0; i < nsamps; i += 2){
+        const sc16_t in0 = input[i];
+        const sc16_t in1 = (i + 1 < nsamps)? input[i + 1] : sc16_t(0, 0);
+        const item32_t real0 = sc16_to_sc8_sat(in0.real(), scalar);
+        const item32_t imag0 = sc16_to_sc8_sat(in0.imag(), scalar);
+        const item32_t real1 = sc16_to_sc8_sat(in1.real(), scalar);
+        const item32_t imag1 = sc16_to_sc8_sat(in1.imag(), scalar);
+        output[i/2] = to_wire((real0 << 24) | (imag0 << 16) | (real1 << 8) | (imag1 << 0));
+    }
+}
+
+DECLARE_CONVERTER(sc16, 1, sc8_item32_be, 1, PRIORITY_SIMD){
+    const sc16_t *input = reinterpret_cast<const sc16_t *>(inputs[0]);
+    item32_t *output = reinterpret_cast<item32_t *>(outputs[0]);
+
+    const __m128 scalar = _mm_set_ps1(float(scale_factor/32767.));
+    const int shuf = _MM_SHUFFLE(3, 2, 1, 0);
+
+    #define convert_sc16_1_to_sc8_item32_1_bswap_guts(_al_)             \
+    for (size_t j = 0; i+7 < nsamps; i+=8, j+=4){                       \
+        /* load from input */                                           \
+        __m128i tmp0 = _mm_load ## _al_ ## si128(reinterpret_cast<const __m128i *>(input+i+0)); \
+        __m128i tmp1 = _mm_load ## _al_ ## si128(reinterpret_cast<const __m128i *>(input+i+4)); \
+                                                                        \
+        /* convert */                                                   \
+        const __m128i tmpi = pack_sc16_8x<shuf>(tmp0, tmp1, scalar);    \
+                                                                        \
+        /* store to output */                                           \
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output+j), tmpi);  \
+    }                                                                   \
+
+    size_t i = 0;
+
+    //dispatch according to alignment
+    if ((size_t(input) & 0xf) == 0){
+        convert_sc16_1_to_sc8_item32_1_bswap_guts(_)
+    }
+    else{
+        convert_sc16_1_to_sc8_item32_1_bswap_guts(u_)
+    }
+
+    //convert remainder
+    sc16_to_item32_sc8_tail<uhd::htonx>(input+i, output+(i/2), nsamps-i, scale_factor/32767.);
+}
+
+DECLARE_CONVERTER(sc16, 1, sc8_item32_le, 1, PRIORITY_SIMD){
+    const sc16_t *input = reinterpret_cast<const sc16_t *>(inputs[0]);
+    item32_t *output = reinterpret_cast<item32_t *>(outputs[0]);
+
+    const __m128 scalar = _mm_set_ps1(float(scale_factor/32767.));
+    const int shuf = _MM_SHUFFLE(0, 1, 2, 3);
+
+    #define convert_sc16_1_to_sc8_item32_1_nswap_guts(_al_)             \
+    for (size_t j = 0; i+7 < nsamps; i+=8, j+=4){                       \
+        /* load from input */                                           \
+        __m128i tmp0 = _mm_load ## _al_ ## si128(reinterpret_cast<const __m128i *>(input+i+0)); \
+        __m128i tmp1 = _mm_load ## _al_ ## si128(reinterpret_cast<const __m128i *>(input+i+4)); \
+                                                                        \
+        /* convert */                                                   \
+        const __m128i tmpi = pack_sc16_8x<shuf>(tmp0, tmp1, scalar);    \
+                                                                        \
+        /* store to output */                                           \
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output+j), tmpi);  \
+    }                                                                   \
+
+    size_t i = 0;
+
+    //dispatch according to alignment
+    if ((size_t(input) & 0xf) == 0){
+        convert_sc16_1_to_sc8_item32_1_nswap_guts(_)
+    }
+    else{
+        convert_sc16_1_to_sc8_item32_1_nswap_guts(u_)
+    }
+
+    //convert remainder
+    sc16_to_item32_sc8_tail<uhd::htowx>(input+i, output+(i/2), nsamps-i, scale_factor/32767.);
+}
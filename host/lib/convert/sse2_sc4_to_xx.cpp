@@ -0,0 +1,118 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "convert_common.hpp"
+#include <uhd/utils/byteswap.hpp>
+#include <emmintrin.h>
+
+using namespace uhd::convert;
+
+/***********************************************************************
+ * sc4 -> fc32 and sc16:
+ * 16 samples (4 items) per iteration, after the bytes are put in
+ * sample order, each byte is split into I and Q bytes with the value
+ * in the upper nibble and then widened with the value in the upper bits.
+ **********************************************************************/
+static const __m128i zeroi = _mm_setzero_si128();
+
+//put the sample bytes in order: le items hold the first sample in the last byte
+template <const bool swap>
+UHD_INLINE __m128i sc4_bytes_in_order(__m128i in){
+    if (not swap) return in;
+    in = _mm_shufflelo_epi16(in, _MM_SHUFFLE(2, 3, 0, 1));
+    in = _mm_shufflehi_epi16(in, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_or_si128(_mm_srli_epi16(in, 8), _mm_slli_epi16(in, 8));
+}
+
+//I0, Q0, I1, Q1... of 16 samples, each value times 16
+UHD_INLINE void unpack_sc4_16x(const __m128i &in, __m128i &lo, __m128i &hi){
+    const __m128i mask = _mm_set1_epi8(char(0xf0));
+    const __m128i ibytes = _mm_and_si128(in, mask);
+    const __m128i qbytes = _mm_and_si128(_mm_slli_epi16(in, 4), mask);
+    lo = _mm_unpacklo_epi8(ibytes, qbytes);
+    hi = _mm_unpackhi_epi8(ibytes, qbytes);
+}
+
+//store 8 samples from unpack_sc4_16x
+UHD_INLINE void store_sc4_8x(const __m128i &in, fc32_t *output, const __m128 &scalar){
+    const __m128i tmplo = _mm_unpacklo_epi8(zeroi, in); /* value in upper 4 bits of 16 */
+    const __m128i tmphi = _mm_unpackhi_epi8(zeroi, in);
+    _mm_storeu_ps(reinterpret_cast<float *>(output+0), _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(zeroi, tmplo)), scalar));
+    _mm_storeu_ps(reinterpret_cast<float *>(output+2), _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(zeroi, tmplo)), scalar));
+    _mm_storeu_ps(reinterpret_cast<float *>(output+4), _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(zeroi, tmphi)), scalar));
+    _mm_storeu_ps(reinterpret_cast<float *>(output+6), _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(zeroi, tmphi)), scalar));
+}
+
+//sc16 is not scaled, like the generic sc8 to sc16 conversion
+UHD_INLINE void store_sc4_8x(const __m128i &in, sc16_t *output, const __m128 &){
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output+0), _mm_srai_epi16(_mm_unpacklo_epi8(zeroi, in), 12));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output+4), _mm_srai_epi16(_mm_unpackhi_epi8(zeroi, in), 12));
+}
+
+template <const bool swap, xtox_t to_host, typename T>
+UHD_INLINE void convert_sc4_item32_1_to_xx_1(
+    const void *input_ptr, std::complex<T> *output, const size_t nsamps, const double scale_factor
+){
+    const item32_t *input = reinterpret_cast<const item32_t *>(input_ptr);
+    const __m128 scalar = _mm_set_ps1(float(scale_factor)/(1 << 28));
+
+    //finish an item that was partially consumed by the previous call
+    size_t i = 0;
+    if ((size_t(input) & 0x3) != 0){
+        i = std::min<size_t>(nsamps, 4 - (size_t(input) & 0x3));
+        item32_sc4_to_xx<to_host>(input, output, i, scale_factor);
+        input = reinterpret_cast<const item32_t *>((size_t(input) & ~0x3) + 4);
+        output += i;
+    }
+    const size_t num_samps = nsamps - i;
+
+    size_t j = 0;
+    for (; j+15 < num_samps; j+=16){
+        /* load from input */
+        const __m128i tmpi = sc4_bytes_in_order<swap>(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(input+j/4)));
+
+        /* unpack, convert and store to output */
+        __m128i lo, hi;
+        unpack_sc4_16x(tmpi, lo, hi);
+        store_sc4_8x(lo, output+j+0, scalar);
+        store_sc4_8x(hi, output+j+8, scalar);
+    }
+
+    //convert remainder
+    item32_sc4_to_xx<to_host>(input+j/4, output+j, num_samps-j, scale_factor);
+}
+
+DECLARE_CONVERTER(sc4_item32_be, 1, fc32, 1, PRIORITY_SIMD){
+    convert_sc4_item32_1_to_xx_1<false, uhd::ntohx>(
+        inputs[0], reinterpret_cast<fc32_t *>(outputs[0]), nsamps, scale_factor);
+}
+
+DECLARE_CONVERTER(sc4_item32_le, 1, fc32, 1, PRIORITY_SIMD){
+    convert_sc4_item32_1_to_xx_1<true, uhd::wtohx>(
+        inputs[0], reinterpret_cast<fc32_t *>(outputs[0]), nsamps, scale_factor);
+}
+
+DECLARE_CONVERTER(sc4_item32_be, 1, sc16, 1, PRIORITY_SIMD){
+    convert_sc4_item32_1_to_xx_1<false, uhd::ntohx>(
+        inputs[0], reinterpret_cast<sc16_t *>(outputs[0]), nsamps, scale_factor);
+}
+
+DECLARE_CONVERTER(sc4_item32_le, 1, sc16, 1, PRIORITY_SIMD){
+    convert_sc4_item32_1_to_xx_1<true, uhd::wtohx>(
+        inputs[0], reinterpret_cast<sc16_t *>(outputs[0]), nsamps, scale_factor);
+}
@@ -16,18 +16,27 @@
 //
 
 #include <uhd/device.hpp>
+#include <uhd/version.hpp>
 #include <uhd/types/dict.hpp>
 #include <uhd/exception.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/msg.hpp>
+#include <uhd/utils/csv.hpp>
+#include <uhd/utils/paths.hpp>
 #include <uhd/utils/static.hpp>
 #include <uhd/utils/algorithm.hpp>
 #include <boost/foreach.hpp>
 #include <boost/format.hpp>
+#include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
 #include <boost/functional/hash.hpp>
 #include <boost/tuple/tuple.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <fstream>
 
 using namespace uhd;
 
@@ -84,31 +93,175 @@ device::~device(void){
 
 /***********************************************************************
  * Discover
+ *  - Every registered find function runs in its own thread.
+ *  - Results are merged in registration order.
+ *  - With a find_timeout in the hint, find functions still running at
+ *    the deadline are interrupted and detached, and their results are
+ *    dropped. They share ownership of the find state, so they may finish
+ *    after discover has returned.
+ *  - Without a find_timeout, all find threads are joined.
  **********************************************************************/
-device_addrs_t device::find(const device_addr_t &hint, device_filter_t filter){
-    boost::mutex::scoped_lock lock(_device_mutex);
+typedef boost::tuple<device_addrs_t, device::make_t> dev_addrs_make_t;
 
-    device_addrs_t device_addrs;
+struct find_state_t{
+    typedef boost::shared_ptr<find_state_t> sptr;
+    boost::mutex mutex;
+    boost::condition_variable cond;
+    std::vector<device_addrs_t> results;
+    std::vector<bool> done;
+    bool expired;
+    size_t num_pending;
+};
+
+static void run_find(
+    find_state_t::sptr state,
+    const device::find_t find,
+    const device_addr_t hint,
+    const size_t index
+){
+    device_addrs_t discovered_addrs;
+    try{
+        discovered_addrs = find(hint);
+    }
+    catch(const boost::thread_interrupted &){
+        //interrupted at the deadline, the result is dropped anyway
+    }
+    catch(const std::exception &e){
+        UHD_MSG(error) << "Device discovery error: " << e.what() << std::endl;
+    }
+
+    boost::mutex::scoped_lock lock(state->mutex);
+    if (state->expired) return;
+    state->results[index] = discovered_addrs;
+    state->done[index] = true;
+    state->num_pending--;
+    state->cond.notify_one();
+}
+
+static std::vector<dev_addrs_make_t> discover(
+    const device_addr_t &hint, device::device_filter_t filter
+){
+    std::vector<dev_fcn_reg_t> fcns;
+    BOOST_FOREACH(const dev_fcn_reg_t &fcn, get_dev_fcn_regs()){
+        if (filter == device::ANY or fcn.get<2>() == filter) fcns.push_back(fcn);
+    }
 
-    BOOST_FOREACH(const dev_fcn_reg_t &fcn, get_dev_fcn_regs()) {
-        try {
-            if (filter == ANY or fcn.get<2>() == filter) {
-                device_addrs_t discovered_addrs = fcn.get<0>()(hint);
-                device_addrs.insert(
-                    device_addrs.begin(),
-                    discovered_addrs.begin(),
-                    discovered_addrs.end()
-                );
+    find_state_t::sptr state(new find_state_t());
+    state->results.resize(fcns.size());
+    state->done.resize(fcns.size(), false);
+    state->expired = false;
+    state->num_pending = fcns.size();
+
+    //a single find function does not need a thread
+    if (fcns.size() == 1){
+        run_find(state, fcns[0].get<0>(), hint, 0);
+    }
+    else{
+        std::vector<boost::shared_ptr<boost::thread> > find_threads;
+        for (size_t i = 0; i < fcns.size(); i++){
+            find_threads.push_back(boost::shared_ptr<boost::thread>(new boost::thread(
+                boost::bind(&run_find, state, fcns[i].get<0>(), hint, i))));
+        }
+
+        if (hint.has_key("find_timeout")){
+            const double timeout = hint.cast<double>("find_timeout", 0.0);
+            const boost::system_time deadline = boost::get_system_time()
+                + boost::posix_time::microseconds(long(timeout*1e6));
+
+            boost::mutex::scoped_lock lock(state->mutex);
+            while (state->num_pending != 0){
+                if (not state->cond.timed_wait(lock, deadline)) break;
+            }
+            if (state->num_pending != 0){
+                state->expired = true;
+                UHD_MSG(warning) << boost::format(
+                    "Device discovery: %u of %u device types did not answer within %g seconds"
+                ) % state->num_pending % fcns.size() % timeout << std::endl;
             }
         }
-        catch (const std::exception &e) {
-            UHD_MSG(error) << "Device discovery error: " << e.what() << std::endl;
+
+        //finished threads are joined, late ones are left to finish on their own
+        for (size_t i = 0; i < find_threads.size(); i++){
+            if (state->expired and not state->done[i]){
+                find_threads[i]->interrupt();
+                find_threads[i]->detach();
+            }
+            else find_threads[i]->join();
         }
     }
 
+    std::vector<dev_addrs_make_t> dev_addrs_makers;
+    for (size_t i = 0; i < fcns.size(); i++){
+        if (state->done[i]) dev_addrs_makers.push_back(
+            dev_addrs_make_t(state->results[i], fcns[i].get<1>()));
+    }
+    return dev_addrs_makers;
+}
+
+device_addrs_t device::find(const device_addr_t &hint, device_filter_t filter){
+    boost::mutex::scoped_lock lock(_device_mutex);
+
+    device_addrs_t device_addrs;
+
+    const std::vector<dev_addrs_make_t> found = discover(hint, filter);
+    BOOST_FOREACH(const dev_addrs_make_t &found_i, found){
+        const device_addrs_t &discovered_addrs = found_i.get<0>();
+        device_addrs.insert(
+            device_addrs.begin(),
+            discovered_addrs.begin(),
+            discovered_addrs.end()
+        );
+    }
+
     return device_addrs;
 }
 
+/***********************************************************************
+ * Discovery Cache
+ *  - Opt-in with the discovery_cache key in the hint of make().
+ *  - Rows are: version, serial, then key=value for every address key.
+ *  - New addresses are appended, so the last row of a serial wins.
+ **********************************************************************/
+static std::string get_discovery_cache_path(void){
+    const boost::filesystem::path path = boost::filesystem::path(uhd::get_app_path())
+        / ".uhd" / "discovery_cache.csv";
+    return path.string();
+}
+
+static bool load_cached_addr(const std::string &serial, device_addr_t &cached_addr){
+    std::ifstream cache_file(get_discovery_cache_path().c_str());
+    if (not cache_file.good()) return false;
+    const uhd::csv::rows_type rows = uhd::csv::to_rows(cache_file);
+    bool found = false;
+    BOOST_FOREACH(const uhd::csv::row_type &row, rows){
+        if (row.size() < 3 or row[0] != uhd::get_version_string() or row[1] != serial) continue;
+        device_addr_t dev_addr;
+        for (size_t i = 2; i < row.size(); i++){
+            const size_t eq = row[i].find('=');
+            if (eq != std::string::npos) dev_addr[row[i].substr(0, eq)] = row[i].substr(eq + 1);
+        }
+        cached_addr = dev_addr;
+        found = true;
+    }
+    return found;
+}
+
+static void store_cached_addr(const device_addr_t &dev_addr){
+    try{
+        const boost::filesystem::path path(get_discovery_cache_path());
+        boost::filesystem::create_directories(path.parent_path());
+        std::ofstream cache_file(path.string().c_str(), std::ios::app);
+        cache_file << uhd::get_version_string() << "," << dev_addr["serial"];
+        BOOST_FOREACH(const std::string &key, dev_addr.keys()){
+            cache_file << "," << key << "=" << dev_addr[key];
+        }
+        cache_file << std::endl;
+    }
+    catch(const std::exception &e){
+        UHD_MSG(warning) << "Could not store discovered device: " << e.what() << std::endl;
+    }
+}
+
 /***********************************************************************
  * Make
  **********************************************************************/
@@ -118,17 +271,28 @@ device::sptr device::make(const device_addr_t &hint, device_filter_t filter, siz
     typedef boost::tuple<device_addr_t, make_t> dev_addr_make_t;
     std::vector<dev_addr_make_t> dev_addr_makers;
 
-    BOOST_FOREACH(const dev_fcn_reg_t &fcn, get_dev_fcn_regs()){
-        try{
-            if(filter == ANY or fcn.get<2>() == filter){
-                BOOST_FOREACH(device_addr_t dev_addr, fcn.get<0>()(hint)){
-                    //append the discovered address and its factory function
-                    dev_addr_makers.push_back(dev_addr_make_t(dev_addr, fcn.get<1>()));
-                }
-            }
+    //a known serial is looked for at its cached address first,
+    //the other device types skip it because of the cached type
+    const bool use_cache = hint.has_key("discovery_cache") and hint.has_key("serial");
+    device_addr_t cached_addr;
+    std::vector<dev_addrs_make_t> found;
+    if (use_cache and load_cached_addr(hint["serial"], cached_addr)){
+        device_addr_t cached_hint = hint;
+        BOOST_FOREACH(const std::string &key, cached_addr.keys()){
+            if (not cached_hint.has_key(key)) cached_hint[key] = cached_addr[key];
         }
-        catch(const std::exception &e){
-            UHD_MSG(error) << "Device discovery error: " << e.what() << std::endl;
+        found = discover(cached_hint, filter);
+    }
+    size_t num_found = 0;
+    BOOST_FOREACH(const dev_addrs_make_t &found_i, found){
+        num_found += found_i.get<0>().size();
+    }
+    if (num_found == 0) found = discover(hint, filter);
+
+    BOOST_FOREACH(const dev_addrs_make_t &found_i, found){
+        BOOST_FOREACH(const device_addr_t &dev_addr, found_i.get<0>()){
+            //append the discovered address and its factory function
+            dev_addr_makers.push_back(dev_addr_make_t(dev_addr, found_i.get<1>()));
         }
     }
 
@@ -146,9 +310,15 @@ device::sptr device::make(const device_addr_t &hint, device_filter_t filter, siz
         ));
     }
 
-    //create a unique hash for the device address
     device_addr_t dev_addr; make_t maker;
     boost::tie(dev_addr, maker) = dev_addr_makers.at(which);
+
+    //remember where the device was found
+    if (use_cache and dev_addr.has_key("serial") and dev_addr.to_string() != cached_addr.to_string()){
+        store_cached_addr(dev_addr);
+    }
+
+    //create a unique hash for the device address
     size_t dev_hash = hash_device_addr(dev_addr);
     UHD_LOG << boost::format("Device hash: %u") % dev_hash << std::endl;
 
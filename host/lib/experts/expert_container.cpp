@@ -18,6 +18,7 @@
 #include "expert_container.hpp"
 #include <uhd/exception.hpp>
 #include <uhd/utils/msg.hpp>
+#include <uhd/types/time_spec.hpp>
 #include <boost/format.hpp>
 #include <boost/foreach.hpp>
 #include <boost/function.hpp>
@@ -26,10 +27,13 @@
 #include <boost/scoped_ptr.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/graph/graph_traits.hpp>
 #include <boost/graph/depth_first_search.hpp>
 #include <boost/graph/topological_sort.hpp>
 #include <boost/graph/adjacency_list.hpp>
+#include <algorithm>
+#include <deque>
 
 #ifdef UHD_EXPERT_LOGGING
 #define EX_LOG(depth, str) _log(depth, str)
@@ -54,6 +58,95 @@ typedef std::list<expert_graph_t::vertex_descriptor>             node_queue_t;
 
 typedef boost::graph_traits<expert_graph_t>::edge_iterator       edge_iter;
 typedef boost::graph_traits<expert_graph_t>::vertex_iterator     vertex_iter;
+typedef boost::graph_traits<expert_graph_t>::out_edge_iterator   out_edge_iter;
+
+/***********************************************************************
+ * A small pool of threads to resolve independent workers.
+ * The thread calling run_all() also takes jobs off the queue
+ * and returns once every job has finished. Jobs must not throw.
+ **********************************************************************/
+class expert_thread_pool : private boost::noncopyable
+{
+public:
+    typedef boost::function<void(void)> job_t;
+
+    expert_thread_pool(size_t num_threads):
+        _stop(false), _pending(0)
+    {
+        for (size_t i = 0; i < num_threads; i++) {
+            _threads.create_thread(boost::bind(&expert_thread_pool::_thread_loop, this));
+        }
+    }
+
+    ~expert_thread_pool()
+    {
+        {
+            boost::lock_guard<boost::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _work_cond.notify_all();
+        _threads.join_all();
+    }
+
+    void run_all(const std::vector<job_t>& jobs)
+    {
+        {
+            boost::lock_guard<boost::mutex> lock(_mutex);
+            _queue.insert(_queue.end(), jobs.begin(), jobs.end());
+            _pending += jobs.size();
+        }
+        _work_cond.notify_all();
+
+        job_t job;
+        while (_pop(job)) {
+            job();
+            _finish();
+        }
+
+        boost::unique_lock<boost::mutex> lock(_mutex);
+        while (_pending != 0) _done_cond.wait(lock);
+    }
+
+private:
+    bool _pop(job_t& job)
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        if (_queue.empty()) return false;
+        job = _queue.front();
+        _queue.pop_front();
+        return true;
+    }
+
+    void _finish()
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        if (--_pending == 0) _done_cond.notify_all();
+    }
+
+    void _thread_loop()
+    {
+        while (true) {
+            job_t job;
+            {
+                boost::unique_lock<boost::mutex> lock(_mutex);
+                while (not _stop and _queue.empty()) _work_cond.wait(lock);
+                if (_stop) return;
+                job = _queue.front();
+                _queue.pop_front();
+            }
+            job();
+            _finish();
+        }
+    }
+
+    bool                        _stop;
+    size_t                      _pending;
+    std::deque<job_t>           _queue;
+    boost::mutex                _mutex;
+    boost::condition_variable   _work_cond;
+    boost::condition_variable   _done_cond;
+    boost::thread_group         _threads;
+};
 
 class expert_container_impl : public expert_container
 {
@@ -73,7 +166,7 @@ private:    //Visitor class for cycle detection algorithm
 
 public:
     expert_container_impl(const std::string& name):
-        _name(name)
+        _name(name), _schedule_valid(false), _resolve_threads(1)
     {
     }
 
@@ -126,6 +219,36 @@ public:
         return retrieve(name);
     }
 
+    void set_resolve_threads(size_t num_threads)
+    {
+        if (num_threads == 0) {
+            throw uhd::value_error("An expert container needs at least one resolve thread");
+        }
+        boost::lock_guard<boost::recursive_mutex> resolve_lock(_resolve_mutex);
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        EX_LOG(0, str(boost::format("set_resolve_threads(%d)") % num_threads));
+        //The calling thread is one of the resolve threads
+        _pool.reset((num_threads > 1) ? new expert_thread_pool(num_threads - 1) : NULL);
+        _resolve_threads = num_threads;
+    }
+
+    worker_stats_map_t get_worker_stats() const
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        boost::lock_guard<boost::mutex> stats_lock(_stats_mutex);
+        worker_stats_map_t stats;
+        BOOST_FOREACH(const vertex_map_t::value_type& v, _worker_map) {
+            stats[v.first] = (v.second < _worker_stats.size()) ? _worker_stats[v.second] : worker_stats_t();
+        }
+        return stats;
+    }
+
+    void reset_worker_stats()
+    {
+        boost::lock_guard<boost::mutex> stats_lock(_stats_mutex);
+        std::fill(_worker_stats.begin(), _worker_stats.end(), worker_stats_t());
+    }
+
     const node_retriever_t& node_retriever() const
     {
         return *this;
@@ -136,6 +259,7 @@ public:
         static const std::string DATA_SHAPE("ellipse");
         static const std::string WORKER_SHAPE("box");
 
+        boost::lock_guard<boost::mutex> stats_lock(_stats_mutex);
         std::string dot_str;
         dot_str += "digraph uhd_experts_" + _name + " {\n rankdir=LR;\n";
         // Iterate through the vertices and print them out
@@ -148,6 +272,12 @@ public:
                 dot_str += str(boost::format(" %d [label=\"%s\",shape=%s,xlabel=%s];\n") %
                                boost::uint32_t(*vi.first) % vertex.get_name() %
                                DATA_SHAPE % vertex.get_dtype());
+            } else if (*vi.first < _worker_stats.size() and _worker_stats[*vi.first].resolve_count > 0) {
+                const worker_stats_t& stats = _worker_stats[*vi.first];
+                dot_str += str(boost::format(" %d [label=\"%s\",shape=%s,xlabel=\"%u x, avg %.1f us, max %.1f us\"];\n") %
+                               boost::uint32_t(*vi.first) % vertex.get_name() % WORKER_SHAPE %
+                               stats.resolve_count % (stats.total_time / stats.resolve_count * 1e6) %
+                               (stats.max_time * 1e6));
             } else {
                 dot_str += str(boost::format(" %d [label=\"%s\",shape=%s];\n") %
                                boost::uint32_t(*vi.first) % vertex.get_name() % WORKER_SHAPE);
@@ -298,6 +428,7 @@ protected:
 
         try {
             //Add a vertex in this graph for the data node
+            _schedule_valid = false;
             expert_graph_t::vertex_descriptor gr_node = boost::add_vertex(data_node, _expert_dag);
             EX_LOG(1, str(boost::format("added vertex %s") % data_node->get_name()));
             _datanode_map.insert(vertex_map_t::value_type(data_node->get_name(), gr_node));
@@ -339,6 +470,7 @@ protected:
 
         try {
             //Add a vertex in this graph for the worker node
+            _schedule_valid = false;
             expert_graph_t::vertex_descriptor gr_node = boost::add_vertex(worker, _expert_dag);
             EX_LOG(1, str(boost::format("added vertex %s") % worker->get_name()));
             _worker_map.insert(vertex_map_t::value_type(worker->get_name(), gr_node));
@@ -401,14 +533,25 @@ protected:
         // Release all vertices and edges in the DAG
         _expert_dag.clear();
 
+        // Release the cached schedule and statistics
+        _schedule_valid = false;
+        _sorted_nodes.clear();
+        _node_levels.clear();
+        {
+            boost::lock_guard<boost::mutex> stats_lock(_stats_mutex);
+            _worker_stats.clear();
+        }
+
         // Release all nodes in the map
         _worker_map.clear();
         _datanode_map.clear();
     }
 
 private:
-    void _resolve_helper(std::string start, std::string stop, bool force)
+    void _update_schedule()
     {
+        if (_schedule_valid) return;
+
         //Sort the graph topologically. This ensures that for all dependencies, the dependant
         //is always after all of its dependencies.
         node_queue_t sorted_nodes;
@@ -427,20 +570,73 @@ private:
                                          "The following back-edges were found:" + edges);
             }
         }
-        if (sorted_nodes.empty()) return;
+        _sorted_nodes.swap(sorted_nodes);
+
+        //Assign every node a level: the length of the longest path leading to it.
+        //Nodes on the same level never depend on each other.
+        _node_levels.assign(boost::num_vertices(_expert_dag), 0);
+        for (node_queue_t::const_iterator node_iter = _sorted_nodes.begin();
+             node_iter != _sorted_nodes.end();
+             ++node_iter
+        ) {
+            for (std::pair<out_edge_iter, out_edge_iter> ei = boost::out_edges(*node_iter, _expert_dag);
+                 ei.first != ei.second;
+                 ++ei.first
+            ) {
+                size_t& level = _node_levels[boost::target(*(ei.first), _expert_dag)];
+                level = std::max(level, _node_levels[*node_iter] + 1);
+            }
+        }
+
+        {
+            boost::lock_guard<boost::mutex> stats_lock(_stats_mutex);
+            _worker_stats.resize(boost::num_vertices(_expert_dag));
+        }
+        _schedule_valid = true;
+    }
+
+    void _resolve_helper(std::string start, std::string stop, bool force)
+    {
+        //The topological order only changes when nodes are added so it is
+        //computed once and reused for every resolve
+        _update_schedule();
+        if (_sorted_nodes.empty()) return;
 
         //Determine the start and stop node. If one is not explicitly specified then
         //resolve everything
-        expert_graph_t::vertex_descriptor start_vertex = sorted_nodes.front();
-        expert_graph_t::vertex_descriptor stop_vertex = sorted_nodes.back();
+        expert_graph_t::vertex_descriptor start_vertex = _sorted_nodes.front();
+        expert_graph_t::vertex_descriptor stop_vertex = _sorted_nodes.back();
         if (not start.empty()) start_vertex = _lookup_vertex(start);
         if (not stop.empty()) stop_vertex = _lookup_vertex(stop);
 
         //First Pass: Resolve all nodes if they are dirty, in a topological order
         std::list<dag_vertex_t*> resolved_workers;
+        if (_resolve_threads > 1) {
+            _resolve_levels(start_vertex, stop_vertex, force, resolved_workers);
+        } else {
+            _resolve_sorted(start_vertex, stop_vertex, force, resolved_workers);
+        }
+
+        //Second Pass: Mark all the workers clean. The policy is that a worker will mark all of
+        //its dependencies clean so after this step all data nodes that are not consumed by a worker
+        //will remain dirty (as they should because no one has consumed their value)
+        for (std::list<dag_vertex_t*>::iterator worker = resolved_workers.begin();
+             worker != resolved_workers.end();
+             ++worker
+        ) {
+            (*worker)->mark_clean();
+        }
+    }
+
+    void _resolve_sorted(
+        expert_graph_t::vertex_descriptor start_vertex,
+        expert_graph_t::vertex_descriptor stop_vertex,
+        bool force,
+        std::list<dag_vertex_t*>& resolved_workers
+    ) {
         bool start_node_encountered = false;
-        for (node_queue_t::iterator node_iter = sorted_nodes.begin();
-             node_iter != sorted_nodes.end();
+        for (node_queue_t::const_iterator node_iter = _sorted_nodes.begin();
+             node_iter != _sorted_nodes.end();
              ++node_iter
         ) {
             //Determine if we are at or beyond the starting node
@@ -450,7 +646,7 @@ private:
             if (start_node_encountered) {
                 dag_vertex_t& node = _get_vertex(*node_iter);
                 if (force or node.is_dirty()) {
-                    node.resolve();
+                    _resolve_node(*node_iter);
                     if (node.get_class() == CLASS_WORKER) {
                         resolved_workers.push_back(&node);
                     }
@@ -463,16 +659,106 @@ private:
             //Determine if we are beyond the stop node
             if (*node_iter == stop_vertex) break;
         }
+    }
 
-        //Second Pass: Mark all the workers clean. The policy is that a worker will mark all of
-        //its dependencies clean so after this step all data nodes that are not consumed by a worker
-        //will remain dirty (as they should because no one has consumed their value)
-        for (std::list<dag_vertex_t*>::iterator worker = resolved_workers.begin();
-             worker != resolved_workers.end();
-             ++worker
+    void _resolve_levels(
+        expert_graph_t::vertex_descriptor start_vertex,
+        expert_graph_t::vertex_descriptor stop_vertex,
+        bool force,
+        std::list<dag_vertex_t*>& resolved_workers
+    ) {
+        //Select the same range of nodes as the sorted resolve and group them by level
+        std::vector< std::vector<expert_graph_t::vertex_descriptor> > levels;
+        bool start_node_encountered = false;
+        for (node_queue_t::const_iterator node_iter = _sorted_nodes.begin();
+             node_iter != _sorted_nodes.end();
+             ++node_iter
         ) {
-            (*worker)->mark_clean();
+            if (*node_iter == start_vertex) start_node_encountered = true;
+            if (start_node_encountered) {
+                const size_t level = _node_levels[*node_iter];
+                if (level >= levels.size()) levels.resize(level + 1);
+                levels[level].push_back(*node_iter);
+            }
+            if (*node_iter == stop_vertex) break;
+        }
+
+        //Resolve one level at a time. The dirty workers in a level run concurrently.
+        for (size_t level = 0; level < levels.size(); level++) {
+            std::vector<expert_graph_t::vertex_descriptor> batch;
+            BOOST_FOREACH(expert_graph_t::vertex_descriptor v, levels[level]) {
+                dag_vertex_t& node = _get_vertex(v);
+                if (force or node.is_dirty()) {
+                    if (node.get_class() == CLASS_WORKER) {
+                        batch.push_back(v);
+                        resolved_workers.push_back(&node);
+                    } else {
+                        node.resolve();
+                    }
+                    EX_LOG(1, str(boost::format("resolving node %s (level %d)") % node.get_name() % level));
+                } else {
+                    EX_LOG(1, str(boost::format("skipped node %s (%s)") % node.get_name() % (node.is_dirty()?"dirty":"clean")));
+                }
+            }
+            _resolve_batch(batch);
+        }
+    }
+
+    void _resolve_batch(const std::vector<expert_graph_t::vertex_descriptor>& batch)
+    {
+        if (batch.empty()) return;
+        if (batch.size() == 1) {
+            _resolve_node(batch.front());
+            return;
+        }
+
+        //Errors are collected per worker and the first one is rethrown
+        //once the whole batch has finished
+        std::vector< boost::shared_ptr<uhd::exception> > errors(batch.size());
+        std::vector<expert_thread_pool::job_t> jobs;
+        for (size_t i = 0; i < batch.size(); i++) {
+            jobs.push_back(boost::bind(&expert_container_impl::_resolve_node_job, this, batch[i], boost::ref(errors[i])));
         }
+        _pool->run_all(jobs);
+        BOOST_FOREACH(const boost::shared_ptr<uhd::exception>& error, errors) {
+            if (error) error->dynamic_throw();
+        }
+    }
+
+    void _resolve_node_job(
+        expert_graph_t::vertex_descriptor v,
+        boost::shared_ptr<uhd::exception>& error
+    ) {
+        try {
+            _resolve_node(v);
+        } catch (const uhd::exception& ex) {
+            error.reset(ex.dynamic_clone());
+        } catch (const std::exception& ex) {
+            error.reset(new uhd::runtime_error(ex.what()));
+        } catch (...) {
+            error.reset(new uhd::runtime_error("Unknown error resolving " + _get_vertex(v).get_name()));
+        }
+    }
+
+    void _resolve_node(expert_graph_t::vertex_descriptor v)
+    {
+        dag_vertex_t& node = _get_vertex(v);
+        if (node.get_class() != CLASS_WORKER) {
+            node.resolve();
+            return;
+        }
+
+        //The statistics are only locked for the update, pool threads
+        //resolve without the container lock
+        const time_spec_t start_time = time_spec_t::get_system_time();
+        node.resolve();
+        const double elapsed = (time_spec_t::get_system_time() - start_time).get_real_secs();
+        boost::lock_guard<boost::mutex> stats_lock(_stats_mutex);
+        worker_stats_t& stats = _worker_stats[v];
+        stats.resolve_count++;
+        stats.total_time += elapsed;
+        stats.last_time = elapsed;
+        stats.max_time = std::max(stats.max_time, elapsed);
     }
 
     expert_graph_t::vertex_descriptor _lookup_vertex(const std::string& name) const
@@ -516,7 +802,14 @@ private:
     expert_graph_t          _expert_dag;        //The primary graph data structure as an adjacency list
     vertex_map_t            _worker_map;        //A map from vertex name to vertex descriptor for workers
     vertex_map_t            _datanode_map;      //A map from vertex name to vertex descriptor for data nodes
-    boost::mutex            _mutex;
+    node_queue_t            _sorted_nodes;      //Cached topological order of the graph
+    std::vector<size_t>     _node_levels;       //Cached level of every vertex (longest path to it)
+    std::vector<worker_stats_t> _worker_stats;  //Resolve timing indexed by vertex descriptor
+    bool                    _schedule_valid;    //False when the graph changed since the last sort
+    size_t                  _resolve_threads;
+    boost::scoped_ptr<expert_thread_pool> _pool;
+    mutable boost::mutex    _mutex;
+    mutable boost::mutex    _stats_mutex;       //Guards _worker_stats, taken after _mutex
     boost::recursive_mutex  _resolve_mutex;
 };
 
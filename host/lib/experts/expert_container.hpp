@@ -23,6 +23,8 @@
 #include <boost/noncopyable.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/recursive_mutex.hpp>
+#include <map>
+#include <string>
 
 namespace uhd { namespace experts {
 
@@ -33,6 +35,24 @@ namespace uhd { namespace experts {
         AUTO_RESOLVE_ON_READ_WRITE
     };
 
+    /*!
+     * Resolve timing statistics for a single worker node.
+     * Times are in seconds and only count calls to resolve()
+     * that completed, i.e. clean workers that were skipped
+     * and workers that threw are not recorded.
+     */
+    struct worker_stats_t {
+        worker_stats_t():
+            resolve_count(0), total_time(0.0), last_time(0.0), max_time(0.0) {}
+
+        size_t resolve_count;
+        double total_time;
+        double last_time;
+        double max_time;
+    };
+
+    typedef std::map<std::string, worker_stats_t> worker_stats_map_t;
+
     class UHD_API expert_container : private boost::noncopyable, public node_retriever_t {
     public: //Methods
         typedef boost::shared_ptr<expert_container> sptr;
@@ -96,6 +116,35 @@ namespace uhd { namespace experts {
          */
         virtual void resolve_to(const std::string& node_name) = 0;
 
+        /*!
+         * Set the number of threads used to resolve workers.
+         *
+         * With one thread (the default) nodes are resolved one
+         * at a time in a topologically sorted order.
+         * With more threads the graph is resolved in levels, where
+         * a level holds all nodes whose longest dependency chain
+         * has the same length. Dirty workers within a level do not
+         * depend on each other and are resolved concurrently on a
+         * pool of threads, which includes the calling thread.
+         * Workers of a container resolved in parallel must not
+         * share state that is not thread-safe.
+         *
+         * \param num_threads The number of threads (at least 1)
+         * \throws uhd::value_error if num_threads is zero
+         */
+        virtual void set_resolve_threads(size_t num_threads) = 0;
+
+        /*!
+         * Return the resolve timing statistics of all workers
+         * in this container, keyed by worker name.
+         */
+        virtual worker_stats_map_t get_worker_stats() const = 0;
+
+        /*!
+         * Reset the resolve timing statistics of all workers.
+         */
+        virtual void reset_worker_stats() = 0;
+
         /*!
          * Return a node retriever object for this container
          */
@@ -105,7 +154,9 @@ namespace uhd { namespace experts {
          * Returns a DOT (graph description language) representation
          * of the expert graph. The output has labels for the node
          * name, node type (data or worker) and the underlying
-         * data type for each node.
+         * data type for each node. Workers that have been resolved
+         * are also labeled with their resolve count, average and
+         * maximum resolve time (see get_worker_stats()).
          *
          */
         virtual std::string to_dot() const = 0;
@@ -16,10 +16,18 @@
 //
 
 #include <uhd/property_tree.hpp>
-#include <uhd/types/dict.hpp>
+#include <uhd/types/hash_dict.hpp>
+#include <uhd/utils/atomic.hpp>
 #include <boost/foreach.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/unordered_map.hpp>
 #include <boost/make_shared.hpp>
+#include <algorithm>
+#include <map>
 #include <iostream>
 
 using namespace uhd;
@@ -72,7 +80,157 @@ fs_path uhd::operator/(const fs_path &lhs, size_t rhs)
 }
 
 /***********************************************************************
- * Property tree implementation
+ * Property transaction queue implementation:
+ * Every thread with an open or committing transaction has its own state,
+ * so properties set by other threads are never deferred into it.
+ **********************************************************************/
+class property_transaction_queue_impl : public uhd::property_transaction_queue{
+public:
+    property_transaction_queue_impl(void){
+        _num_active.write(0);
+    }
+
+    void begin(void){
+        boost::mutex::scoped_lock lock(_mutex);
+        const boost::thread::id id = boost::this_thread::get_id();
+        if (_states.count(id) == 0) _num_active.inc();
+        _states[id].depth++;
+    }
+
+    void commit(void){
+        const boost::thread::id id = boost::this_thread::get_id();
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            state_map_type::iterator it = _states.find(id);
+            if (it == _states.end() or it->second.depth == 0) throw uhd::runtime_error("Cannot commit! No property transaction is open");
+            if (--it->second.depth != 0) return; //only the outermost commit runs
+            if (it->second.committing) return; //opened by an update, the running commit picks it up
+            it->second.committing = true;
+        }
+
+        try{
+            while (this->run_round(id)){}
+        }
+        catch(...){
+            this->close(id);
+            throw;
+        }
+        this->close(id);
+    }
+
+    bool defer(const void *prop, const update_type &update){
+        if (_num_active.read() == 0) return false; //the usual case, no lock
+        boost::mutex::scoped_lock lock(_mutex);
+        state_map_type::iterator it = _states.find(boost::this_thread::get_id());
+        if (it == _states.end()) return false;
+        state_type &state = it->second;
+        if (state.updates.count(prop) == 0){
+            state.order.push_back(prop);
+            state.updates[prop] = update;
+        }
+        return true;
+    }
+
+    void flush(const void *prop){
+        if (_num_active.read() == 0) return; //the usual case, no lock
+        update_type update;
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            state_map_type::iterator it = _states.find(boost::this_thread::get_id());
+            if (it == _states.end() or not it->second.committing) return;
+            if (not take_update(it->second, prop, update)) return;
+        }
+        update(); //let errors propagate
+    }
+
+    void forget(const void *prop){
+        boost::mutex::scoped_lock lock(_mutex);
+        BOOST_FOREACH(state_map_type::value_type &entry, _states){
+            if (entry.second.updates.erase(prop) == 0) continue;
+            std::vector<const void *> &order = entry.second.order;
+            order.erase(std::remove(order.begin(), order.end(), prop), order.end());
+        }
+    }
+
+private:
+    struct state_type{
+        state_type(void): depth(0), committing(false){}
+        size_t depth;
+        bool committing;
+        std::vector<const void *> order; //properties first set since the round started
+        boost::unordered_map<const void *, update_type> updates; //all updates that did not run
+    };
+    typedef std::map<boost::thread::id, state_type> state_map_type;
+
+    //! Move the update of a property out of the state (lock held by caller)
+    static bool take_update(state_type &state, const void *prop, update_type &update){
+        boost::unordered_map<const void *, update_type>::iterator it = state.updates.find(prop);
+        if (it == state.updates.end()) return false;
+        update.swap(it->second);
+        state.updates.erase(it);
+        return true;
+    }
+
+    /*!
+     * Run the updates queued before the round started, in the order they were queued.
+     * Properties set meanwhile go into the next round, unless their update did not run yet.
+     * \return false when nothing was queued
+     */
+    bool run_round(const boost::thread::id &id){
+        std::vector<const void *> round;
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            round.swap(_states[id].order);
+        }
+        if (round.empty()) return false;
+
+        BOOST_FOREACH(const void *prop, round){
+            update_type update;
+            {
+                boost::mutex::scoped_lock lock(_mutex);
+                if (not take_update(_states[id], prop, update)) continue; //flushed or forgotten
+            }
+            update(); //let errors propagate
+        }
+        return true;
+    }
+
+    //! Drop the state of a thread once its commit is done or failed
+    void close(const boost::thread::id &id){
+        boost::mutex::scoped_lock lock(_mutex);
+        state_map_type::iterator it = _states.find(id);
+        if (it == _states.end()) return;
+        if (it->second.depth != 0){ //an update opened a transaction and did not close it
+            it->second.committing = false;
+            it->second.order.clear();
+            it->second.updates.clear();
+            return;
+        }
+        _states.erase(it);
+        _num_active.dec();
+    }
+
+    boost::mutex _mutex;
+    uhd::atomic_uint32_t _num_active; //threads with a state
+    state_map_type _states;
+};
+
+property_transaction_queue::~property_transaction_queue(void){
+    /* NOP */
+}
+
+property_transaction_queue::sptr property_transaction_queue::make(void){
+    return sptr(new property_transaction_queue_impl());
+}
+
+/***********************************************************************
+ * Property tree implementation:
+ * Nodes are owned by their parent and also indexed by their full path,
+ * so a lookup is one hash of the path instead of a walk from the root.
+ * Lookups share the lock, only create and remove take it exclusively.
+ * While any directory is lazy, every call first checks whether the path
+ * is under one with init functions to run. The lazy directories are kept
+ * apart from the tree with their own lock, so other paths are not held up.
  **********************************************************************/
 class property_tree_impl : public uhd::property_tree{
 public:
@@ -81,11 +239,13 @@ public:
         _root(root)
     {
         _guts = boost::make_shared<tree_guts_type>();
+        _guts->index[""] = &_guts->root;
+        _guts->transactions = property_transaction_queue::make();
+        _guts->num_lazy.write(0);
     }
 
     sptr subtree(const fs_path &path_) const{
         const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
 
         property_tree_impl *subtree = new property_tree_impl(path);
         subtree->_guts = this->_guts; //copy the guts sptr
@@ -94,86 +254,247 @@ public:
 
     void remove(const fs_path &path_){
         const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
+        const std::string key = make_key(path);
+        run_lazy_inits(key, false);
+        boost::unique_lock<boost::shared_mutex> lock(_guts->mutex);
 
-        node_type *parent = NULL;
-        node_type *node = &_guts->root;
-        BOOST_FOREACH(const std::string &name, path_tokenizer(path)){
-            if (not node->has_key(name)) throw_path_not_found(path);
-            parent = node;
-            node = &(*node)[name];
-        }
-        if (parent == NULL) throw uhd::runtime_error("Cannot uproot");
-        parent->pop(fs_path(path.leaf()));
+        node_type *node = find_node(key);
+        if (node == NULL) throw_path_not_found(path);
+        if (key.empty()) throw uhd::runtime_error("Cannot uproot");
+
+        const size_t pos = key.rfind("/");
+        node_type *parent = find_node(key.substr(0, pos));
+        unindex(key, node);
+        parent->children.pop(key.substr(pos+1));
+        drop_lazy_inits(key);
     }
 
     bool exists(const fs_path &path_) const{
         const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
+        const std::string key = make_key(path);
+        run_lazy_inits(key);
+        boost::shared_lock<boost::shared_mutex> lock(_guts->mutex);
 
-        node_type *node = &_guts->root;
-        BOOST_FOREACH(const std::string &name, path_tokenizer(path)){
-            if (not node->has_key(name)) return false;
-            node = &(*node)[name];
-        }
-        return true;
+        return find_node(key) != NULL;
     }
 
     std::vector<std::string> list(const fs_path &path_) const{
         const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
+        const std::string key = make_key(path);
+        run_lazy_inits(key);
+        boost::shared_lock<boost::shared_mutex> lock(_guts->mutex);
 
-        node_type *node = &_guts->root;
-        BOOST_FOREACH(const std::string &name, path_tokenizer(path)){
-            if (not node->has_key(name)) throw_path_not_found(path);
-            node = &(*node)[name];
-        }
+        node_type *node = find_node(key);
+        if (node == NULL) throw_path_not_found(path);
+
+        return node->children.keys();
+    }
 
-        return node->keys();
+    void create_lazy(const fs_path &path_, const lazy_init_type &init){
+        const fs_path path = _root / path_;
+        const std::string key = make_key(path);
+        run_lazy_inits(key, false);
+        boost::unique_lock<boost::shared_mutex> lock(_guts->mutex);
+
+        make_node(key);
+        boost::mutex::scoped_lock lazy_lock(_guts->lazy_mutex);
+        std::vector<lazy_init_type> &inits = _guts->lazy_pending[key];
+        if (inits.empty()) _guts->num_lazy.inc();
+        inits.push_back(init);
     }
 
     void _create(const fs_path &path_, const boost::shared_ptr<void> &prop){
         const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
+        const std::string key = make_key(path);
+        run_lazy_inits(key);
+        boost::unique_lock<boost::shared_mutex> lock(_guts->mutex);
 
-        node_type *node = &_guts->root;
-        BOOST_FOREACH(const std::string &name, path_tokenizer(path)){
-            if (not node->has_key(name)) (*node)[name] = node_type();
-            node = &(*node)[name];
-        }
+        node_type *node = make_node(key);
         if (node->prop.get() != NULL) throw uhd::runtime_error("Cannot create! Property already exists at: " + path);
         node->prop = prop;
     }
 
     boost::shared_ptr<void> &_access(const fs_path &path_) const{
         const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
+        const std::string key = make_key(path);
+        run_lazy_inits(key);
+        boost::shared_lock<boost::shared_mutex> lock(_guts->mutex);
 
-        node_type *node = &_guts->root;
-        BOOST_FOREACH(const std::string &name, path_tokenizer(path)){
-            if (not node->has_key(name)) throw_path_not_found(path);
-            node = &(*node)[name];
-        }
+        node_type *node = find_node(key);
+        if (node == NULL) throw_path_not_found(path);
         if (node->prop.get() == NULL) throw uhd::runtime_error("Cannot access! Property uninitialized at: " + path);
         return node->prop;
     }
 
 private:
+    property_transaction_queue::sptr _transactions(void) const{
+        return _guts->transactions;
+    }
+
     void throw_path_not_found(const fs_path &path) const{
         throw uhd::lookup_error("Path not found in tree: " + path);
     }
 
+    //! The index key of a path: "/a/b/c", or empty for the root
+    static std::string make_key(const fs_path &path){
+        //most paths are already in this form
+        if (path.empty() or (path[0] == '/'
+            and *path.rbegin() != '/'
+            and path.find("//") == std::string::npos)
+        ) return path;
+
+        std::string key;
+        BOOST_FOREACH(const std::string &name, path_tokenizer(path)){
+            key += "/" + name;
+        }
+        return key;
+    }
+
     //basic structural node element
-    struct node_type : uhd::dict<std::string, node_type>{
+    struct node_type{
+        uhd::hash_dict<std::string, boost::shared_ptr<node_type> > children;
         boost::shared_ptr<void> prop;
     };
 
+    typedef boost::unordered_map<std::string, node_type *> index_type;
+
     //tree guts which may be referenced in a subtree
     struct tree_guts_type{
         node_type root;
-        boost::mutex mutex;
+        index_type index;
+        boost::shared_mutex mutex;
+        property_transaction_queue::sptr transactions;
+        uhd::atomic_uint32_t num_lazy; //lazy directories pending or running
+        boost::mutex lazy_mutex; //guards the lazy directories, never held by init functions
+        boost::condition_variable lazy_cond; //signaled when init functions are done
+        std::map<std::string, std::vector<lazy_init_type> > lazy_pending;
+        std::map<std::string, boost::thread::id> lazy_running;
     };
 
+    //! Find a node from its key or NULL (lock held by caller)
+    node_type *find_node(const std::string &key) const{
+        index_type::const_iterator it = _guts->index.find(key);
+        return (it == _guts->index.end())? NULL : it->second;
+    }
+
+    //! Find a node from its key or create it and its parents (lock held by caller)
+    node_type *make_node(const std::string &key){
+        node_type *node = find_node(key);
+        if (node != NULL) return node;
+
+        node = &_guts->root;
+        std::string node_key;
+        BOOST_FOREACH(const std::string &name, path_tokenizer(key)){
+            node_key += "/" + name;
+            if (not node->children.has_key(name)){
+                node->children[name] = boost::make_shared<node_type>();
+                _guts->index[node_key] = node->children[name].get();
+            }
+            node = node->children[name].get();
+        }
+        return node;
+    }
+
+    //! Is the key at or below the lazy directory key?
+    static bool is_under(const std::string &key, const std::string &lazy_key, const bool include_self){
+        if (key.size() == lazy_key.size()) return include_self and key == lazy_key;
+        return key.size() > lazy_key.size()
+            and key[lazy_key.size()] == '/'
+            and key.compare(0, lazy_key.size(), lazy_key) == 0;
+    }
+
+    /*!
+     * Run the init functions of the lazy directories above a path, outer ones first.
+     * Only callers under a directory whose init functions are running wait for them.
+     * The init functions themselves use the tree as it is, their calls do not run
+     * or wait for any other init functions.
+     */
+    void run_lazy_inits(const std::string &key, const bool include_self = true) const{
+        if (_guts->num_lazy.read() == 0) return; //the usual case, no lock
+        boost::mutex::scoped_lock lazy_lock(_guts->lazy_mutex);
+
+        const boost::thread::id this_id = boost::this_thread::get_id();
+        typedef std::pair<std::string, boost::thread::id> running_pair_type;
+        BOOST_FOREACH(const running_pair_type &running, _guts->lazy_running){
+            if (running.second == this_id) return; //called from an init function
+        }
+
+        while (true){
+            //the outermost lazy directory above the path, pending or running
+            std::string lazy_key;
+            bool found = false, running = false;
+            typedef std::pair<std::string, std::vector<lazy_init_type> > pending_pair_type;
+            BOOST_FOREACH(const pending_pair_type &pending, _guts->lazy_pending){
+                if (not is_under(key, pending.first, include_self)) continue;
+                if (not found or pending.first.size() < lazy_key.size()){
+                    lazy_key = pending.first;
+                    found = true;
+                }
+            }
+            BOOST_FOREACH(const running_pair_type &other, _guts->lazy_running){
+                if (not is_under(key, other.first, include_self)) continue;
+                if (not found or other.first.size() <= lazy_key.size()){
+                    lazy_key = other.first;
+                    found = running = true;
+                }
+            }
+            if (not found) return;
+            if (running){
+                _guts->lazy_cond.wait(lazy_lock);
+                continue;
+            }
+
+            //an init function runs once, even when it throws
+            std::vector<lazy_init_type> inits;
+            inits.swap(_guts->lazy_pending[lazy_key]);
+            _guts->lazy_pending.erase(lazy_key);
+            _guts->lazy_running[lazy_key] = this_id;
+            lazy_lock.unlock();
+            try{
+                BOOST_FOREACH(const lazy_init_type &init, inits){
+                    init();
+                }
+            }
+            catch(...){
+                lazy_lock.lock();
+                lazy_done(lazy_key);
+                throw;
+            }
+            lazy_lock.lock();
+            lazy_done(lazy_key);
+        }
+    }
+
+    //! Mark the init functions of a lazy directory done (lazy lock held by caller)
+    void lazy_done(const std::string &lazy_key) const{
+        _guts->lazy_running.erase(lazy_key);
+        _guts->num_lazy.dec();
+        _guts->lazy_cond.notify_all();
+    }
+
+    //! Drop the init functions that did not run at or below a removed key
+    void drop_lazy_inits(const std::string &key){
+        boost::mutex::scoped_lock lazy_lock(_guts->lazy_mutex);
+        std::vector<std::string> dropped;
+        typedef std::pair<std::string, std::vector<lazy_init_type> > pending_pair_type;
+        BOOST_FOREACH(const pending_pair_type &pending, _guts->lazy_pending){
+            if (is_under(pending.first, key, true)) dropped.push_back(pending.first);
+        }
+        BOOST_FOREACH(const std::string &lazy_key, dropped){
+            _guts->lazy_pending.erase(lazy_key);
+            _guts->num_lazy.dec();
+        }
+    }
+
+    //! Remove a node and its descendants from the index (lock held by caller)
+    void unindex(const std::string &key, node_type *node){
+        BOOST_FOREACH(const std::string &name, node->children.keys()){
+            unindex(key + "/" + name, node->children[name].get());
+        }
+        _guts->index.erase(key);
+        if (node->prop.get() != NULL) _guts->transactions->forget(node->prop.get());
+    }
+
     //members, the tree and root prefix
     boost::shared_ptr<tree_guts_type> _guts;
     const fs_path _root;
@@ -183,6 +504,14 @@ property_tree::~property_tree(void){
     /* NOP */
 }
 
+void property_tree::begin_transaction(void){
+    this->_transactions()->begin();
+}
+
+void property_tree::commit_transaction(void){
+    this->_transactions()->commit();
+}
+
 /***********************************************************************
  * Property tree factory
  **********************************************************************/
@@ -16,6 +16,7 @@
 //
 
 #include <uhd/stream.hpp>
+#include <uhd/exception.hpp>
 
 using namespace uhd;
 
@@ -24,6 +25,13 @@ rx_streamer::~rx_streamer(void)
     //empty
 }
 
+void rx_streamer::set_host_correction(
+    const size_t, const std::complex<double> &,
+    const std::complex<double> &, const std::complex<double> &
+){
+    throw uhd::not_implemented_error("this streamer does not support host corrections");
+}
+
 tx_streamer::~tx_streamer(void)
 {
     //empty
@@ -89,8 +89,13 @@ private:
 libusb::session::sptr libusb::session::get_global_session(void){
     static boost::weak_ptr<session> global_session;
 
+    //lock for atomic access, device finders call this from several threads
+    static boost::mutex mutex;
+    boost::mutex::scoped_lock lock(mutex);
+
     //not expired -> get existing session
-    if (not global_session.expired()) return global_session.lock();
+    sptr existing_session = global_session.lock();
+    if (existing_session) return existing_session;
 
     //create a new global session
     sptr new_global_session(new libusb_session_impl());
@@ -0,0 +1,141 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_NCO_MIXER_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_NCO_MIXER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <algorithm>
+#include <complex>
+#include <cmath>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace uhd{ namespace transport{ namespace sph{
+
+/***********************************************************************
+ * NCO mixer:
+ * Multiplies complex float samples by exp(j*2*pi*phase[n]).
+ * The phase is held in cycles in double precision and the rotation
+ * is generated recursively, resynchronized to the double phase
+ * every block to keep the amplitude and phase error bounded.
+ **********************************************************************/
+class nco_mixer{
+public:
+    nco_mixer(void): _freq(0.0), _phase(0.0){}
+
+    //! Set the frequency in cycles per sample
+    void set_freq(const double freq){
+        _freq = freq;
+    }
+
+    //! Get the frequency in cycles per sample
+    double get_freq(void) const{
+        return _freq;
+    }
+
+    //! Set the phase of the next sample in cycles
+    void set_phase(const double phase){
+        _phase = phase - std::floor(phase);
+    }
+
+    //! Get the phase of the next sample in cycles
+    double get_phase(void) const{
+        return _phase;
+    }
+
+    /*!
+     * Set the phase from a sample time, so that the phase only depends
+     * on the absolute time and stays continuous across packets and drops.
+     * \param time the time of the next sample
+     * \param freq_hz the NCO frequency in Hz
+     */
+    void set_phase_at(const time_spec_t &time, const double freq_hz){
+        //split the product to keep precision for large full seconds
+        const double whole = double(time.get_full_secs())*freq_hz;
+        this->set_phase((whole - std::floor(whole)) + time.get_frac_secs()*freq_hz);
+    }
+
+    /*!
+     * Mix the samples and advance the phase.
+     * The input and output may be the same buffer.
+     */
+    UHD_INLINE void mix(
+        const std::complex<float> *in, std::complex<float> *out, const size_t nsamps
+    ){
+        for (size_t i = 0; i < nsamps; i += BLOCK_SIZE){
+            const size_t n = std::min<size_t>(BLOCK_SIZE, nsamps - i);
+            mix_block(in + i, out + i, n);
+            this->set_phase(_phase + n*_freq);
+        }
+    }
+
+private:
+    static const size_t BLOCK_SIZE = 64;
+    double _freq, _phase;
+
+    UHD_INLINE void mix_block(
+        const std::complex<float> *in, std::complex<float> *out, const size_t nsamps
+    ){
+        const double w = 2*M_PI*_freq;
+        std::complex<float> p0(std::polar(1.0f, float(2*M_PI*_phase)));
+        size_t i = 0;
+
+        #ifdef __SSE2__
+        //two samples per register: [re0, im0, re1, im1]
+        const std::complex<float> p1 = p0*std::complex<float>(std::polar(1.0, w));
+        const std::complex<float> step(std::polar(1.0, 2*w));
+        __m128 p = _mm_set_ps(p1.imag(), p1.real(), p0.imag(), p0.real());
+        const __m128 s_re = _mm_set1_ps(step.real());
+        const __m128 s_im = _mm_set_ps(step.imag(), -step.imag(), step.imag(), -step.imag());
+        for (; i + 1 < nsamps; i += 2){
+            const __m128 x = _mm_loadu_ps(reinterpret_cast<const float *>(in + i));
+            _mm_storeu_ps(reinterpret_cast<float *>(out + i), cmul(x, p));
+            //rotate the phasors: p*step
+            const __m128 p_swap = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 3, 0, 1));
+            p = _mm_add_ps(_mm_mul_ps(p, s_re), _mm_mul_ps(p_swap, s_im));
+        }
+        float p_tail[4];
+        _mm_storeu_ps(p_tail, p);
+        p0 = std::complex<float>(p_tail[0], p_tail[1]);
+        #endif
+
+        //scalar remainder (or everything without sse2)
+        const std::complex<float> step1(std::polar(1.0, w));
+        for (; i < nsamps; i++){
+            out[i] = in[i]*p0;
+            p0 *= step1;
+        }
+    }
+
+    #ifdef __SSE2__
+    //! multiply two pairs of interleaved complex floats
+    static UHD_INLINE __m128 cmul(const __m128 x, const __m128 p){
+        const __m128 p_re = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+        const __m128 p_im = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+        const __m128 x_swap = _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+        const __m128 sign = _mm_set_ps(1.0f, -1.0f, 1.0f, -1.0f);
+        return _mm_add_ps(_mm_mul_ps(x, p_re), _mm_mul_ps(_mm_mul_ps(x_swap, p_im), sign));
+    }
+    #endif
+};
+
+}}} //namespace uhd::transport::sph
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_NCO_MIXER_HPP */
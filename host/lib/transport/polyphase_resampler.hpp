@@ -0,0 +1,175 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_POLYPHASE_RESAMPLER_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_POLYPHASE_RESAMPLER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/exception.hpp>
+#include <boost/math/common_factor_rt.hpp>
+#include <algorithm>
+#include <complex>
+#include <vector>
+#include <cmath>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace uhd{ namespace transport{ namespace sph{
+
+/***********************************************************************
+ * Polyphase rational resampler:
+ * Resamples complex floats by interp/decim with a windowed-sinc
+ * lowpass split into interp phases of taps_per_phase taps each.
+ * Only the outputs that are kept get computed.
+ * The filter history is kept between calls, so a stream can be
+ * processed in arbitrary chunks.
+ **********************************************************************/
+class polyphase_resampler{
+public:
+    polyphase_resampler(
+        const size_t interp = 1, const size_t decim = 1, const size_t taps_per_phase = 32
+    ){
+        if (interp == 0 or decim == 0 or taps_per_phase == 0) throw uhd::value_error(
+            "polyphase_resampler: interp, decim and taps must be non-zero");
+        const size_t gcd = boost::math::gcd(interp, decim);
+        _interp = interp/gcd;
+        _decim = decim/gcd;
+        _ntaps = taps_per_phase;
+        this->design_taps();
+        this->reset();
+    }
+
+    size_t get_interp(void) const{return _interp;}
+    size_t get_decim(void) const{return _decim;}
+
+    //! Clear the filter history, the next input restarts the filter
+    void reset(void){
+        _work.assign(_ntaps - 1, std::complex<float>(0.0f));
+        _pos = 0;
+    }
+
+    //! The largest number of outputs for nsamps inputs
+    size_t get_max_output(const size_t nsamps) const{
+        return (nsamps*_interp)/_decim + 1;
+    }
+
+    /*!
+     * The position of the next output sample, in input samples,
+     * relative to the next input sample (negative when it lies before it).
+     * The filter's group delay is accounted for.
+     */
+    double get_next_output_offset(void) const{
+        const double delay = (_ntaps*_interp - 1)/2.0;
+        return (double(_pos) - delay)/_interp;
+    }
+
+    /*!
+     * Resample a chunk of input.
+     * \param in the input samples
+     * \param nsamps the number of input samples
+     * \param out room for get_max_output(nsamps) outputs
+     * \return the number of outputs written
+     */
+    UHD_INLINE size_t process(
+        const std::complex<float> *in, const size_t nsamps, std::complex<float> *out
+    ){
+        //history followed by the new input
+        const size_t nhist = _ntaps - 1;
+        _work.resize(nhist + nsamps);
+        std::copy(in, in + nsamps, _work.begin() + nhist);
+
+        size_t nout = 0;
+        const size_t end = nsamps*_interp;
+        for (; _pos < end; _pos += _decim){
+            const size_t newest = _pos/_interp + nhist;
+            const float *taps = &_taps[(_pos%_interp)*_ntaps*2];
+            out[nout++] = dot(&_work[newest + 1 - _ntaps], taps);
+        }
+        _pos -= end;
+
+        //keep the newest samples as history
+        std::copy(_work.end() - nhist, _work.end(), _work.begin());
+        _work.resize(nhist);
+        return nout;
+    }
+
+private:
+    size_t _interp, _decim, _ntaps;
+    size_t _pos; //upsampled index of the next output, relative to the next input
+    std::vector<float> _taps; //per phase, oldest sample first, each tap duplicated for re/im
+    std::vector<std::complex<float> > _work;
+
+    void design_taps(void){
+        //blackman windowed sinc at the upsampled rate, cutoff below both nyquists
+        const size_t len = _ntaps*_interp;
+        const double cutoff = 0.5/std::max(_interp, _decim);
+        const double mid = (len - 1)/2.0;
+        std::vector<double> proto(len);
+        double sum = 0.0;
+        for (size_t n = 0; n < len; n++){
+            const double t = n - mid;
+            const double sinc = (t == 0.0)? 1.0 : std::sin(2*M_PI*cutoff*t)/(2*M_PI*cutoff*t);
+            const double win = (len == 1)? 1.0 : 0.42
+                - 0.5*std::cos(2*M_PI*n/(len - 1))
+                + 0.08*std::cos(4*M_PI*n/(len - 1));
+            proto[n] = sinc*win;
+            sum += proto[n];
+        }
+
+        //unity passband gain after interpolation
+        //output at phase p uses proto[p + k*interp] on input newest - k
+        _taps.resize(len*2);
+        for (size_t p = 0; p < _interp; p++){
+            for (size_t k = 0; k < _ntaps; k++){
+                const float tap = float(proto[p + k*_interp]*_interp/sum);
+                const size_t idx = (p*_ntaps + (_ntaps - 1 - k))*2;
+                _taps[idx + 0] = tap;
+                _taps[idx + 1] = tap;
+            }
+        }
+    }
+
+    //! dot product of ntaps complex samples with real taps (duplicated)
+    UHD_INLINE std::complex<float> dot(const std::complex<float> *x, const float *taps) const{
+        const float *xf = reinterpret_cast<const float *>(x);
+        size_t i = 0;
+        float acc_re = 0.0f, acc_im = 0.0f;
+
+        #ifdef __SSE2__
+        //two complex samples per register
+        __m128 acc = _mm_setzero_ps();
+        for (; i + 1 < _ntaps; i += 2){
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(xf + i*2), _mm_loadu_ps(taps + i*2)));
+        }
+        float sums[4];
+        _mm_storeu_ps(sums, acc);
+        acc_re = sums[0] + sums[2];
+        acc_im = sums[1] + sums[3];
+        #endif
+
+        for (; i < _ntaps; i++){
+            acc_re += xf[i*2 + 0]*taps[i*2 + 0];
+            acc_im += xf[i*2 + 1]*taps[i*2 + 1];
+        }
+        return std::complex<float>(acc_re, acc_im);
+    }
+};
+
+}}} //namespace uhd::transport::sph
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_POLYPHASE_RESAMPLER_HPP */
@@ -22,6 +22,7 @@
 #include <uhd/exception.hpp>
 #include <uhd/convert.hpp>
 #include <uhd/stream.hpp>
+#include <uhd/types/device_addr.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/tasks.hpp>
 #include <uhd/utils/atomic.hpp>
@@ -29,6 +30,9 @@
 #include <uhd/types/metadata.hpp>
 #include <uhd/transport/vrt_if_packet.hpp>
 #include <uhd/transport/zero_copy.hpp>
+#include "nco_mixer.hpp"
+#include "polyphase_resampler.hpp"
+#include "tick_time.hpp"
 #include <boost/dynamic_bitset.hpp>
 #include <boost/foreach.hpp>
 #include <boost/function.hpp>
@@ -36,6 +40,8 @@
 #include <boost/bind.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/thread/barrier.hpp>
+#include <boost/thread/mutex.hpp>
+#include <complex>
 #include <iostream>
 #include <vector>
 
@@ -80,7 +86,16 @@ public:
      * \param size the number of transport channels
      */
     recv_packet_handler(const size_t size = 1):
+        _tick_rate(1.0), _samp_rate(1.0),
         _queue_error_for_next_call(false),
+        _max_samples_per_packet(0),
+        _nt_thresh(0),
+        _use_nt(false),
+        _host_correction(false),
+        _nco_enabled(false),
+        _resamp_out_offset(0),
+        _resamp_out_avail(0),
+        _resamp_time_count(0),
         _buffers_infos_index(0)
     {
         #ifdef  ERROR_INJECT_DROPPED_PACKETS
@@ -133,11 +148,13 @@ public:
     //! Set the rate of ticks per second
     void set_tick_rate(const double rate){
         _tick_rate = rate;
+        _samp_clock.set_rates(_tick_rate, _samp_rate);
     }
 
     //! Set the rate of samples per second
     void set_samp_rate(const double rate){
         _samp_rate = rate;
+        _samp_clock.set_rates(_tick_rate, _samp_rate);
     }
 
     /*!
@@ -175,10 +192,86 @@ public:
         if (do_init) handle_flowctrl(0);
     }
 
-    //! Set the conversion routine for all channels
-    void set_converter(const uhd::convert::id_type &id){
+    /*!
+     * Set the maximum number of samples per transport packet.
+     * This is the buffer size used when auto-tuning the converter.
+     * \param num_samps the maximum samples in a packet
+     */
+    void set_max_samples_per_packet(const size_t num_samps){
+        _max_samples_per_packet = num_samps;
+    }
+
+    /*!
+     * Set the conversion routine for all channels
+     * \param id identify the conversion
+     * \param args stream args with converter options
+     *        (convert_autotune, convert_nt, convert_nt_thresh, host_correction,
+     *        nco_freq, resamp_interp, resamp_decim)
+     */
+    void set_converter(const uhd::convert::id_type &id, const uhd::device_addr_t &args = uhd::device_addr_t()){
         _num_outputs = id.num_outputs;
-        _converter = uhd::convert::get_converter(id)();
+        uhd::convert::id_type conv_id = id;
+        _host_correction = args.cast<bool>("host_correction", false);
+        if (_host_correction) conv_id.output_format += "_corr";
+        const uhd::convert::function_type factory = args.cast<bool>("convert_autotune", false)?
+            uhd::convert::get_converter_tuned(conv_id, _max_samples_per_packet) :
+            uhd::convert::get_converter(conv_id);
+        //one converter per channel, so each can hold its own correction
+        _converters.resize(this->size());
+        for (size_t i = 0; i < _converters.size(); i++){
+            _converters[i] = factory();
+        }
+        _corrections = std::vector<correction_type>(this->size());
+        _corrections_pending.write(0);
+        //optional frequency shift, per channel overrides with nco_freq<N>
+        _ncos = std::vector<nco_mixer>(this->size());
+        _nco_freqs.assign(this->size(), args.cast<double>("nco_freq", 0.0));
+        _nco_enabled = false;
+        for (size_t i = 0; i < _nco_freqs.size(); i++){
+            _nco_freqs[i] = args.cast<double>(str(boost::format("nco_freq%u") % i), _nco_freqs[i]);
+            if (_nco_freqs[i] != 0.0) _nco_enabled = true;
+        }
+        if (_nco_enabled and (id.output_format != "fc32" or id.num_outputs != 1)){
+            throw uhd::value_error("the nco_freq stream arg requires the fc32 CPU format");
+        }
+        //optional rational resampling of the received samples
+        const size_t interp = args.cast<size_t>("resamp_interp", 1);
+        const size_t decim = args.cast<size_t>("resamp_decim", 1);
+        _resamplers.clear();
+        if (interp != decim){
+            if (id.output_format != "fc32" or id.num_outputs != 1){
+                throw uhd::value_error("resampling on the host requires the fc32 CPU format");
+            }
+            _resamplers.resize(this->size(), polyphase_resampler(
+                interp, decim, args.cast<size_t>("resamp_taps", 32)));
+            const size_t nsamps = (_max_samples_per_packet == 0)? 1024 : _max_samples_per_packet;
+            _resamp_in.assign(this->size(), std::vector<std::complex<float> >(nsamps));
+            _resamp_out.assign(this->size(), std::vector<std::complex<float> >(
+                _resamplers.front().get_max_output(nsamps)));
+            _resamp_in_buffs.resize(this->size());
+            for (size_t i = 0; i < this->size(); i++) _resamp_in_buffs[i] = &_resamp_in[i].front();
+            _resamp_out_offset = _resamp_out_avail = 0;
+        }
+        //optional non-temporal store converters for large buffers,
+        //not when the samples are processed again right after conversion
+        _nt_converters.clear();
+        _use_nt = false;
+        const std::string nt_mode = args.get("convert_nt", "auto");
+        _nt_thresh = (nt_mode == "auto")? args.cast<size_t>("convert_nt_thresh", 4*1024*1024) : 0;
+        if (nt_mode != "0" and not _host_correction and not _nco_enabled and _resamplers.empty()){
+            uhd::convert::id_type nt_id = id;
+            nt_id.output_format += "_nt";
+            try{
+                const uhd::convert::function_type nt_factory = uhd::convert::get_converter(nt_id);
+                _nt_converters.resize(this->size());
+                for (size_t i = 0; i < _nt_converters.size(); i++){
+                    _nt_converters[i] = nt_factory();
+                }
+            }
+            catch(const uhd::key_error &){
+                //no streaming converter for this format, use the regular one
+            }
+        }
         this->set_scale_factor(1/32767.); //update after setting converter
         _bytes_per_otw_item = uhd::convert::get_bytes_per_item(id.input_format);
         _bytes_per_cpu_item = uhd::convert::get_bytes_per_item(id.output_format);
@@ -191,7 +284,38 @@ public:
 
     //! Set the scale factor used in float conversion
     void set_scale_factor(const double scale_factor){
-        _converter->set_scalar(scale_factor);
+        BOOST_FOREACH(const uhd::convert::converter::sptr &converter, _converters){
+            converter->set_scalar(scale_factor);
+        }
+        BOOST_FOREACH(const uhd::convert::converter::sptr &converter, _nt_converters){
+            converter->set_scalar(scale_factor);
+        }
+    }
+
+    /*!
+     * Set the host-side correction for one channel.
+     * Safe to call while another thread is in recv(),
+     * the correction is applied at the start of the next recv().
+     * \param chan the channel index
+     * \param gain the complex gain
+     * \param dc_offset the DC offset to remove
+     * \param iq_balance the IQ balance correction
+     */
+    void set_host_correction(
+        const size_t chan,
+        const std::complex<double> &gain,
+        const std::complex<double> &dc_offset,
+        const std::complex<double> &iq_balance
+    ){
+        if (not _host_correction) throw uhd::not_implemented_error(
+            "set_host_correction() requires the host_correction stream arg");
+        boost::mutex::scoped_lock lock(_corrections_mutex);
+        correction_type &corr = _corrections.at(chan/_num_outputs);
+        corr.gain = gain;
+        corr.dc_offset = dc_offset;
+        corr.iq_balance = iq_balance;
+        corr.pending = true;
+        _corrections_pending.write(1);
     }
 
     //! Set the callback to issue stream commands
@@ -218,7 +342,7 @@ public:
     /*******************************************************************
      * Receive:
      * The entry point for the fast-path receive calls.
-     * Dispatch into combinations of single packet receive calls.
+     * Resample when enabled, otherwise receive directly.
      ******************************************************************/
     UHD_INLINE size_t recv(
         const uhd::rx_streamer::buffs_type &buffs,
@@ -227,6 +351,32 @@ public:
         const double timeout,
         const bool one_packet
     ){
+        if (_resamplers.empty()){
+            return recv_native(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+        }
+        return recv_resampled(buffs, nsamps_per_buff, metadata, timeout, one_packet);
+    }
+
+private:
+    /*******************************************************************
+     * Receive native:
+     * Receive samples at the device's rate.
+     * Dispatch into combinations of single packet receive calls.
+     ******************************************************************/
+    UHD_INLINE size_t recv_native(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double timeout,
+        const bool one_packet
+    ){
+        //apply corrections that were updated since the last receive
+        if (_corrections_pending.read()) this->apply_corrections();
+
+        //stream large buffers past the cache
+        _use_nt = not _nt_converters.empty() and
+            nsamps_per_buff*_num_outputs*_bytes_per_cpu_item >= _nt_thresh;
+
         //handle metadata queued from a previous receive
         if (_queue_error_for_next_call){
             _queue_error_for_next_call = false;
@@ -270,11 +420,92 @@ public:
         return accum_num_samps;
     }
 
-private:
+    /*******************************************************************
+     * Receive resampled:
+     * Receive one packet at a time into the input buffers,
+     * resample every channel and hand out the results.
+     * Results that do not fit are kept for the next call.
+     * The time spec is carried over from the packet's time spec
+     * and the resampler's position, including its group delay.
+     ******************************************************************/
+    UHD_INLINE size_t recv_resampled(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double timeout,
+        const bool one_packet
+    ){
+        const polyphase_resampler &resamp0 = _resamplers.front();
+        size_t accum_num_samps = 0;
+        while (accum_num_samps < nsamps_per_buff){
+
+            //resample the next packet when all results were handed out
+            if (_resamp_out_avail == 0){
+                if (accum_num_samps != 0 and one_packet) break;
+                const uhd::rx_streamer::buffs_type in_buffs(_resamp_in_buffs);
+                const size_t nsamps_in = recv_native(
+                    in_buffs, _resamp_in.front().size(), _resamp_md, timeout, true
+                );
+
+                if (_resamp_md.error_code != rx_metadata_t::ERROR_CODE_NONE){
+                    //restart the filters after a gap in the samples
+                    if (_resamp_md.error_code == rx_metadata_t::ERROR_CODE_OVERFLOW){
+                        BOOST_FOREACH(polyphase_resampler &resamp, _resamplers) resamp.reset();
+                    }
+                    if (accum_num_samps == 0){
+                        metadata = _resamp_md;
+                        return 0;
+                    }
+                    //report on the next call, like the native receive
+                    _queue_metadata = _resamp_md;
+                    _queue_error_for_next_call = true;
+                    break;
+                }
+
+                if (_resamp_md.has_time_spec){
+                    _resamp_time = _resamp_md.time_spec + time_spec_t(
+                        resamp0.get_next_output_offset()/_samp_rate);
+                    _resamp_time_count = 0;
+                }
+                for (size_t i = 0; i < _resamplers.size(); i++){
+                    _resamp_out_avail = _resamplers[i].process(
+                        &_resamp_in[i].front(), nsamps_in, &_resamp_out[i].front());
+                }
+                _resamp_out_offset = 0;
+                if (_resamp_out_avail == 0) continue;
+            }
+
+            const size_t nsamps = std::min(nsamps_per_buff - accum_num_samps, _resamp_out_avail);
+            for (size_t i = 0; i < _resamplers.size(); i++){
+                const std::complex<float> *src = &_resamp_out[i][_resamp_out_offset];
+                std::copy(src, src + nsamps,
+                    reinterpret_cast<std::complex<float> *>(buffs[i]) + accum_num_samps);
+            }
+
+            if (accum_num_samps == 0){
+                metadata = _resamp_md;
+                metadata.time_spec = _resamp_time + time_spec_t::from_ticks(
+                    _resamp_time_count*resamp0.get_decim(), _samp_rate*resamp0.get_interp());
+                metadata.start_of_burst = _resamp_md.start_of_burst and _resamp_out_offset == 0;
+                metadata.more_fragments = false;
+                metadata.fragment_offset = 0;
+            }
+            _resamp_out_offset += nsamps;
+            _resamp_out_avail -= nsamps;
+            _resamp_time_count += nsamps;
+            accum_num_samps += nsamps;
+            metadata.end_of_burst = _resamp_md.end_of_burst and _resamp_out_avail == 0;
+            if (one_packet and _resamp_out_avail == 0) break;
+        }
+        return accum_num_samps;
+    }
+
     vrt_unpacker_type _vrt_unpacker;
     size_t _header_offset_words32;
     double _tick_rate, _samp_rate;
+    samp_clock _samp_clock;
     bool _queue_error_for_next_call;
+    size_t _max_samples_per_packet;
     size_t _alignment_failure_threshold;
     rx_metadata_t _queue_metadata;
     struct xport_chan_props_type{
@@ -294,7 +525,48 @@ private:
     size_t _num_outputs;
     size_t _bytes_per_otw_item; //used in conversion
     size_t _bytes_per_cpu_item; //used in conversion
-    uhd::convert::converter::sptr _converter; //used in conversion
+    std::vector<uhd::convert::converter::sptr> _converters; //used in conversion, one per channel
+    std::vector<uhd::convert::converter::sptr> _nt_converters; //non-temporal stores, may be empty
+    size_t _nt_thresh; //buffer size in bytes from which the non-temporal converters are used
+    bool _use_nt; //set per recv call
+
+    //! host-side correction state per channel, handed to the converters by recv()
+    struct correction_type{
+        correction_type(void):
+            gain(1.0), dc_offset(0.0), iq_balance(0.0), pending(false)
+        {}
+        std::complex<double> gain, dc_offset, iq_balance;
+        bool pending;
+    };
+    bool _host_correction;
+    std::vector<correction_type> _corrections;
+    boost::mutex _corrections_mutex;
+    uhd::atomic_uint32_t _corrections_pending;
+
+    void apply_corrections(void){
+        boost::mutex::scoped_lock lock(_corrections_mutex);
+        for (size_t i = 0; i < _corrections.size(); i++){
+            correction_type &corr = _corrections[i];
+            if (not corr.pending) continue;
+            _converters[i]->set_correction(corr.gain, corr.dc_offset, corr.iq_balance);
+            corr.pending = false;
+        }
+        _corrections_pending.write(0);
+    }
+
+    //! host-side frequency shift state per channel
+    bool _nco_enabled;
+    std::vector<double> _nco_freqs;
+    std::vector<nco_mixer> _ncos;
+
+    //! host-side resampling state, one resampler per channel
+    std::vector<polyphase_resampler> _resamplers;
+    std::vector<std::vector<std::complex<float> > > _resamp_in, _resamp_out;
+    std::vector<void *> _resamp_in_buffs;
+    size_t _resamp_out_offset, _resamp_out_avail;
+    rx_metadata_t _resamp_md; //metadata of the packet being handed out
+    time_spec_t _resamp_time; //time of the output sample at _resamp_time_count zero
+    long long _resamp_time_count;
 
     //! information stored for a received buffer
     struct per_buffer_info_type{
@@ -302,13 +574,13 @@ private:
         {
             buff.reset();
             vrt_hdr = NULL;
-            time = time_spec_t(0.0);
+            time = tick_time();
             copy_buff = NULL;
         }
         managed_recv_buffer::sptr buff;
         const boost::uint32_t *vrt_hdr;
         vrt::if_packet_info_t ifpi;
-        time_spec_t time;
+        tick_time time;
         const char *copy_buff;
     };
 
@@ -324,7 +596,7 @@ private:
         void reset()
         {
             indexes_todo.set();
-            alignment_time = time_spec_t(0.0);
+            alignment_time = tick_time();
             alignment_time_valid = false;
             data_bytes_to_copy = 0;
             fragment_offset_in_samps = 0;
@@ -333,7 +605,7 @@ private:
                 at(i).reset();
         }
         boost::dynamic_bitset<> indexes_todo; //used in alignment logic
-        time_spec_t alignment_time; //used in alignment logic
+        tick_time alignment_time; //used in alignment logic
         bool alignment_time_valid; //used in alignment logic
         size_t data_bytes_to_copy; //keeps track of state
         size_t fragment_offset_in_samps; //keeps track of state
@@ -399,7 +671,7 @@ private:
         info.ifpi.num_packet_words32 = num_packet_words32 - _header_offset_words32;
         info.vrt_hdr = buff->cast<const boost::uint32_t *>() + _header_offset_words32;
         _vrt_unpacker(info.vrt_hdr, info.ifpi);
-        info.time = time_spec_t::from_ticks(info.ifpi.tsf, _tick_rate); //assumes has_tsf is true
+        info.time = tick_time(info.ifpi.tsf, _tick_rate); //assumes has_tsf is true
         info.copy_buff = reinterpret_cast<const char *>(info.vrt_hdr + info.ifpi.num_header_words32);
 
         //handle flow control
@@ -559,7 +831,7 @@ private:
             case PACKET_INLINE_MESSAGE:
                 std::swap(curr_info, next_info); //save progress from curr -> next
                 curr_info.metadata.has_time_spec = next_info[index].ifpi.has_tsf;
-                curr_info.metadata.time_spec = next_info[index].time;
+                curr_info.metadata.time_spec = next_info[index].time.to_time_spec();
                 curr_info.metadata.error_code = rx_metadata_t::error_code_t(get_context_code(next_info[index].vrt_hdr, next_info[index].ifpi));
                 if (curr_info.metadata.error_code == rx_metadata_t::ERROR_CODE_OVERFLOW){
                     rx_metadata_t metadata = curr_info.metadata;
@@ -583,8 +855,8 @@ private:
                 alignment_check(index, curr_info);
                 std::swap(curr_info, next_info); //save progress from curr -> next
                 curr_info.metadata.has_time_spec = prev_info.metadata.has_time_spec;
-                curr_info.metadata.time_spec = prev_info.metadata.time_spec + time_spec_t::from_ticks(
-                    prev_info[index].ifpi.num_payload_words32*sizeof(boost::uint32_t)/_bytes_per_otw_item, _samp_rate);
+                curr_info.metadata.time_spec = _samp_clock.offset_time_spec(prev_info[0].time,
+                    prev_info[index].ifpi.num_payload_words32*sizeof(boost::uint32_t)/_bytes_per_otw_item);
                 curr_info.metadata.out_of_sequence = true;
                 curr_info.metadata.error_code = rx_metadata_t::ERROR_CODE_OVERFLOW;
                 UHD_MSG(fastpath) << "D";
@@ -608,8 +880,8 @@ private:
         }
 
         //set the metadata from the buffer information at index zero
+        //the time spec is made from the tick time when handed out
         curr_info.metadata.has_time_spec = curr_info[0].ifpi.has_tsf;
-        curr_info.metadata.time_spec = curr_info[0].time;
         curr_info.metadata.more_fragments = false;
         curr_info.metadata.fragment_offset = 0;
         curr_info.metadata.start_of_burst = curr_info[0].ifpi.sob;
@@ -641,8 +913,10 @@ private:
         buffers_info_type &info = get_curr_buffer_info();
         metadata = info.metadata;
 
-        //interpolate the time spec (useful when this is a fragment)
-        metadata.time_spec += time_spec_t::from_ticks(info.fragment_offset_in_samps, _samp_rate);
+        //time of the first sample handed out (useful when this is a fragment)
+        if (metadata.error_code == rx_metadata_t::ERROR_CODE_NONE){
+            metadata.time_spec = _samp_clock.offset_time_spec(info[0].time, info.fragment_offset_in_samps);
+        }
 
         //extract the number of samples available to copy
         const size_t nsamps_available = info.data_bytes_to_copy/_bytes_per_otw_item;
@@ -693,7 +967,19 @@ private:
         const ref_vector<void *> out_buffs(io_buffs, _num_outputs);
 
         //perform the conversion operation
-        _converter->conv(info.copy_buff, out_buffs, _convert_nsamps);
+        const uhd::convert::converter::sptr &converter = _use_nt?
+            _nt_converters[index] : _converters[index];
+        converter->conv(info.copy_buff, out_buffs, _convert_nsamps);
+
+        //frequency shift in place while the samples are still in cache
+        if (_nco_enabled and _nco_freqs[index] != 0.0){
+            nco_mixer &nco = _ncos[index];
+            if (info.ifpi.has_tsf) nco.set_phase_at(_samp_clock.offset_time_spec(
+                info.time, buff_info.fragment_offset_in_samps), _nco_freqs[index]);
+            nco.set_freq(_nco_freqs[index]/_samp_rate);
+            std::complex<float> *samps = reinterpret_cast<std::complex<float> *>(io_buffs[0]);
+            nco.mix(samps, samps, _convert_nsamps);
+        }
 
         //advance the pointer for the source buffer
         info.copy_buff += _convert_bytes_to_copy;
@@ -779,6 +1065,7 @@ class recv_packet_streamer : public recv_packet_handler, public rx_streamer{
 public:
     recv_packet_streamer(const size_t max_num_samps){
         _max_num_samps = max_num_samps;
+        this->set_max_samples_per_packet(_max_num_samps);
     }
 
     size_t get_num_channels(void) const{
@@ -804,6 +1091,15 @@ public:
         return recv_packet_handler::issue_stream_cmd(stream_cmd);
     }
 
+    void set_host_correction(
+        const size_t chan,
+        const std::complex<double> &gain,
+        const std::complex<double> &dc_offset,
+        const std::complex<double> &iq_balance
+    ){
+        return recv_packet_handler::set_host_correction(chan, gain, dc_offset, iq_balance);
+    }
+
 private:
     size_t _max_num_samps;
 };
@@ -22,6 +22,7 @@
 #include <uhd/exception.hpp>
 #include <uhd/convert.hpp>
 #include <uhd/stream.hpp>
+#include <uhd/types/device_addr.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/tasks.hpp>
 #include <uhd/utils/atomic.hpp>
@@ -29,9 +30,13 @@
 #include <uhd/types/metadata.hpp>
 #include <uhd/transport/vrt_if_packet.hpp>
 #include <uhd/transport/zero_copy.hpp>
+#include "nco_mixer.hpp"
+#include "tick_time.hpp"
 #include <boost/thread/thread_time.hpp>
 #include <boost/foreach.hpp>
 #include <boost/function.hpp>
+#include <boost/format.hpp>
+#include <complex>
 #include <iostream>
 #include <vector>
 
@@ -67,7 +72,8 @@ public:
      * \param size the number of transport channels
      */
     send_packet_handler(const size_t size = 1):
-        _next_packet_seq(0), _cached_metadata(false)
+        _tick_rate(1.0), _samp_rate(1.0),
+        _nco_enabled(false), _next_packet_seq(0), _cached_metadata(false)
     {
         this->set_enable_trailer(true);
         this->resize(size);
@@ -117,11 +123,13 @@ public:
     //! Set the rate of ticks per second
     void set_tick_rate(const double rate){
         _tick_rate = rate;
+        _samp_clock.set_rates(_tick_rate, _samp_rate);
     }
 
     //! Set the rate of samples per second
     void set_samp_rate(const double rate){
         _samp_rate = rate;
+        _samp_clock.set_rates(_tick_rate, _samp_rate);
     }
 
     /*!
@@ -133,10 +141,31 @@ public:
         _props.at(xport_chan).get_buff = get_buff;
     }
 
-    //! Set the conversion routine for all channels
-    void set_converter(const uhd::convert::id_type &id){
+    /*!
+     * Set the conversion routine for all channels
+     * \param id identify the conversion
+     * \param args stream args with converter options (convert_autotune, nco_freq)
+     */
+    void set_converter(const uhd::convert::id_type &id, const uhd::device_addr_t &args = uhd::device_addr_t()){
         _num_inputs = id.num_inputs;
-        _converter = uhd::convert::get_converter(id)();
+        //optional frequency shift, per channel overrides with nco_freq<N>
+        _ncos = std::vector<nco_mixer>(this->size());
+        _nco_buffs.resize(this->size());
+        _nco_freqs.assign(this->size(), args.cast<double>("nco_freq", 0.0));
+        _nco_enabled = false;
+        for (size_t i = 0; i < _nco_freqs.size(); i++){
+            _nco_freqs[i] = args.cast<double>(str(boost::format("nco_freq%u") % i), _nco_freqs[i]);
+            if (_nco_freqs[i] != 0.0) _nco_enabled = true;
+        }
+        if (_nco_enabled and (id.input_format != "fc32" or id.num_inputs != 1)){
+            throw uhd::value_error("the nco_freq stream arg requires the fc32 CPU format");
+        }
+        if (args.cast<bool>("convert_autotune", false)){
+            _converter = uhd::convert::get_converter_tuned(id, _max_samples_per_packet)();
+        }
+        else{
+            _converter = uhd::convert::get_converter(id)();
+        }
         this->set_scale_factor(32767.); //update after setting converter
         _bytes_per_otw_item = uhd::convert::get_bytes_per_item(id.output_format);
         _bytes_per_cpu_item = uhd::convert::get_bytes_per_item(id.input_format);
@@ -240,6 +269,7 @@ public:
 #endif
 			return nsamps_sent;        }
         size_t total_num_samps_sent = 0;
+        const tick_time start_time(if_packet_info.tsf, _tick_rate);
 
         //false until final fragment
         if_packet_info.eob = false;
@@ -260,8 +290,7 @@ public:
             if (num_samps_sent == 0) return total_num_samps_sent;
 
             //setup metadata for the next fragment
-            const time_spec_t time_spec = metadata.time_spec + time_spec_t::from_ticks(total_num_samps_sent, _samp_rate);
-            if_packet_info.tsf = time_spec.to_ticks(_tick_rate);
+            if_packet_info.tsf = _samp_clock.offset(start_time, total_num_samps_sent).get_ticks();
             if_packet_info.sob = false;
 
         }
@@ -283,6 +312,7 @@ private:
     vrt_packer_type _vrt_packer;
     size_t _header_offset_words32;
     double _tick_rate, _samp_rate;
+    samp_clock _samp_clock;
     struct xport_chan_props_type{
         xport_chan_props_type(void):has_sid(false),sid(0){}
         get_buff_type get_buff;
@@ -295,6 +325,10 @@ private:
     size_t _bytes_per_otw_item; //used in conversion
     size_t _bytes_per_cpu_item; //used in conversion
     uhd::convert::converter::sptr _converter; //used in conversion
+    bool _nco_enabled; //host-side frequency shift
+    std::vector<double> _nco_freqs;
+    std::vector<nco_mixer> _ncos;
+    std::vector<std::vector<std::complex<float> > > _nco_buffs;
     size_t _max_samples_per_packet;
     std::vector<const void *> _zero_buffs;
     size_t _next_packet_seq;
@@ -412,6 +446,18 @@ private:
         _vrt_packer(otw_mem, if_packet_info);
         otw_mem += if_packet_info.num_header_words32;
 
+        //frequency shift into a per channel scratch buffer ahead of the conversion
+        if (_nco_enabled and _nco_freqs[index] != 0.0){
+            nco_mixer &nco = _ncos[index];
+            if (if_packet_info.has_tsf) nco.set_phase_at(time_spec_t::from_ticks(
+                if_packet_info.tsf, _tick_rate), _nco_freqs[index]);
+            nco.set_freq(_nco_freqs[index]/_samp_rate);
+            std::vector<std::complex<float> > &scratch = _nco_buffs[index];
+            if (scratch.size() < _convert_nsamps) scratch.resize(_convert_nsamps);
+            nco.mix(reinterpret_cast<const std::complex<float> *>(io_buffs[0]), &scratch.front(), _convert_nsamps);
+            io_buffs[0] = &scratch.front();
+        }
+
         //perform the conversion operation
         _converter->conv(in_buffs, otw_mem, _convert_nsamps);
 
@@ -0,0 +1,113 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_TICK_TIME_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_TICK_TIME_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <boost/math/special_functions/round.hpp>
+#include <cmath>
+
+namespace uhd{ namespace transport{ namespace sph{
+
+/***********************************************************************
+ * Tick time:
+ * A timestamp in the device tick domain, integer ticks at a tick rate.
+ * The packet handlers keep timestamps in this form and only make
+ * a time_spec_t when the time is handed to the user.
+ **********************************************************************/
+class tick_time{
+public:
+    tick_time(void): _ticks(0), _tick_rate(1.0){}
+
+    tick_time(const long long ticks, const double tick_rate):
+        _ticks(ticks), _tick_rate(tick_rate){}
+
+    static tick_time from_time_spec(const time_spec_t &time, const double tick_rate){
+        return tick_time(time.to_ticks(tick_rate), tick_rate);
+    }
+
+    long long get_ticks(void) const{return _ticks;}
+    double get_tick_rate(void) const{return _tick_rate;}
+
+    time_spec_t to_time_spec(void) const{
+        return time_spec_t::from_ticks(_ticks, _tick_rate);
+    }
+
+    tick_time &operator+=(const long long ticks){
+        _ticks += ticks;
+        return *this;
+    }
+
+    tick_time operator+(const long long ticks) const{
+        return tick_time(_ticks + ticks, _tick_rate);
+    }
+
+    //comparisons assume both sides use the same tick rate
+    bool operator==(const tick_time &rhs) const{return _ticks == rhs._ticks;}
+    bool operator!=(const tick_time &rhs) const{return _ticks != rhs._ticks;}
+    bool operator<(const tick_time &rhs) const{return _ticks < rhs._ticks;}
+    bool operator>(const tick_time &rhs) const{return _ticks > rhs._ticks;}
+
+private:
+    long long _ticks;
+    double _tick_rate;
+};
+
+/***********************************************************************
+ * Sample clock:
+ * Offsets a tick time by a number of samples.
+ * When the tick rate is a whole multiple of the sample rate (the usual
+ * case, the ratio is the decimation or interpolation) this is an
+ * integer multiply. Other ratios fall back to time_spec_t arithmetic.
+ **********************************************************************/
+class samp_clock{
+public:
+    samp_clock(void): _tick_rate(1.0), _samp_rate(1.0), _ticks_per_samp(1){}
+
+    void set_rates(const double tick_rate, const double samp_rate){
+        _tick_rate = tick_rate;
+        _samp_rate = samp_rate;
+        _ticks_per_samp = 0;
+        const double ratio = tick_rate/samp_rate;
+        if (not (ratio >= 1.0 and ratio < 1e9)) return; //also rejects NaN
+        const long long whole = boost::math::llround(ratio);
+        if (std::abs(ratio - whole) < ratio*1e-9) _ticks_per_samp = whole;
+    }
+
+    //! The tick time of the sample nsamps after time
+    UHD_INLINE tick_time offset(const tick_time &time, const size_t nsamps) const{
+        if (_ticks_per_samp != 0) return time + (long long)(nsamps)*_ticks_per_samp;
+        return tick_time::from_time_spec(
+            this->offset_time_spec(time, nsamps), _tick_rate);
+    }
+
+    //! The time of the sample nsamps after time, exact for any ratio
+    UHD_INLINE time_spec_t offset_time_spec(const tick_time &time, const size_t nsamps) const{
+        if (_ticks_per_samp != 0) return (time + (long long)(nsamps)*_ticks_per_samp).to_time_spec();
+        return time.to_time_spec() + time_spec_t::from_ticks(nsamps, _samp_rate);
+    }
+
+private:
+    double _tick_rate, _samp_rate;
+    long long _ticks_per_samp; //zero when the ratio is not whole
+};
+
+}}} //namespace uhd::transport::sph
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_TICK_TIME_HPP */
@@ -45,6 +45,24 @@ boost::uint32_t wb_iface::peek32(const wb_iface::wb_addr_type)
     throw uhd::not_implemented_error("peek32 not implemented");
 }
 
+void wb_iface::poke32_batch(const wb_iface::poke32_batch_type &pokes)
+{
+    for (size_t i = 0; i < pokes.size(); i++)
+    {
+        this->poke32(pokes[i].first, pokes[i].second);
+    }
+}
+
+std::vector<boost::uint32_t> wb_iface::peek32_batch(const std::vector<wb_iface::wb_addr_type> &addrs)
+{
+    std::vector<boost::uint32_t> data(addrs.size());
+    for (size_t i = 0; i < addrs.size(); i++)
+    {
+        data[i] = this->peek32(addrs[i]);
+    }
+    return data;
+}
+
 void wb_iface::poke16(const wb_iface::wb_addr_type, const boost::uint16_t)
 {
     throw uhd::not_implemented_error("poke16 not implemented");
@@ -557,7 +557,9 @@ b200_impl::b200_impl(const uhd::device_addr_t& device_addr, usb_device_handle::s
     } else {
         client_settings = boost::make_shared<b200_ad9361_client_t>();
     }
-    _codec_ctrl = ad9361_ctrl::make_spi(client_settings, _spi_iface, AD9361_SLAVENO);
+    //the codec_cal_cache arg restores filter calibrations cached for this serial
+    const std::string cal_cache_serial = device_addr.has_key("codec_cal_cache")? handle->get_serial() : "";
+    _codec_ctrl = ad9361_ctrl::make_spi(client_settings, _spi_iface, AD9361_SLAVENO, cal_cache_serial);
 
     ////////////////////////////////////////////////////////////////////
     // create codec control objects
@@ -579,7 +581,8 @@ b200_impl::b200_impl(const uhd::device_addr_t& device_addr, usb_device_handle::s
     _tree->create<double>(mb_path / "tick_rate")
         .set_coercer(boost::bind(&b200_impl::set_tick_rate, this, _1))
         .set_publisher(boost::bind(&b200_impl::get_tick_rate, this))
-        .add_coerced_subscriber(boost::bind(&b200_impl::update_tick_rate, this, _1));
+        .add_coerced_subscriber(boost::bind(&b200_impl::update_tick_rate, this, _1))
+        .add_coerced_subscriber(boost::bind(&radio_ctrl_core_3000::set_tick_rate, _local_ctrl, _1)); //for timed fast lock recalls
     _tree->create<time_spec_t>(mb_path / "time" / "cmd");
     _tree->create<bool>(mb_path / "auto_tick_rate").set(false);
 
@@ -827,6 +830,9 @@ void b200_impl::setup_radio(const size_t dspno)
         _tree->access<double>(rf_fe_path / "freq" / "value")
             .add_coerced_subscriber(boost::bind(&b200_impl::update_bandsel, this, key, _1))
         ;
+        _tree->create<size_t>(rf_fe_path / "freq" / "fast_lock" / "recall")
+            .add_coerced_subscriber(boost::bind(&b200_impl::recall_fast_lock_profile, this, key, _1))
+        ;
         if (dir == RX_DIRECTION)
         {
             static const std::vector<std::string> ants = boost::assign::list_of("TX/RX")("RX2");
@@ -1079,6 +1085,26 @@ void b200_impl::sync_times()
  * GPIO setup
  **********************************************************************/
 
+void b200_impl::recall_fast_lock_profile(const std::string& which, const size_t profile)
+{
+    //The codec and the band selection are both on the local control core.
+    //Issue them at the command time, so hops can be scheduled ahead.
+    //The recall only writes registers, so nothing waits for that time.
+    //The time is held for this thread only, accesses from other threads
+    //(sensors, GPIO, codec calls) stay untimed.
+    property<time_spec_t> &cmd_time = _tree->access<time_spec_t>("/mboards/0/time/cmd");
+    const time_spec_t t = cmd_time.empty() ? time_spec_t(0.0) : cmd_time.get();
+    _local_ctrl->hold_time(t);
+    try {
+        const double freq = _codec_ctrl->recall_fast_lock_profile(which, profile);
+        update_bandsel(which, freq);
+    } catch (...) {
+        _local_ctrl->release_time();
+        throw;
+    }
+    _local_ctrl->release_time();
+}
+
 void b200_impl::update_bandsel(const std::string& which, double freq)
 {
     // B205 does not have bandsels
@@ -172,6 +172,7 @@ private:
     void sync_times(void);
     void update_clock_source(const std::string &);
     void update_bandsel(const std::string& which, double freq);
+    void recall_fast_lock_profile(const std::string& which, const size_t profile);
     void update_antenna_sel(const size_t which, const std::string &ant);
     uhd::sensor_value_t get_ref_locked(void);
     uhd::sensor_value_t get_fe_pll_locked(const bool is_tx);
@@ -19,12 +19,20 @@
 #include <uhd/types/ranges.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/types/serial.hpp>
+#include <uhd/utils/csv.hpp>
+#include <uhd/utils/paths.hpp>
+#include <uhd/version.hpp>
 #include <cstring>
+#include <fstream>
+#include <map>
 #include <boost/format.hpp>
 #include <boost/utility.hpp>
 #include <boost/function.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/thread.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
 
 using namespace uhd;
 using namespace uhd::usrp;
@@ -86,18 +94,100 @@ private:
     static const boost::uint32_t AD9361_SPI_NUM_BITS   = 24;
 };
 
+/***********************************************************************
+ * AD9361 Calibration Cache
+ **********************************************************************/
+
+/*!
+ * Persists the calibration results of one AD9361 in the UHD app path.
+ * Rows are: version, key, then reg=value for every result register.
+ * New results are appended, so the last row of a key wins.
+ */
+class ad9361_file_cal_cache : public ad9361_device_t::cal_cache_t
+{
+public:
+    ad9361_file_cal_cache(const std::string &serial):
+        _path(boost::filesystem::path(uhd::get_app_path())
+            / ".uhd" / "cal" / ("ad9361_cal_" + serial + ".csv"))
+    {
+        std::ifstream cache_file(_path.string().c_str());
+        if (not cache_file.good()) return;
+        const uhd::csv::rows_type rows = uhd::csv::to_rows(cache_file);
+        BOOST_FOREACH(const uhd::csv::row_type &row, rows){
+            if (row.size() < 3 or row[0] != uhd::get_version_string()) continue;
+            results_t results;
+            try{
+                for (size_t i = 2; i < row.size(); i++){
+                    const size_t eq = row[i].find('=');
+                    if (eq == std::string::npos) throw boost::bad_lexical_cast();
+                    results.push_back(std::make_pair(
+                        boost::uint16_t(boost::lexical_cast<unsigned>(row[i].substr(0, eq))),
+                        boost::uint8_t(boost::lexical_cast<unsigned>(row[i].substr(eq + 1)))));
+                }
+            }
+            catch(const boost::bad_lexical_cast &){
+                continue;
+            }
+            _results[row[1]] = results;
+        }
+    }
+
+    bool get(const std::string &key, results_t &results)
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        std::map<std::string, results_t>::const_iterator it = _results.find(key);
+        if (it == _results.end()) return false;
+        results = it->second;
+        return true;
+    }
+
+    void put(const std::string &key, const results_t &results)
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        _results[key] = results;
+        try{
+            boost::filesystem::create_directories(_path.parent_path());
+            std::ofstream cache_file(_path.string().c_str(), std::ios::app);
+            cache_file << uhd::get_version_string() << "," << key;
+            for (size_t i = 0; i < results.size(); i++){
+                cache_file << "," << unsigned(results[i].first) << "=" << unsigned(results[i].second);
+            }
+            cache_file << std::endl;
+        }
+        catch(const std::exception &e){
+            UHD_MSG(warning) << "Could not store AD9361 calibration: " << e.what() << std::endl;
+        }
+    }
+
+private:
+    const boost::filesystem::path _path;
+    std::map<std::string, results_t> _results;
+    boost::mutex _mutex;
+};
+
 /***********************************************************************
  * AD9361 Control API Class
  **********************************************************************/
 class ad9361_ctrl_impl : public ad9361_ctrl
 {
 public:
-    ad9361_ctrl_impl(ad9361_params::sptr client_settings, ad9361_io::sptr io_iface):
+    ad9361_ctrl_impl(
+        ad9361_params::sptr client_settings,
+        ad9361_io::sptr io_iface,
+        ad9361_device_t::cal_cache_t::sptr cal_cache
+    ):
         _device(client_settings, io_iface)
     {
+        _device.set_cal_cache(cal_cache);
         _device.initialize();
     }
 
+    ad9361_device_t::init_timing_t get_init_timing(void)
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        return _device.get_init_timing();
+    }
+
     double set_gain(const std::string &which, const double value)
     {
         boost::lock_guard<boost::mutex> lock(_mutex);
@@ -169,6 +259,27 @@ public:
         return _device.tune(direction, value);
     }
 
+    //! store the LO settings for a frequency in a fast lock profile
+    double store_fast_lock_profile(const std::string &which, const size_t profile, const double freq)
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+
+        //clip to known bounds
+        const double value = ad9361_ctrl::get_rf_freq_range().clip(freq);
+
+        ad9361_device_t::direction_t direction = _get_direction_from_antenna(which);
+        return _device.store_fast_lock_profile(direction, profile, value);
+    }
+
+    //! switch the LO to a stored fast lock profile
+    double recall_fast_lock_profile(const std::string &which, const size_t profile)
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+
+        ad9361_device_t::direction_t direction = _get_direction_from_antenna(which);
+        return _device.recall_fast_lock_profile(direction, profile);
+    }
+
     //! get the current frequency for the given frontend
     double get_freq(const std::string &which)
     {
@@ -291,8 +402,13 @@ private:
 // Make an instance of the AD9361 Control interface
 //----------------------------------------------------------------------
 ad9361_ctrl::sptr ad9361_ctrl::make_spi(
-    ad9361_params::sptr client_settings, uhd::spi_iface::sptr spi_iface, boost::uint32_t slave_num)
+    ad9361_params::sptr client_settings, uhd::spi_iface::sptr spi_iface, boost::uint32_t slave_num,
+    const std::string &cal_cache_serial)
 {
     boost::shared_ptr<ad9361_io_spi> spi_io_iface = boost::make_shared<ad9361_io_spi>(spi_iface, slave_num);
-    return sptr(new ad9361_ctrl_impl(client_settings, spi_io_iface));
+    ad9361_device_t::cal_cache_t::sptr cal_cache;
+    if (not cal_cache_serial.empty()) {
+        cal_cache = boost::make_shared<ad9361_file_cal_cache>(cal_cache_serial);
+    }
+    return sptr(new ad9361_ctrl_impl(client_settings, spi_io_iface, cal_cache));
 }
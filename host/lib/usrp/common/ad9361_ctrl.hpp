@@ -54,9 +54,18 @@ public:
 
     virtual ~ad9361_ctrl(void) {};
 
-    //! make a new codec control object
+    /*!
+     * Make a new codec control object
+     *
+     * When a serial is given, the filter calibrations are cached in a file
+     * for this serial and restored on later runs at the same conditions.
+     */
     static sptr make_spi(
-        ad9361_params::sptr client_settings, uhd::spi_iface::sptr spi_iface, boost::uint32_t slave_num);
+        ad9361_params::sptr client_settings, uhd::spi_iface::sptr spi_iface, boost::uint32_t slave_num,
+        const std::string &cal_cache_serial = "");
+
+    //! Get the duration of each initialization phase in seconds
+    virtual ad9361_device_t::init_timing_t get_init_timing(void) = 0;
 
     //! Get a list of gain names for RX or TX
     static std::vector<std::string> get_gain_names(const std::string &/*which*/)
@@ -116,6 +125,18 @@ public:
     //! tune the given frontend, return the exact value
     virtual double tune(const std::string &which, const double value) = 0;
 
+    //! get the number of fast lock profiles per direction
+    static size_t get_num_fast_lock_profiles(void)
+    {
+        return ad9361_device_t::AD9361_NUM_FAST_LOCK_PROFILES;
+    }
+
+    //! store the LO settings for a frequency in a fast lock profile, return the exact value
+    virtual double store_fast_lock_profile(const std::string &which, const size_t profile, const double value) = 0;
+
+    //! switch the LO to a stored fast lock profile without calibration, return the exact value
+    virtual double recall_fast_lock_profile(const std::string &which, const size_t profile) = 0;
+
     //! set the DC offset for I and Q manually
     void set_dc_offset(const std::string &, const std::complex<double>)
     {
@@ -22,6 +22,7 @@
 #include "ad9361_device.h"
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <limits>
 #include <uhd/exception.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/msg.hpp>
@@ -101,6 +102,28 @@ const double ad9361_device_t::AD9361_RECOMMENDED_MAX_BANDWIDTH = 56e6;
 const double ad9361_device_t::DEFAULT_RX_FREQ = 800e6;
 const double ad9361_device_t::DEFAULT_TX_FREQ = 850e6;
 
+/* The AD9361 stores 8 fast lock profiles per direction. */
+const size_t ad9361_device_t::AD9361_NUM_FAST_LOCK_PROFILES = 8;
+
+/* Cached calibrations are only restored within the same temperature band, in degrees C. */
+const double ad9361_device_t::AD9361_CAL_CACHE_TEMP_BAND = 10.0;
+
+/* Registers holding the results of the filter calibrations. */
+static const boost::uint16_t rx_bbf_cal_regs[] = {
+    0x1e0, 0x1e1,               // RX1/RX2 BBF R1A
+    0x1e4, 0x1e5,               // RX1/RX2 BBF R5
+    0x1e6,                      // BBF R2346
+    0x1e7, 0x1e8, 0x1e9,        // BBF C1 and C2
+    0x1ea, 0x1eb, 0x1ec         // BBF C2 and C3
+};
+static const boost::uint16_t tx_bbf_cal_regs[] = {
+    0x0c2, 0x0c3, 0x0c4, 0x0c5, // BBF R1 to R4
+    0x0c6, 0x0c7, 0x0c8, 0x0c9  // BBF RP, C1, C2, CP
+};
+static const boost::uint16_t rx_tia_cal_regs[] = {
+    0x1db, 0x1dc, 0x1dd, 0x1de, 0x1df
+};
+
 /* Program either the RX or TX FIR filter.
  *
  * The process is the same for both filters, but the function must be told
@@ -353,20 +376,25 @@ double ad9361_device_t::_calibrate_baseband_rx_analog_filter(double req_rfbw)
     _io_iface->poke8(0x1d5, 0x3f);
     _io_iface->poke8(0x1c0, 0x03);
 
-    /* Enable RX1 & RX2 filter tuners. */
-    _io_iface->poke8(0x1e2, 0x02);
-    _io_iface->poke8(0x1e3, 0x02);
-
-    /* Run the calibration! */
-    size_t count = 0;
-    _io_iface->poke8(0x016, 0x80);
-    while (_io_iface->peek8(0x016) & 0x80) {
-        if (count > 100) {
-            throw uhd::runtime_error("[ad9361_device_t] RX baseband filter cal FAILURE");
-            break;
+    const std::string cache_key = _get_cal_cache_key("rx_bbf", bbbw);
+    if (not _restore_cal_results(cache_key)) {
+        /* Enable RX1 & RX2 filter tuners. */
+        _io_iface->poke8(0x1e2, 0x02);
+        _io_iface->poke8(0x1e3, 0x02);
+
+        /* Run the calibration! */
+        size_t count = 0;
+        _io_iface->poke8(0x016, 0x80);
+        while (_io_iface->peek8(0x016) & 0x80) {
+            if (count > 100) {
+                throw uhd::runtime_error("[ad9361_device_t] RX baseband filter cal FAILURE");
+                break;
+            }
+            count++;
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
         }
-        count++;
-        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+
+        _store_cal_results(cache_key, rx_bbf_cal_regs, sizeof(rx_bbf_cal_regs)/sizeof(rx_bbf_cal_regs[0]));
     }
 
     /* Disable RX1 & RX2 filter tuners. */
@@ -410,20 +438,25 @@ double ad9361_device_t::_calibrate_baseband_tx_analog_filter(double req_rfbw)
     _io_iface->poke8(0x0d6, (txbbfdiv & 0x00FF));
     _io_iface->poke8(0x0d7, _regs.bbftune_mode);
 
-    /* Enable the filter tuner. */
-    _io_iface->poke8(0x0ca, 0x22);
+    const std::string cache_key = _get_cal_cache_key("tx_bbf", bbbw);
+    if (not _restore_cal_results(cache_key)) {
+        /* Enable the filter tuner. */
+        _io_iface->poke8(0x0ca, 0x22);
+
+        /* Calibrate! */
+        size_t count = 0;
+        _io_iface->poke8(0x016, 0x40);
+        while (_io_iface->peek8(0x016) & 0x40) {
+            if (count > 100) {
+                throw uhd::runtime_error("[ad9361_device_t] TX baseband filter cal FAILURE");
+                break;
+            }
 
-    /* Calibrate! */
-    size_t count = 0;
-    _io_iface->poke8(0x016, 0x40);
-    while (_io_iface->peek8(0x016) & 0x40) {
-        if (count > 100) {
-            throw uhd::runtime_error("[ad9361_device_t] TX baseband filter cal FAILURE");
-            break;
+            count++;
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
         }
 
-        count++;
-        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        _store_cal_results(cache_key, tx_bbf_cal_regs, sizeof(tx_bbf_cal_regs)/sizeof(tx_bbf_cal_regs[0]));
     }
 
     /* Disable the filter tuner. */
@@ -526,9 +559,6 @@ double ad9361_device_t::_calibrate_secondary_tx_filter(double req_rfbw)
  * UG570 page 33 states that this filter should be calibrated to 2.5 * bbbw */
 double ad9361_device_t::_calibrate_rx_TIAs(double req_rfbw)
 {
-    boost::uint8_t reg1eb = _io_iface->peek8(0x1eb) & 0x3F;
-    boost::uint8_t reg1ec = _io_iface->peek8(0x1ec) & 0x7F;
-    boost::uint8_t reg1e6 = _io_iface->peek8(0x1e6) & 0x07;
     boost::uint8_t reg1db = 0x00;
     boost::uint8_t reg1dc = 0x00;
     boost::uint8_t reg1dd = 0x00;
@@ -553,6 +583,16 @@ double ad9361_device_t::_calibrate_rx_TIAs(double req_rfbw)
     }
     double ceil_bbbw_mhz = std::ceil(bbbw / 1e6);
 
+    /* The settings only depend on the RX filter calibration. */
+    const std::string cache_key = _get_cal_cache_key("rx_tia", bbbw);
+    if (_restore_cal_results(cache_key)) {
+        return bbbw;
+    }
+
+    boost::uint8_t reg1eb = _io_iface->peek8(0x1eb) & 0x3F;
+    boost::uint8_t reg1ec = _io_iface->peek8(0x1ec) & 0x7F;
+    boost::uint8_t reg1e6 = _io_iface->peek8(0x1e6) & 0x07;
+
     /* Do some crazy resistor and capacitor math. */
     int Cbbf = (reg1eb * 160) + (reg1ec * 10) + 140;
     int R2346 = 18300 * (reg1e6 & 0x07);
@@ -591,6 +631,8 @@ double ad9361_device_t::_calibrate_rx_TIAs(double req_rfbw)
     _io_iface->poke8(0x1dc, reg1dc);
     _io_iface->poke8(0x1de, reg1de);
 
+    _store_cal_results(cache_key, rx_tia_cal_regs, sizeof(rx_tia_cal_regs)/sizeof(rx_tia_cal_regs[0]));
+
     return bbbw;
 }
 
@@ -1370,6 +1412,52 @@ double ad9361_device_t::_tune_helper(direction_t direction, const double value)
     }
 }
 
+/* Copy the synthesizer settings of the current tune into a fast lock profile.
+ *
+ * A profile holds 16 words. Each word is written through the fast lock
+ * program address and data registers while the program clock runs. */
+void ad9361_device_t::_write_fast_lock_profile(direction_t direction, const size_t profile)
+{
+    /* Profile words, as RX register addresses. The TX registers are 0x40 above. */
+    static const boost::uint16_t profile_regs[16] = {
+        0x231, 0x232,               // Integer word
+        0x233, 0x234, 0x235,        // Fractional word
+        0x239, 0x242, 0x23b,        // VCO varactor, VCO bias, charge pump current
+        0x23e, 0x23f, 0x240,        // Loop filter
+        0x251, 0x250, 0x238,        // VCO varactor reference and control, VCO cal offset
+        0x236, 0x237                // VCO tune word found by the calibration
+    };
+    const boost::uint16_t offs = (direction == RX) ? 0x000 : 0x040;
+
+    for (size_t word = 0; word < 16; word++) {
+        _io_iface->poke8(0x25c + offs, ((profile & 0x07) << 4) | word);
+        _io_iface->poke8(0x25d + offs, _io_iface->peek8(profile_regs[word] + offs));
+        _io_iface->poke8(0x25f + offs, 0x03); // Program write, program clock enable
+    }
+
+    /* Stop the program clock. */
+    _io_iface->poke8(0x25f + offs, 0x00);
+}
+
+/* Leave fast lock mode, so the synthesizer runs from its own registers again.
+ *
+ * These may hold another frequency than the recalled profile, so the next
+ * tune can't be skipped as redundant. */
+void ad9361_device_t::_disable_fast_lock(direction_t direction)
+{
+    if (direction == RX) {
+        if (not _rx_fast_lock) return;
+        _io_iface->poke8(0x25a, 0x00);
+        _rx_fast_lock = false;
+        _req_rx_freq = 0.0;
+    } else {
+        if (not _tx_fast_lock) return;
+        _io_iface->poke8(0x29a, 0x00);
+        _tx_fast_lock = false;
+        _req_tx_freq = 0.0;
+    }
+}
+
 /* Configure the various clock / sample rates in the RX and TX chains.
  *
  * Functionally, this function configures AD9361's RX and TX rates. For
@@ -1518,6 +1606,105 @@ double ad9361_device_t::_setup_rates(const double rate)
 /***********************************************************************
  * Publicly exported functions to host calls
  **********************************************************************/
+/* Record the time since the previous phase of initialize(). */
+void ad9361_device_t::_mark_init_phase(const std::string &name)
+{
+    const boost::posix_time::ptime now = boost::posix_time::microsec_clock::local_time();
+    const double elapsed = (now - _init_phase_start).total_microseconds() / 1e6;
+    _init_timing.push_back(std::make_pair(name, elapsed));
+    _init_phase_start = now;
+    UHD_LOG << boost::format("[ad9361_device_t::initialize] %s: %.1f ms\n") % name % (elapsed * 1e3);
+}
+
+/* Read the die temperature once for the cache keys of a calibration run.
+ *
+ * Every key made until _cal_temp_valid is cleared again uses this reading.
+ * A failed read is remembered as NaN, so the keys are empty without polling
+ * the sensor again. */
+void ad9361_device_t::_read_cal_temperature(void)
+{
+    _cal_temp_valid = false;
+    if (not _cal_cache) {
+        return;
+    }
+
+    try {
+        _cal_temp = _get_temperature(-30.0);
+    } catch (const uhd::runtime_error &) {
+        _cal_temp = std::numeric_limits<double>::quiet_NaN();
+    }
+    _cal_temp_valid = true;
+}
+
+/* Make the calibration cache key for a calibration and its inputs.
+ *
+ * Filter calibrations depend on the BBPLL rate, the bandwidth and the die
+ * temperature. Returns an empty key when there is no cache, or the
+ * temperature can't be read, so the calibration runs. Outside of a run
+ * started by _read_cal_temperature() the temperature is read for this key. */
+std::string ad9361_device_t::_get_cal_cache_key(const std::string &name, const double bbbw)
+{
+    if (not _cal_cache) {
+        return "";
+    }
+
+    double temp = _cal_temp;
+    if (not _cal_temp_valid) {
+        try {
+            temp = _get_temperature(-30.0);
+        } catch (const uhd::runtime_error &) {
+            return "";
+        }
+    }
+    if (boost::math::isnan(temp)) {
+        return "";
+    }
+    const int temp_band = static_cast<int>(std::floor(temp / AD9361_CAL_CACHE_TEMP_BAND));
+
+    return str(boost::format("%s:%d:%.0f:%.0f") % name % temp_band % _bbpll_freq % bbbw);
+}
+
+/* Write cached calibration results, if there are any for this key. */
+bool ad9361_device_t::_restore_cal_results(const std::string &key)
+{
+    cal_cache_t::results_t results;
+    if (key.empty() or not _cal_cache->get(key, results)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < results.size(); i++) {
+        _io_iface->poke8(results[i].first, results[i].second);
+    }
+    UHD_LOG << boost::format("[ad9361_device_t] restored calibration %s\n") % key;
+    return true;
+}
+
+/* Read back calibration results and put them in the cache. */
+void ad9361_device_t::_store_cal_results(const std::string &key, const boost::uint16_t *regs, const size_t num_regs)
+{
+    if (key.empty()) {
+        return;
+    }
+
+    cal_cache_t::results_t results;
+    for (size_t i = 0; i < num_regs; i++) {
+        results.push_back(std::make_pair(regs[i], _io_iface->peek8(regs[i])));
+    }
+    _cal_cache->put(key, results);
+}
+
+void ad9361_device_t::set_cal_cache(cal_cache_t::sptr cal_cache)
+{
+    boost::lock_guard<boost::recursive_mutex> lock(_mutex);
+    _cal_cache = cal_cache;
+}
+
+ad9361_device_t::init_timing_t ad9361_device_t::get_init_timing()
+{
+    boost::lock_guard<boost::recursive_mutex> lock(_mutex);
+    return _init_timing;
+}
+
 void ad9361_device_t::initialize()
 {
     boost::lock_guard<boost::recursive_mutex> lock(_mutex);
@@ -1532,6 +1719,10 @@ void ad9361_device_t::initialize()
     _regs.bbftune_mode = 0x1e;
 
     /* Initialize private VRQ fields. */
+    _rx_fast_lock_profiles.assign(AD9361_NUM_FAST_LOCK_PROFILES, fast_lock_profile_t());
+    _tx_fast_lock_profiles.assign(AD9361_NUM_FAST_LOCK_PROFILES, fast_lock_profile_t());
+    _rx_fast_lock = false;
+    _tx_fast_lock = false;
     _rx_freq = DEFAULT_RX_FREQ;
     _tx_freq = DEFAULT_TX_FREQ;
     _req_rx_freq = 0.0;
@@ -1559,6 +1750,8 @@ void ad9361_device_t::initialize()
     _tx_sec_lp_bw = 0;
     _rx_bb_lp_bw = 0;
     _tx_bb_lp_bw = 0;
+    _init_timing.clear();
+    _init_phase_start = boost::posix_time::microsec_clock::local_time();
 
     /* Reset the device. */
     _io_iface->poke8(0x000, 0x01);
@@ -1593,9 +1786,11 @@ void ad9361_device_t::initialize()
         throw uhd::runtime_error("[ad9361_device_t] NOT IMPLEMENTED");
     }
     boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+    _mark_init_phase("reset and clocks");
 
     /* Tune the BBPLL, write TX and RX FIRS. */
     _setup_rates(50e6);
+    _mark_init_phase("BBPLL and rates");
 
     /* Setup data ports (FDD dual port DDR):
      *      FDD dual port DDR CMOS no swap.
@@ -1701,24 +1896,35 @@ void ad9361_device_t::initialize()
     _io_iface->poke8(0x014, 0x05); // use SPI for TXNRX ctrl, to ALERT, TX on
     _io_iface->poke8(0x013, 0x01); // enable ENSM
     boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    _mark_init_phase("interface setup");
 
     _calibrate_synth_charge_pumps();
+    _mark_init_phase("charge pump cal");
 
     _tune_helper(RX, _rx_freq);
     _tune_helper(TX, _tx_freq);
+    _mark_init_phase("synthesizer tune");
 
     _program_mixer_gm_subtable();
     _program_gain_table();
     _setup_gain_control(false);
+    _mark_init_phase("gain tables");
 
+    _read_cal_temperature();
     set_bw_filter(RX, _baseband_bw);
     set_bw_filter(TX, _baseband_bw);
+    _cal_temp_valid = false;
+    _mark_init_phase("filter and TIA cal");
 
     _setup_adc();
+    _mark_init_phase("ADC setup");
 
     _calibrate_baseband_dc_offset();
     _calibrate_rf_dc_offset();
+    _mark_init_phase("DC offset cal");
+
     _calibrate_rx_quadrature();
+    _mark_init_phase("RX quadrature cal");
 
     /*
      * Rx BB DC and IQ tracking are both disabled by calibration at this
@@ -1772,6 +1978,7 @@ void ad9361_device_t::initialize()
 
     /* Set TXers & RXers on (only works in FDD mode) */
     _io_iface->poke8(0x014, 0x21);
+    _mark_init_phase("finish");
 }
 
 
@@ -1848,8 +2055,10 @@ double ad9361_device_t::set_clock_rate(const double req_rate)
     _setup_gain_control(false);
     _reprogram_gains();
 
+    _read_cal_temperature();
     set_bw_filter(RX, _baseband_bw);
     set_bw_filter(TX, _baseband_bw);
+    _cal_temp_valid = false;
 
     _setup_adc();
 
@@ -1994,6 +2203,8 @@ double ad9361_device_t::tune(direction_t direction, const double value)
     boost::lock_guard<boost::recursive_mutex> lock(_mutex);
     double last_cal_freq;
 
+    _disable_fast_lock(direction);
+
     if (direction == RX) {
         if (freq_is_nearly_equal(value, _req_rx_freq)) {
             return _rx_freq;
@@ -2061,6 +2272,86 @@ double ad9361_device_t::tune(direction_t direction, const double value)
     return tune_freq;
 }
 
+/* Store the RX or TX synthesizer settings for a frequency in a fast lock
+ * profile.
+ *
+ * The LO is tuned and calibrated as usual, the locked synthesizer settings
+ * are copied into the profile, and the LO is tuned back to its previous
+ * frequency. */
+double ad9361_device_t::store_fast_lock_profile(direction_t direction, const size_t profile, const double value)
+{
+    boost::lock_guard<boost::recursive_mutex> lock(_mutex);
+
+    if (profile >= AD9361_NUM_FAST_LOCK_PROFILES) {
+        throw uhd::value_error(str(
+            boost::format("[ad9361_device_t] Invalid fast lock profile %d") % profile));
+    }
+
+    const double prev_freq = (direction == RX) ? _req_rx_freq : _req_tx_freq;
+    const double freq = tune(direction, value);
+    _write_fast_lock_profile(direction, profile);
+
+    fast_lock_profile_t &stored = (direction == RX) ?
+        _rx_fast_lock_profiles[profile] : _tx_fast_lock_profiles[profile];
+    stored.stored = true;
+    stored.req_freq = value;
+    stored.freq = freq;
+    stored.inputsel = _regs.inputsel & ((direction == RX) ? 0x3F : 0x40);
+    stored.vcodivs = _regs.vcodivs & ((direction == RX) ? 0x0F : 0xF0);
+
+    if (prev_freq != 0.0) {
+        tune(direction, prev_freq);
+    }
+
+    return freq;
+}
+
+/* Switch the RX or TX LO to a stored fast lock profile.
+ *
+ * This skips the synthesizer setup and the VCO calibration, and only
+ * writes registers. The band and VCO divider settings are not part of the
+ * profile, so they are written here. */
+double ad9361_device_t::recall_fast_lock_profile(direction_t direction, const size_t profile)
+{
+    boost::lock_guard<boost::recursive_mutex> lock(_mutex);
+
+    const std::vector<fast_lock_profile_t> &profiles = (direction == RX) ?
+        _rx_fast_lock_profiles : _tx_fast_lock_profiles;
+    if (profile >= profiles.size() or not profiles[profile].stored) {
+        throw uhd::value_error(str(
+            boost::format("[ad9361_device_t] Fast lock profile %d was not stored") % profile));
+    }
+    const fast_lock_profile_t &stored = profiles[profile];
+
+    if (direction == RX) {
+        _regs.inputsel = (_regs.inputsel & 0xC0) | stored.inputsel;
+        _regs.vcodivs = (_regs.vcodivs & 0xF0) | stored.vcodivs;
+    } else {
+        _regs.inputsel = (_regs.inputsel & 0xBF) | stored.inputsel;
+        _regs.vcodivs = (_regs.vcodivs & 0x0F) | stored.vcodivs;
+    }
+    _io_iface->poke8(0x004, _regs.inputsel);
+    _io_iface->poke8(0x005, _regs.vcodivs);
+
+    /* Select the profile and run the synthesizer from it. */
+    _io_iface->poke8((direction == RX) ? 0x25a : 0x29a, ((profile & 0x07) << 5) | 0x01);
+
+    if (direction == RX) {
+        _rx_fast_lock = true;
+        _req_rx_freq = stored.req_freq;
+        _rx_freq = stored.freq;
+
+        /* The gain table is left alone, reprogramming it takes hundreds of
+         * writes. The next regular tune switches it to the band of _rx_freq. */
+        return _rx_freq;
+    } else {
+        _tx_fast_lock = true;
+        _req_tx_freq = stored.req_freq;
+        _tx_freq = stored.freq;
+        return _tx_freq;
+    }
+}
+
 /* Get the current RX or TX frequency. */
 double ad9361_device_t::get_freq(direction_t direction)
 {
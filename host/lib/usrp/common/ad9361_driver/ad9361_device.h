@@ -21,11 +21,15 @@
 #include <ad9361_client.h>
 #include <boost/noncopyable.hpp>
 #include <boost/thread/recursive_mutex.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/shared_ptr.hpp>
 #include <uhd/types/filters.hpp>
 #include <uhd/types/sensors.hpp>
 #include <complex>
 #include <vector>
 #include <map>
+#include <string>
+#include <utility>
 #include "boost/assign.hpp"
 #include "boost/bind.hpp"
 #include "boost/function.hpp"
@@ -39,8 +43,28 @@ public:
     enum gain_mode_t {GAIN_MODE_MANUAL, GAIN_MODE_SLOW_AGC, GAIN_MODE_FAST_AGC};
     enum chain_t { CHAIN_1, CHAIN_2, CHAIN_BOTH };
 
+    /* Stores calibration results, so they can be restored instead of
+     * recomputed.
+     *
+     * The key names the calibration and every input it depends on. The
+     * results are the register values the calibration produced. */
+    class cal_cache_t
+    {
+    public:
+        typedef boost::shared_ptr<cal_cache_t> sptr;
+        typedef std::vector<std::pair<boost::uint16_t, boost::uint8_t> > results_t;
+
+        virtual ~cal_cache_t() {}
+
+        virtual bool get(const std::string &key, results_t &results) = 0;
+        virtual void put(const std::string &key, const results_t &results) = 0;
+    };
+
+    /* The duration in seconds of each phase of initialize(), in order. */
+    typedef std::vector<std::pair<std::string, double> > init_timing_t;
+
     ad9361_device_t(ad9361_params::sptr client, ad9361_io::sptr io_iface) :
-        _client_params(client), _io_iface(io_iface) {
+        _client_params(client), _io_iface(io_iface), _cal_temp_valid(false) {
 
         /*
          * This Boost.Assign to_container() workaround is necessary because STL containers
@@ -75,6 +99,13 @@ public:
     /* Initialize the AD9361 codec. */
     void initialize();
 
+    /* Get the duration of each phase of the last initialize(). */
+    init_timing_t get_init_timing();
+
+    /* Restore filter and TIA calibrations from a cache when the
+     * temperature band and clock rates match. Set this before initialize(). */
+    void set_cal_cache(cal_cache_t::sptr cal_cache);
+
     /* This function sets the RX / TX rate between AD9361 and the FPGA, and
      * thus determines the interpolation / decimation required in the FPGA to
      * achieve the user's requested rate.
@@ -104,6 +135,22 @@ public:
     /* Get the current RX or TX frequency. */
     double get_freq(direction_t direction);
 
+    /* Store the RX or TX synthesizer settings for a frequency in a fast lock
+     * profile.
+     *
+     * The LO is tuned and calibrated as usual, the locked synthesizer
+     * settings are copied into the profile, and the LO is tuned back to its
+     * previous frequency. Returns the exact frequency of the profile. */
+    double store_fast_lock_profile(direction_t direction, const size_t profile, const double value);
+
+    /* Switch the RX or TX LO to a stored fast lock profile.
+     *
+     * This skips the synthesizer setup and the VCO calibration and only
+     * writes registers, so it can run as a timed command. The RX gain
+     * table is not switched to the band of the profile. The next call to
+     * tune() leaves fast lock mode again. Returns the exact frequency. */
+    double recall_fast_lock_profile(direction_t direction, const size_t profile);
+
     /* Set the gain of RX1, RX2, TX1, or TX2.
      *
      * Note that the 'value' passed to this function is the actual gain value,
@@ -162,6 +209,8 @@ public:
     static const double AD9361_RECOMMENDED_MAX_BANDWIDTH;
     static const double DEFAULT_RX_FREQ;
     static const double DEFAULT_TX_FREQ;
+    static const size_t AD9361_NUM_FAST_LOCK_PROFILES;
+    static const double AD9361_CAL_CACHE_TEMP_BAND;
 
 private:    //Methods
     void _program_fir_filter(direction_t direction, int num_taps, boost::uint16_t *coeffs);
@@ -189,6 +238,13 @@ private:    //Methods
     double _tune_bbvco(const double rate);
     void _reprogram_gains();
     double _tune_helper(direction_t direction, const double value);
+    void _write_fast_lock_profile(direction_t direction, const size_t profile);
+    void _mark_init_phase(const std::string &name);
+    void _read_cal_temperature(void);
+    std::string _get_cal_cache_key(const std::string &name, const double bbbw);
+    bool _restore_cal_results(const std::string &key);
+    void _store_cal_results(const std::string &key, const boost::uint16_t *regs, const size_t num_regs);
+    void _disable_fast_lock(direction_t direction);
     double _setup_rates(const double rate);
     double _get_temperature(const double cal_offset, const double timeout = 0.1);
     void _configure_bb_dc_tracking();
@@ -220,6 +276,16 @@ private:    //Members
         boost::uint8_t bbftune_mode;
     } chip_regs_t;
 
+    struct fast_lock_profile_t
+    {
+        fast_lock_profile_t() : stored(false), req_freq(0.0), freq(0.0), inputsel(0), vcodivs(0) { }
+
+        bool stored;
+        double req_freq, freq;
+        //! The band and VCO divider bits of this direction, these are not part of the profile
+        boost::uint8_t inputsel, vcodivs;
+    };
+
     struct filter_query_helper
     {
         filter_query_helper(
@@ -260,6 +326,13 @@ private:    //Members
     boost::int32_t      _rfir_factor;
     gain_mode_t         _rx1_agc_mode, _rx2_agc_mode;
     bool                _rx1_agc_enable, _rx2_agc_enable;
+    std::vector<fast_lock_profile_t> _rx_fast_lock_profiles, _tx_fast_lock_profiles;
+    bool                _rx_fast_lock, _tx_fast_lock;
+    cal_cache_t::sptr   _cal_cache;
+    bool                _cal_temp_valid;
+    double              _cal_temp;
+    init_timing_t       _init_timing;
+    boost::posix_time::ptime _init_phase_start;
     //Register soft-copies
     chip_regs_t         _regs;
     //Synchronization
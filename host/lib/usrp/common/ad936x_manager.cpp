@@ -253,6 +253,21 @@ class ad936x_manager_impl : public ad936x_manager
             .set_coercer(boost::bind(&ad9361_ctrl::tune, _codec_ctrl, key, _1))
         ;
 
+        // The codec is not written through a timed control path, so gain
+        // and frequency settings ignore the command time
+        subtree->create<bool>("timed_commands").set(false);
+
+        // Fast lock profiles. Recalling a profile is left to the device,
+        // which may have to switch its own band selection along with it.
+        subtree->create<size_t>("freq/fast_lock/num_profiles")
+            .set(ad9361_ctrl::get_num_fast_lock_profiles())
+        ;
+        for (size_t i = 0; i < ad9361_ctrl::get_num_fast_lock_profiles(); i++) {
+            subtree->create<double>(uhd::fs_path("freq/fast_lock/profiles") / i / "value")
+                .set_coercer(boost::bind(&ad9361_ctrl::store_fast_lock_profile, _codec_ctrl, key, i, _1))
+            ;
+        }
+
         // Frontend corrections
         if(dir == RX_DIRECTION)
         {
@@ -25,7 +25,10 @@
 #include <boost/function.hpp>
 #include <boost/thread.hpp>
 #include <boost/math/special_functions/round.hpp>
+#include <boost/tuple/tuple.hpp>
+#include <boost/tuple/tuple_comparison.hpp>
 #include <vector>
+#include "synth_tuning_cache.hpp"
 #include "adf4350_regs.hpp"
 #include "adf4351_regs.hpp"
 
@@ -114,19 +117,128 @@ public:
     }
 
     double set_frequency(double target_freq, bool int_n_mode, bool flush = false)
+    {
+        static const double VCO_FREQ_MIN            = 2.2e9;
+        static const double VCO_FREQ_MAX            = 4.4e9;
+
+        uhd::range_t rf_divider_range = _get_rfdiv_range();
+        uhd::range_t int_range = get_int_range();
+
+        //The divider search only depends on the key, so repeated tunes
+        //(e.g. a scan over a fixed set of frequencies) reuse the solution.
+        //The cache is shared by all synthesizers of this type.
+        const tuning_key_t key(target_freq, _reference_freq, int_n_mode, _fb_after_divider != 0, _N_min);
+        tuning_t tuning;
+        if (not _tuning_cache().get(key, tuning)) {
+            tuning = _find_tuning(target_freq, int_n_mode, rf_divider_range, int_range);
+            _tuning_cache().put(key, tuning);
+        }
+        const boost::uint16_t R = tuning.R, BS = tuning.BS, N = tuning.N, FRAC = tuning.FRAC, MOD = tuning.MOD;
+        const boost::uint16_t RFdiv = tuning.RFdiv;
+        const bool D = tuning.D, T = tuning.T;
+        const double pfd_freq = tuning.pfd_freq;
+        const double vco_freq = tuning.vco_freq;
+        const double actual_freq = tuning.actual_freq;
+
+        //Typical phase resync time documented in data sheet pg.24
+        static const double PHASE_RESYNC_TIME = 400e-6;
+
+        _regs.frac_12_bit            = FRAC;
+        _regs.int_16_bit             = N;
+        _regs.mod_12_bit             = MOD;
+        _regs.clock_divider_12_bit   = std::max<boost::uint16_t>(1, boost::uint16_t(std::ceil(PHASE_RESYNC_TIME*pfd_freq/MOD)));
+        _regs.feedback_select        = _fb_after_divider ?
+                                        adf435x_regs_t::FEEDBACK_SELECT_DIVIDED :
+                                        adf435x_regs_t::FEEDBACK_SELECT_FUNDAMENTAL;
+        _regs.clock_div_mode         = _fb_after_divider ?
+                                        adf435x_regs_t::CLOCK_DIV_MODE_RESYNC_ENABLE :
+                                        adf435x_regs_t::CLOCK_DIV_MODE_FAST_LOCK;
+        _regs.r_counter_10_bit       = R;
+        _regs.reference_divide_by_2  = T ?
+                                        adf435x_regs_t::REFERENCE_DIVIDE_BY_2_ENABLED :
+                                        adf435x_regs_t::REFERENCE_DIVIDE_BY_2_DISABLED;
+        _regs.reference_doubler      = D ?
+                                        adf435x_regs_t::REFERENCE_DOUBLER_ENABLED :
+                                        adf435x_regs_t::REFERENCE_DOUBLER_DISABLED;
+        _regs.band_select_clock_div  = boost::uint8_t(BS);
+        _regs.rf_divider_select      = static_cast<typename adf435x_regs_t::rf_divider_select_t>(_get_rfdiv_setting(RFdiv));
+        _regs.ldf                    = int_n_mode ?
+                                        adf435x_regs_t::LDF_INT_N :
+                                        adf435x_regs_t::LDF_FRAC_N;
+
+        std::string tuning_str = (int_n_mode) ? "Integer-N" : "Fractional";
+        UHD_LOGV(often)
+            << boost::format("ADF 435X Frequencies (MHz): REQUESTED=%0.9f, ACTUAL=%0.9f"
+            ) % (target_freq/1e6) % (actual_freq/1e6) << std::endl
+            << boost::format("ADF 435X Intermediates (MHz): Feedback=%0.2f, VCO=%0.2f, PFD=%0.2f, BAND=%0.2f, REF=%0.2f"
+            ) % (tuning.feedback_freq/1e6) % (vco_freq/1e6) % (pfd_freq/1e6) % (pfd_freq/BS/1e6) % (_reference_freq/1e6) << std::endl
+            << boost::format("ADF 435X Tuning: %s") % tuning_str.c_str() << std::endl
+            << boost::format("ADF 435X Settings: R=%d, BS=%d, N=%d, FRAC=%d, MOD=%d, T=%d, D=%d, RFdiv=%d"
+            ) % R % BS % N % FRAC % MOD % T % D % RFdiv << std::endl;
+
+        UHD_ASSERT_THROW((_regs.frac_12_bit          & ((boost::uint16_t)~0xFFF)) == 0);
+        UHD_ASSERT_THROW((_regs.mod_12_bit           & ((boost::uint16_t)~0xFFF)) == 0);
+        UHD_ASSERT_THROW((_regs.clock_divider_12_bit & ((boost::uint16_t)~0xFFF)) == 0);
+        UHD_ASSERT_THROW((_regs.r_counter_10_bit     & ((boost::uint16_t)~0x3FF)) == 0);
+
+        UHD_ASSERT_THROW(vco_freq >= VCO_FREQ_MIN and vco_freq <= VCO_FREQ_MAX);
+        UHD_ASSERT_THROW(RFdiv >= static_cast<boost::uint16_t>(rf_divider_range.start()));
+        UHD_ASSERT_THROW(RFdiv <= static_cast<boost::uint16_t>(rf_divider_range.stop()));
+        UHD_ASSERT_THROW(_regs.int_16_bit >= static_cast<boost::uint16_t>(int_range.start()));
+        UHD_ASSERT_THROW(_regs.int_16_bit <= static_cast<boost::uint16_t>(int_range.stop()));
+
+        if (flush) commit();
+        return actual_freq;
+    }
+
+    void commit()
+    {
+        //reset counters
+        _regs.counter_reset = adf435x_regs_t::COUNTER_RESET_ENABLED;
+        std::vector<boost::uint32_t> regs;
+        regs.push_back(_regs.get_reg(boost::uint32_t(2)));
+        _write_fn(regs);
+        _regs.counter_reset = adf435x_regs_t::COUNTER_RESET_DISABLED;
+
+        //write the registers
+        //correct power-up sequence to write registers (5, 4, 3, 2, 1, 0)
+        regs.clear();
+        for (int addr = 5; addr >= 0; addr--) {
+            regs.push_back(_regs.get_reg(boost::uint32_t(addr)));
+        }
+        _write_fn(regs);
+    }
+
+protected:
+    //! The result of the divider search for one tune
+    struct tuning_t
+    {
+        boost::uint16_t R, BS, N, FRAC, MOD, RFdiv;
+        bool D, T;
+        double pfd_freq, vco_freq, feedback_freq, actual_freq;
+    };
+
+    //! Target freq, reference freq, integer-N mode, feedback after divider, minimum N
+    typedef boost::tuple<double, double, bool, bool, int> tuning_key_t;
+
+    static synth_tuning_cache<tuning_key_t, tuning_t>& _tuning_cache()
+    {
+        static synth_tuning_cache<tuning_key_t, tuning_t> cache(1024);
+        return cache;
+    }
+
+    tuning_t _find_tuning(
+        double target_freq, bool int_n_mode,
+        const uhd::range_t &rf_divider_range, const uhd::range_t &int_range)
     {
         static const double REF_DOUBLER_THRESH_FREQ = 12.5e6;
         static const double PFD_FREQ_MAX            = 25.0e6;
         static const double BAND_SEL_FREQ_MAX       = 100e3;
         static const double VCO_FREQ_MIN            = 2.2e9;
-        static const double VCO_FREQ_MAX            = 4.4e9;
 
         //Default invalid value for actual_freq
         double actual_freq = 0;
 
-        uhd::range_t rf_divider_range = _get_rfdiv_range();
-        uhd::range_t int_range = get_int_range();
-
         double pfd_freq = 0;
         boost::uint16_t R = 0, BS = 0, N = 0, FRAC = 0, MOD = 0;
         boost::uint16_t RFdiv = static_cast<boost::uint16_t>(rf_divider_range.start());
@@ -198,9 +310,6 @@ public:
             R /= 2;
         }
 
-        //Typical phase resync time documented in data sheet pg.24
-        static const double PHASE_RESYNC_TIME = 400e-6;
-
         //If feedback after divider, then compensation for the divider is pulled into the INT value
         int rf_div_compensation = _fb_after_divider ? 1 : RFdiv;
 
@@ -210,73 +319,22 @@ public:
             (_reference_freq*(D?2:1)/(R*(T?2:1))))
         ) / rf_div_compensation;
 
-        _regs.frac_12_bit            = FRAC;
-        _regs.int_16_bit             = N;
-        _regs.mod_12_bit             = MOD;
-        _regs.clock_divider_12_bit   = std::max<boost::uint16_t>(1, boost::uint16_t(std::ceil(PHASE_RESYNC_TIME*pfd_freq/MOD)));
-        _regs.feedback_select        = _fb_after_divider ?
-                                        adf435x_regs_t::FEEDBACK_SELECT_DIVIDED :
-                                        adf435x_regs_t::FEEDBACK_SELECT_FUNDAMENTAL;
-        _regs.clock_div_mode         = _fb_after_divider ?
-                                        adf435x_regs_t::CLOCK_DIV_MODE_RESYNC_ENABLE :
-                                        adf435x_regs_t::CLOCK_DIV_MODE_FAST_LOCK;
-        _regs.r_counter_10_bit       = R;
-        _regs.reference_divide_by_2  = T ?
-                                        adf435x_regs_t::REFERENCE_DIVIDE_BY_2_ENABLED :
-                                        adf435x_regs_t::REFERENCE_DIVIDE_BY_2_DISABLED;
-        _regs.reference_doubler      = D ?
-                                        adf435x_regs_t::REFERENCE_DOUBLER_ENABLED :
-                                        adf435x_regs_t::REFERENCE_DOUBLER_DISABLED;
-        _regs.band_select_clock_div  = boost::uint8_t(BS);
-        _regs.rf_divider_select      = static_cast<typename adf435x_regs_t::rf_divider_select_t>(_get_rfdiv_setting(RFdiv));
-        _regs.ldf                    = int_n_mode ?
-                                        adf435x_regs_t::LDF_INT_N :
-                                        adf435x_regs_t::LDF_FRAC_N;
-
-        std::string tuning_str = (int_n_mode) ? "Integer-N" : "Fractional";
-        UHD_LOGV(often)
-            << boost::format("ADF 435X Frequencies (MHz): REQUESTED=%0.9f, ACTUAL=%0.9f"
-            ) % (target_freq/1e6) % (actual_freq/1e6) << std::endl
-            << boost::format("ADF 435X Intermediates (MHz): Feedback=%0.2f, VCO=%0.2f, PFD=%0.2f, BAND=%0.2f, REF=%0.2f"
-            ) % (feedback_freq/1e6) % (vco_freq/1e6) % (pfd_freq/1e6) % (pfd_freq/BS/1e6) % (_reference_freq/1e6) << std::endl
-            << boost::format("ADF 435X Tuning: %s") % tuning_str.c_str() << std::endl
-            << boost::format("ADF 435X Settings: R=%d, BS=%d, N=%d, FRAC=%d, MOD=%d, T=%d, D=%d, RFdiv=%d"
-            ) % R % BS % N % FRAC % MOD % T % D % RFdiv << std::endl;
-
-        UHD_ASSERT_THROW((_regs.frac_12_bit          & ((boost::uint16_t)~0xFFF)) == 0);
-        UHD_ASSERT_THROW((_regs.mod_12_bit           & ((boost::uint16_t)~0xFFF)) == 0);
-        UHD_ASSERT_THROW((_regs.clock_divider_12_bit & ((boost::uint16_t)~0xFFF)) == 0);
-        UHD_ASSERT_THROW((_regs.r_counter_10_bit     & ((boost::uint16_t)~0x3FF)) == 0);
-
-        UHD_ASSERT_THROW(vco_freq >= VCO_FREQ_MIN and vco_freq <= VCO_FREQ_MAX);
-        UHD_ASSERT_THROW(RFdiv >= static_cast<boost::uint16_t>(rf_divider_range.start()));
-        UHD_ASSERT_THROW(RFdiv <= static_cast<boost::uint16_t>(rf_divider_range.stop()));
-        UHD_ASSERT_THROW(_regs.int_16_bit >= static_cast<boost::uint16_t>(int_range.start()));
-        UHD_ASSERT_THROW(_regs.int_16_bit <= static_cast<boost::uint16_t>(int_range.stop()));
-
-        if (flush) commit();
-        return actual_freq;
+        tuning_t tuning;
+        tuning.R = R;
+        tuning.BS = BS;
+        tuning.N = N;
+        tuning.FRAC = FRAC;
+        tuning.MOD = MOD;
+        tuning.RFdiv = RFdiv;
+        tuning.D = D;
+        tuning.T = T;
+        tuning.pfd_freq = pfd_freq;
+        tuning.vco_freq = vco_freq;
+        tuning.feedback_freq = feedback_freq;
+        tuning.actual_freq = actual_freq;
+        return tuning;
     }
 
-    void commit()
-    {
-        //reset counters
-        _regs.counter_reset = adf435x_regs_t::COUNTER_RESET_ENABLED;
-        std::vector<boost::uint32_t> regs;
-        regs.push_back(_regs.get_reg(boost::uint32_t(2)));
-        _write_fn(regs);
-        _regs.counter_reset = adf435x_regs_t::COUNTER_RESET_DISABLED;
-
-        //write the registers
-        //correct power-up sequence to write registers (5, 4, 3, 2, 1, 0)
-        regs.clear();
-        for (int addr = 5; addr >= 0; addr--) {
-            regs.push_back(_regs.get_reg(boost::uint32_t(addr)));
-        }
-        _write_fn(regs);
-    }
-
-protected:
     uhd::range_t _get_rfdiv_range();
     int _get_rfdiv_setting(boost::uint16_t div);
 
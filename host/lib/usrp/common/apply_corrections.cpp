@@ -20,7 +20,7 @@
 #include <uhd/utils/paths.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/csv.hpp>
-#include <uhd/types/dict.hpp>
+#include <uhd/types/hash_dict.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/foreach.hpp>
 #include <boost/thread/mutex.hpp>
@@ -52,7 +52,7 @@ static bool fe_cal_comp(fe_cal_t a, fe_cal_t b){
     return (a.lo_freq < b.lo_freq);
 }
 
-static uhd::dict<std::string, std::vector<fe_cal_t> > fe_cal_cache;
+static uhd::hash_dict<std::string, std::vector<fe_cal_t> > fe_cal_cache;
 
 static bool is_same_freq(const double f1, const double f2)
 {
@@ -26,9 +26,12 @@
 #include <boost/function.hpp>
 #include <boost/thread.hpp>
 #include <boost/math/special_functions/round.hpp>
+#include <boost/tuple/tuple.hpp>
+#include <boost/tuple/tuple_comparison.hpp>
 #include <vector>
 #include "max2870_regs.hpp"
 #include "max2871_regs.hpp"
+#include "synth_tuning_cache.hpp"
 
 /**
  * MAX287x interface
@@ -249,6 +252,29 @@ public:
     virtual bool can_sync();
 
 protected:
+    //! The result of the divider search for one tune
+    struct tuning_t
+    {
+        int T, D, R, BS, N, FRAC, MOD, RFdiv;
+        double pfd_freq, vco_freq, actual_freq;
+    };
+
+    //! Target freq, reference freq, target PFD freq, integer-N mode, feedback divided
+    typedef boost::tuple<double, double, double, bool, bool> tuning_key_t;
+
+    static synth_tuning_cache<tuning_key_t, tuning_t>& _tuning_cache()
+    {
+        static synth_tuning_cache<tuning_key_t, tuning_t> cache(1024);
+        return cache;
+    }
+
+    static tuning_t _find_tuning(
+        double target_freq,
+        double ref_freq,
+        double target_pfd_freq,
+        bool is_int_n,
+        bool feedback_divided);
+
     max287x_regs_t _regs;
     bool _can_sync;
     bool _write_all_regs;
@@ -391,32 +417,18 @@ bool max287x<max287x_regs_t>::is_shutdown(void)
 }
 
 template <typename max287x_regs_t>
-double max287x<max287x_regs_t>::set_frequency(
+typename max287x<max287x_regs_t>::tuning_t max287x<max287x_regs_t>::_find_tuning(
     double target_freq,
     double ref_freq,
     double target_pfd_freq,
-    bool is_int_n)
+    bool is_int_n,
+    bool feedback_divided)
 {
-    _can_sync = false;
-
-    //map rf divider select output dividers to enums
-    static const uhd::dict<int, typename max287x_regs_t::rf_divider_select_t> rfdivsel_to_enum =
-        boost::assign::map_list_of
-        (1,   max287x_regs_t::RF_DIVIDER_SELECT_DIV1)
-        (2,   max287x_regs_t::RF_DIVIDER_SELECT_DIV2)
-        (4,   max287x_regs_t::RF_DIVIDER_SELECT_DIV4)
-        (8,   max287x_regs_t::RF_DIVIDER_SELECT_DIV8)
-        (16,  max287x_regs_t::RF_DIVIDER_SELECT_DIV16)
-        (32,  max287x_regs_t::RF_DIVIDER_SELECT_DIV32)
-        (64,  max287x_regs_t::RF_DIVIDER_SELECT_DIV64)
-        (128, max287x_regs_t::RF_DIVIDER_SELECT_DIV128);
-
     //map mode setting to valid integer divider (N) values
     static const uhd::range_t int_n_mode_div_range(16,65535,1);
     static const uhd::range_t frac_n_mode_div_range(19,4091,1);
 
     //other ranges and constants from MAX287X datasheets
-    static const uhd::range_t clock_div_range(1,4095,1);
     static const uhd::range_t r_range(1,1023,1);
     static const double MIN_VCO_FREQ = 3e9;
     static const double BS_FREQ = 50e3;
@@ -431,7 +443,6 @@ double max287x<max287x_regs_t>::set_frequency(
     int MOD = 4095;
     int RFdiv = 1;
     double pfd_freq = target_pfd_freq;
-    bool feedback_divided = (_regs.feedback_select == max287x_regs_t::FEEDBACK_SELECT_DIVIDED);
 
     //increase RF divider until acceptable VCO frequency (MIN freq for MAX287x VCO is 3GHz)
     UHD_ASSERT_THROW(target_freq > 0);
@@ -513,6 +524,62 @@ double max287x<max287x_regs_t>::set_frequency(
     //actual frequency calculation
     double actual_freq = double((N + (double(FRAC)/double(MOD)))*ref_freq*(1+int(D))/(R*(1+int(T)))) * fb_divisor / RFdiv;
 
+    tuning_t tuning;
+    tuning.T = T;
+    tuning.D = D;
+    tuning.R = R;
+    tuning.BS = BS;
+    tuning.N = N;
+    tuning.FRAC = FRAC;
+    tuning.MOD = MOD;
+    tuning.RFdiv = RFdiv;
+    tuning.pfd_freq = pfd_freq;
+    tuning.vco_freq = vco_freq;
+    tuning.actual_freq = actual_freq;
+    return tuning;
+}
+
+template <typename max287x_regs_t>
+double max287x<max287x_regs_t>::set_frequency(
+    double target_freq,
+    double ref_freq,
+    double target_pfd_freq,
+    bool is_int_n)
+{
+    _can_sync = false;
+
+    //map rf divider select output dividers to enums
+    static const uhd::dict<int, typename max287x_regs_t::rf_divider_select_t> rfdivsel_to_enum =
+        boost::assign::map_list_of
+        (1,   max287x_regs_t::RF_DIVIDER_SELECT_DIV1)
+        (2,   max287x_regs_t::RF_DIVIDER_SELECT_DIV2)
+        (4,   max287x_regs_t::RF_DIVIDER_SELECT_DIV4)
+        (8,   max287x_regs_t::RF_DIVIDER_SELECT_DIV8)
+        (16,  max287x_regs_t::RF_DIVIDER_SELECT_DIV16)
+        (32,  max287x_regs_t::RF_DIVIDER_SELECT_DIV32)
+        (64,  max287x_regs_t::RF_DIVIDER_SELECT_DIV64)
+        (128, max287x_regs_t::RF_DIVIDER_SELECT_DIV128);
+
+    //other ranges and constants from MAX287X datasheets
+    static const uhd::range_t clock_div_range(1,4095,1);
+
+    //The divider search only depends on the key, so repeated tunes
+    //(e.g. a scan over a fixed set of frequencies) reuse the solution.
+    //The cache is shared by all synthesizers of this type.
+    bool feedback_divided = (_regs.feedback_select == max287x_regs_t::FEEDBACK_SELECT_DIVIDED);
+    const tuning_key_t key(target_freq, ref_freq, target_pfd_freq, is_int_n, feedback_divided);
+    tuning_t tuning;
+    if (not _tuning_cache().get(key, tuning))
+    {
+        tuning = _find_tuning(target_freq, ref_freq, target_pfd_freq, is_int_n, feedback_divided);
+        _tuning_cache().put(key, tuning);
+    }
+    const int T = tuning.T, D = tuning.D, R = tuning.R, BS = tuning.BS;
+    const int N = tuning.N, FRAC = tuning.FRAC, MOD = tuning.MOD, RFdiv = tuning.RFdiv;
+    const double pfd_freq = tuning.pfd_freq;
+    const double vco_freq = tuning.vco_freq;
+    const double actual_freq = tuning.actual_freq;
+
     UHD_LOGV(rarely)
         << boost::format("MAX287x: Intermediates: ref=%0.2f, outdiv=%f, fbdiv=%f"
             ) % ref_freq % double(RFdiv*2) % double(N + double(FRAC)/double(MOD)) << std::endl
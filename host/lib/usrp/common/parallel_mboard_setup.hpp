@@ -0,0 +1,129 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_USRP_COMMON_PARALLEL_MBOARD_SETUP_HPP
+#define INCLUDED_LIBUHD_USRP_COMMON_PARALLEL_MBOARD_SETUP_HPP
+
+#include <uhd/exception.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace uhd{ namespace usrp{
+
+/*!
+ * Runs the setup of every motherboard of a device on a pool of threads.
+ *
+ * Motherboards are handed out in index order. After a setup failed,
+ * no further setups are started, the running ones are finished and
+ * the error of the lowest failed index is rethrown, so the outcome
+ * does not depend on thread timing. With one thread, the setups run
+ * in order in the calling thread, exactly like a plain loop.
+ *
+ * The setups run concurrently, so anything they share other than the
+ * property tree must be locked by the caller.
+ */
+class parallel_mboard_setup : boost::noncopyable
+{
+public:
+    typedef boost::function<void(const size_t, const device_addr_t &)> setup_fcn_t;
+
+    /*!
+     * Set up all motherboards.
+     * \param setup called with the motherboard index and its device args
+     * \param device_args the device args of every motherboard
+     * \param max_threads the number of setups running at once
+     */
+    static void run(
+        const setup_fcn_t &setup,
+        const device_addrs_t &device_args,
+        const size_t max_threads
+    ){
+        const size_t num_threads = std::min(device_args.size(), max_threads);
+        if (num_threads <= 1){
+            for (size_t i = 0; i < device_args.size(); i++){
+                setup(i, device_args[i]);
+            }
+            return;
+        }
+
+        parallel_mboard_setup pool(setup, device_args);
+        boost::thread_group threads;
+        for (size_t i = 0; i < num_threads; i++){
+            threads.create_thread(boost::bind(&parallel_mboard_setup::worker, &pool));
+        }
+        threads.join_all();
+
+        for (size_t i = 0; i < pool._errors.size(); i++){
+            if (pool._errors[i]) pool._errors[i]->dynamic_throw();
+        }
+    }
+
+private:
+    parallel_mboard_setup(const setup_fcn_t &setup, const device_addrs_t &device_args):
+        _setup(setup), _device_args(device_args), _next(0), _failed(false),
+        _errors(device_args.size())
+    {}
+
+    void worker(void){
+        while (true){
+            size_t i;
+            {
+                boost::mutex::scoped_lock lock(_mutex);
+                if (_failed or _next == _device_args.size()) return;
+                i = _next++;
+            }
+
+            boost::shared_ptr<uhd::exception> error;
+            try{
+                _setup(i, _device_args[i]);
+            }
+            catch(const uhd::exception &e){
+                error.reset(e.dynamic_clone());
+            }
+            catch(const std::exception &e){
+                error.reset(new uhd::runtime_error(e.what()));
+            }
+            catch(...){
+                error.reset(new uhd::runtime_error("unknown error in motherboard setup"));
+            }
+
+            if (error){
+                boost::mutex::scoped_lock lock(_mutex);
+                _errors[i] = error;
+                _failed = true;
+            }
+        }
+    }
+
+    const setup_fcn_t &_setup;
+    const device_addrs_t &_device_args;
+    boost::mutex _mutex;
+    size_t _next;
+    bool _failed;
+    std::vector<boost::shared_ptr<uhd::exception> > _errors;
+};
+
+}} //namespace uhd::usrp
+
+#endif /* INCLUDED_LIBUHD_USRP_COMMON_PARALLEL_MBOARD_SETUP_HPP */
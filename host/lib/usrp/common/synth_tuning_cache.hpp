@@ -0,0 +1,110 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_USRP_COMMON_SYNTH_TUNING_CACHE_HPP
+#define INCLUDED_LIBUHD_USRP_COMMON_SYNTH_TUNING_CACHE_HPP
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <list>
+#include <map>
+
+/*!
+ * A bounded cache of synthesizer tuning solutions.
+ *
+ * The key holds everything the divider search depends on (target
+ * frequency, reference frequency and constraints), the solution holds
+ * the dividers found and the frequency they achieve. When the cache
+ * is full the least recently used solution is dropped.
+ * The key type needs operator<, e.g. a boost::tuple.
+ * All methods are thread-safe, so one cache can be shared by every
+ * synthesizer of the same type.
+ */
+template <typename key_t, typename solution_t>
+class synth_tuning_cache : boost::noncopyable
+{
+public:
+    synth_tuning_cache(const size_t capacity):
+        _capacity(capacity)
+    {}
+
+    /*!
+     * Look up the solution for a key.
+     * \param key the search parameters
+     * \param solution set to the cached solution when found
+     * \return true if the key was found
+     */
+    bool get(const key_t &key, solution_t &solution)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        typename index_t::iterator it = _index.find(key);
+        if (it == _index.end()) return false;
+        //move to the front, the most recently used entry
+        _items.splice(_items.begin(), _items, it->second);
+        solution = it->second->second;
+        return true;
+    }
+
+    /*!
+     * Store the solution for a key.
+     * \param key the search parameters
+     * \param solution the solution of the search
+     */
+    void put(const key_t &key, const solution_t &solution)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        typename index_t::iterator it = _index.find(key);
+        if (it != _index.end()) {
+            it->second->second = solution;
+            _items.splice(_items.begin(), _items, it->second);
+            return;
+        }
+        if (_capacity == 0) return;
+        if (_index.size() >= _capacity) {
+            _index.erase(_items.back().first);
+            _items.pop_back();
+        }
+        _items.push_front(std::make_pair(key, solution));
+        _index[key] = _items.begin();
+    }
+
+    //! The number of cached solutions
+    size_t size(void)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        return _index.size();
+    }
+
+    //! Drop all cached solutions
+    void clear(void)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        _index.clear();
+        _items.clear();
+    }
+
+private:
+    typedef std::list<std::pair<key_t, solution_t> > items_t;
+    typedef std::map<key_t, typename items_t::iterator> index_t;
+
+    const size_t    _capacity;
+    items_t         _items;     //Most recently used first
+    index_t         _index;
+    boost::mutex    _mutex;
+};
+
+#endif /* INCLUDED_LIBUHD_USRP_COMMON_SYNTH_TUNING_CACHE_HPP */
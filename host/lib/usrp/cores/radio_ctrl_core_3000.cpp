@@ -27,6 +27,7 @@
 #include <boost/thread/thread.hpp>
 #include <boost/format.hpp>
 #include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
 #include <queue>
 
 using namespace uhd;
@@ -61,6 +62,7 @@ public:
             while (resp_xport->get_recv_buff(0.0)) {} //flush
         }
         this->set_time(uhd::time_spec_t(0.0));
+        _held_use_time = false;
         this->set_tick_rate(1.0); //something possible but bogus
     }
 
@@ -87,10 +89,7 @@ public:
     {
         boost::mutex::scoped_lock lock(_mutex);
         this->send_pkt(SR_READBACK, addr/8);
-        const boost::uint64_t res = this->wait_for_ack(true);
-        const boost::uint32_t lo = boost::uint32_t(res & 0xffffffff);
-        const boost::uint32_t hi = boost::uint32_t(res >> 32);
-        return ((addr/4) & 0x1)? hi : lo;
+        return select32(this->wait_for_ack(true), addr);
     }
 
     boost::uint64_t peek64(const wb_addr_type addr)
@@ -100,6 +99,57 @@ public:
         return this->wait_for_ack(true);
     }
 
+    /*******************************************************************
+     * Pipelined peek and poke:
+     * The control endpoint in the FPGA takes one register operation per
+     * packet and answers every packet with one response, so operations
+     * are not packed into one packet. Several operations are kept in
+     * flight instead, up to the number of response frames, and their
+     * responses are checked in order. Peeks gain the most, a single
+     * peek waits for its response before the next one is sent. The
+     * batched poke holds the lock, so its writes go out back to back
+     * under the same command time.
+     ******************************************************************/
+    void poke32_batch(const poke32_batch_type &pokes)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        for (size_t i = 0; i < pokes.size(); i++)
+        {
+            this->send_pkt(pokes[i].first/4, pokes[i].second);
+            this->wait_for_ack(false);
+        }
+    }
+
+    std::vector<boost::uint32_t> peek32_batch(const std::vector<wb_addr_type> &addrs)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        std::vector<readback_type::sptr> readbacks;
+        for (size_t i = 0; i < addrs.size(); i++)
+        {
+            readbacks.push_back(this->send_readback(addrs[i]));
+        }
+        std::vector<boost::uint32_t> data(addrs.size());
+        for (size_t i = 0; i < addrs.size(); i++)
+        {
+            data[i] = select32(this->wait_for_readback(readbacks[i]), addrs[i]);
+        }
+        return data;
+    }
+
+    radio_ctrl_future<boost::uint32_t> peek32_async(const wb_addr_type addr)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        return radio_ctrl_future<boost::uint32_t>(boost::bind(
+            &radio_ctrl_core_3000_impl::get_readback32, this, this->send_readback(addr), addr));
+    }
+
+    radio_ctrl_future<boost::uint64_t> peek64_async(const wb_addr_type addr)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        return radio_ctrl_future<boost::uint64_t>(boost::bind(
+            &radio_ctrl_core_3000_impl::get_readback64, this, this->send_readback(addr)));
+    }
+
     /*******************************************************************
      * Update methods for time
      ******************************************************************/
@@ -114,7 +164,27 @@ public:
     uhd::time_spec_t get_time(void)
     {
         boost::mutex::scoped_lock lock(_mutex);
-        return _time;
+        return (_held_owner == boost::this_thread::get_id())? _held_time : _time;
+    }
+
+    void hold_time(const uhd::time_spec_t &time)
+    {
+        _hold_mutex.lock();
+        boost::mutex::scoped_lock lock(_mutex);
+        _held_owner = boost::this_thread::get_id();
+        _held_time = time;
+        _held_use_time = _held_time != uhd::time_spec_t(0.0);
+        if (_held_use_time) _timeout = MASSIVE_TIMEOUT; //permanently sets larger timeout
+    }
+
+    void release_time(void)
+    {
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            UHD_ASSERT_THROW(_held_owner == boost::this_thread::get_id());
+            _held_owner = boost::thread::id();
+        }
+        _hold_mutex.unlock();
     }
 
     void set_tick_rate(const double rate)
@@ -130,11 +200,75 @@ private:
         boost::uint32_t data[8];
     };
 
+    //! The response to a readback that was sent but maybe not processed yet
+    struct readback_type
+    {
+        typedef boost::shared_ptr<readback_type> sptr;
+        readback_type(void): done(false), data(0){}
+        bool done;
+        boost::uint64_t data;
+    };
+
+    //! A packet that waits for its response
+    struct outstanding_type
+    {
+        outstanding_type(const size_t seq, readback_type::sptr readback):
+            seq(seq), readback(readback){}
+        size_t seq;
+        readback_type::sptr readback; //NULL for pokes
+    };
+
+    static UHD_INLINE boost::uint32_t select32(const boost::uint64_t res, const wb_addr_type addr)
+    {
+        const boost::uint32_t lo = boost::uint32_t(res & 0xffffffff);
+        const boost::uint32_t hi = boost::uint32_t(res >> 32);
+        return ((addr/4) & 0x1)? hi : lo;
+    }
+
     /*******************************************************************
-     * Primary control and interaction private methods
+     * Readback helpers for the pipelined peeks
      ******************************************************************/
-    UHD_INLINE void send_pkt(const boost::uint32_t addr, const boost::uint32_t data = 0)
+    readback_type::sptr send_readback(const wb_addr_type addr)
+    {
+        readback_type::sptr readback = boost::make_shared<readback_type>();
+        this->send_pkt(SR_READBACK, addr/8, readback);
+        this->wait_for_ack(false);
+        return readback;
+    }
+
+    boost::uint64_t wait_for_readback(readback_type::sptr readback)
+    {
+        while (not readback->done)
+        {
+            //an earlier response error already consumed the sequence
+            if (_outstanding_seqs.empty())
+            {
+                throw uhd::io_error(str(boost::format("Radio ctrl (%s) readback response lost") % _name));
+            }
+            this->recv_ack();
+        }
+        return readback->data;
+    }
+
+    boost::uint32_t get_readback32(readback_type::sptr readback, const wb_addr_type addr)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        return select32(this->wait_for_readback(readback), addr);
+    }
+
+    boost::uint64_t get_readback64(readback_type::sptr readback)
     {
+        boost::mutex::scoped_lock lock(_mutex);
+        return this->wait_for_readback(readback);
+    }
+
+    /*******************************************************************
+     * Primary control and interaction private methods
+     ******************************************************************/
+    UHD_INLINE void send_pkt(
+        const boost::uint32_t addr, const boost::uint32_t data = 0,
+        readback_type::sptr readback = readback_type::sptr()
+    ){
         managed_send_buffer::sptr buff = _ctrl_xport->get_send_buff(0.0);
         if (not buff) {
             throw uhd::runtime_error("fifo ctrl timed out getting a send buffer");
@@ -148,14 +282,16 @@ private:
         packet_info.num_payload_words32 = 2;
         packet_info.num_payload_bytes = packet_info.num_payload_words32*sizeof(boost::uint32_t);
         packet_info.packet_count = _seq_out;
-        packet_info.tsf = _time.to_ticks(_tick_rate);
+        //the thread holding a command time uses it, all others use the shared one
+        const bool held = _held_owner == boost::this_thread::get_id();
+        packet_info.tsf = (held ? _held_time : _time).to_ticks(_tick_rate);
         packet_info.sob = false;
         packet_info.eob = false;
         packet_info.sid = _sid;
         packet_info.has_sid = true;
         packet_info.has_cid = false;
         packet_info.has_tsi = false;
-        packet_info.has_tsf = _use_time;
+        packet_info.has_tsf = held ? _held_use_time : _use_time;
         packet_info.has_tlr = false;
 
         //load header
@@ -167,7 +303,7 @@ private:
         pkt[packet_info.num_header_words32+1] = (_bige)? uhd::htonx(data) : uhd::htowx(data);
         //UHD_MSG(status) << boost::format("0x%08x, 0x%08x\n") % addr % data;
         //send the buffer over the interface
-        _outstanding_seqs.push(_seq_out);
+        _outstanding_seqs.push(outstanding_type(_seq_out, readback));
         buff->commit(sizeof(boost::uint32_t)*(packet_info.num_packet_words32));
 
         _seq_out++;//inc seq for next call
@@ -177,109 +313,120 @@ private:
     {
         while (readback or (_outstanding_seqs.size() >= _resp_queue_size))
         {
-            //get seq to ack from outstanding packets list
-            UHD_ASSERT_THROW(not _outstanding_seqs.empty());
-            const size_t seq_to_ack = _outstanding_seqs.front();
-            _outstanding_seqs.pop();
-
-            //parse the packet
-            vrt::if_packet_info_t packet_info;
-            resp_buff_type resp_buff;
-            memset(&resp_buff, 0x00, sizeof(resp_buff));
-            boost::uint32_t const *pkt = NULL;
-            managed_recv_buffer::sptr buff;
-
-            //get buffer from response endpoint - or die in timeout
-            if (_resp_xport)
-            {
-                buff = _resp_xport->get_recv_buff(_timeout);
-                try
-                {
-                    UHD_ASSERT_THROW(bool(buff));
-                    UHD_ASSERT_THROW(buff->size() > 0);
-                }
-                catch(const std::exception &ex)
-                {
-                    throw uhd::io_error(str(boost::format("Radio ctrl (%s) no response packet - %s") % _name % ex.what()));
-                }
-                pkt = buff->cast<const boost::uint32_t *>();
-                packet_info.num_packet_words32 = buff->size()/sizeof(boost::uint32_t);
-            }
+            const boost::uint64_t data = this->recv_ack();
 
-            //get buffer from response endpoint - or die in timeout
-            else
-            {
-                /*
-                 * Couldn't get message with haste.
-                 * Now check both possible queues for messages.
-                 * Messages should come in on _resp_queue,
-                 * but could end up in dump_queue.
-                 * If we don't get a message --> Die in timeout.
-                 */
-                double accum_timeout = 0.0;
-                const double short_timeout = 0.005; // == 5ms
-                while(not ((_resp_queue.pop_with_haste(resp_buff))
-                        || (check_dump_queue(resp_buff))
-                        || (_resp_queue.pop_with_timed_wait(resp_buff, short_timeout))
-                        )){
-                    /*
-                     * If a message couldn't be received within a given timeout
-                     * --> throw AssertionError!
-                     */
-                    accum_timeout += short_timeout;
-                    UHD_ASSERT_THROW(accum_timeout < _timeout);
-                }
-
-                pkt = resp_buff.data;
-                packet_info.num_packet_words32 = sizeof(resp_buff)/sizeof(boost::uint32_t);
-            }
+            //return the readback value
+            if (readback and _outstanding_seqs.empty()) return data;
+        }
+
+        return 0;
+    }
+
+    boost::uint64_t recv_ack(void)
+    {
+        //get seq to ack from outstanding packets list
+        UHD_ASSERT_THROW(not _outstanding_seqs.empty());
+        const outstanding_type outstanding = _outstanding_seqs.front();
+        const size_t seq_to_ack = outstanding.seq;
+        _outstanding_seqs.pop();
+
+        //parse the packet
+        vrt::if_packet_info_t packet_info;
+        resp_buff_type resp_buff;
+        memset(&resp_buff, 0x00, sizeof(resp_buff));
+        boost::uint32_t const *pkt = NULL;
+        managed_recv_buffer::sptr buff;
 
-            //parse the buffer
+        //get buffer from response endpoint - or die in timeout
+        if (_resp_xport)
+        {
+            buff = _resp_xport->get_recv_buff(_timeout);
             try
             {
-                packet_info.link_type = _link_type;
-                if (_bige) vrt::if_hdr_unpack_be(pkt, packet_info);
-                else vrt::if_hdr_unpack_le(pkt, packet_info);
+                UHD_ASSERT_THROW(bool(buff));
+                UHD_ASSERT_THROW(buff->size() > 0);
             }
             catch(const std::exception &ex)
             {
-                UHD_MSG(error) << "Radio ctrl bad VITA packet: " << ex.what() << std::endl;
-                if (buff){
-                    UHD_VAR(buff->size());
-                }
-                else{
-                    UHD_MSG(status) << "buff is NULL" << std::endl;
-                }
-                UHD_MSG(status) << std::hex << pkt[0] << std::dec << std::endl;
-                UHD_MSG(status) << std::hex << pkt[1] << std::dec << std::endl;
-                UHD_MSG(status) << std::hex << pkt[2] << std::dec << std::endl;
-                UHD_MSG(status) << std::hex << pkt[3] << std::dec << std::endl;
+                throw uhd::io_error(str(boost::format("Radio ctrl (%s) no response packet - %s") % _name % ex.what()));
             }
+            pkt = buff->cast<const boost::uint32_t *>();
+            packet_info.num_packet_words32 = buff->size()/sizeof(boost::uint32_t);
+        }
 
-            //check the buffer
-            try
-            {
-                UHD_ASSERT_THROW(packet_info.has_sid);
-                UHD_ASSERT_THROW(packet_info.sid == boost::uint32_t((_sid >> 16) | (_sid << 16)));
-                UHD_ASSERT_THROW(packet_info.packet_count == (seq_to_ack & 0xfff));
-                UHD_ASSERT_THROW(packet_info.num_payload_words32 == 2);
-                UHD_ASSERT_THROW(packet_info.packet_type == _packet_type);
-            }
-            catch(const std::exception &ex)
-            {
-                throw uhd::io_error(str(boost::format("Radio ctrl (%s) packet parse error - %s") % _name % ex.what()));
+        //get buffer from response endpoint - or die in timeout
+        else
+        {
+            /*
+             * Couldn't get message with haste.
+             * Now check both possible queues for messages.
+             * Messages should come in on _resp_queue,
+             * but could end up in dump_queue.
+             * If we don't get a message --> Die in timeout.
+             */
+            double accum_timeout = 0.0;
+            const double short_timeout = 0.005; // == 5ms
+            while(not ((_resp_queue.pop_with_haste(resp_buff))
+                    || (check_dump_queue(resp_buff))
+                    || (_resp_queue.pop_with_timed_wait(resp_buff, short_timeout))
+                    )){
+                /*
+                 * If a message couldn't be received within a given timeout
+                 * --> throw AssertionError!
+                 */
+                accum_timeout += short_timeout;
+                UHD_ASSERT_THROW(accum_timeout < _timeout);
             }
 
-            //return the readback value
-            if (readback and _outstanding_seqs.empty())
-            {
-                const boost::uint64_t hi = (_bige)? uhd::ntohx(pkt[packet_info.num_header_words32+0]) : uhd::wtohx(pkt[packet_info.num_header_words32+0]);
-                const boost::uint64_t lo = (_bige)? uhd::ntohx(pkt[packet_info.num_header_words32+1]) : uhd::wtohx(pkt[packet_info.num_header_words32+1]);
-                return ((hi << 32) | lo);
+            pkt = resp_buff.data;
+            packet_info.num_packet_words32 = sizeof(resp_buff)/sizeof(boost::uint32_t);
+        }
+
+        //parse the buffer
+        try
+        {
+            packet_info.link_type = _link_type;
+            if (_bige) vrt::if_hdr_unpack_be(pkt, packet_info);
+            else vrt::if_hdr_unpack_le(pkt, packet_info);
+        }
+        catch(const std::exception &ex)
+        {
+            UHD_MSG(error) << "Radio ctrl bad VITA packet: " << ex.what() << std::endl;
+            if (buff){
+                UHD_VAR(buff->size());
+            }
+            else{
+                UHD_MSG(status) << "buff is NULL" << std::endl;
             }
+            UHD_MSG(status) << std::hex << pkt[0] << std::dec << std::endl;
+            UHD_MSG(status) << std::hex << pkt[1] << std::dec << std::endl;
+            UHD_MSG(status) << std::hex << pkt[2] << std::dec << std::endl;
+            UHD_MSG(status) << std::hex << pkt[3] << std::dec << std::endl;
         }
 
-        return 0;
+        //check the buffer
+        try
+        {
+            UHD_ASSERT_THROW(packet_info.has_sid);
+            UHD_ASSERT_THROW(packet_info.sid == boost::uint32_t((_sid >> 16) | (_sid << 16)));
+            UHD_ASSERT_THROW(packet_info.packet_count == (seq_to_ack & 0xfff));
+            UHD_ASSERT_THROW(packet_info.num_payload_words32 == 2);
+            UHD_ASSERT_THROW(packet_info.packet_type == _packet_type);
+        }
+        catch(const std::exception &ex)
+        {
+            throw uhd::io_error(str(boost::format("Radio ctrl (%s) packet parse error - %s") % _name % ex.what()));
+        }
+
+        //the readback value
+        const boost::uint64_t hi = (_bige)? uhd::ntohx(pkt[packet_info.num_header_words32+0]) : uhd::wtohx(pkt[packet_info.num_header_words32+0]);
+        const boost::uint64_t lo = (_bige)? uhd::ntohx(pkt[packet_info.num_header_words32+1]) : uhd::wtohx(pkt[packet_info.num_header_words32+1]);
+        if (outstanding.readback)
+        {
+            outstanding.readback->data = ((hi << 32) | lo);
+            outstanding.readback->done = true;
+        }
+        return ((hi << 32) | lo);
     }
 
     /*
@@ -327,12 +474,16 @@ private:
     const boost::uint32_t _sid;
     const std::string _name;
     boost::mutex _mutex;
+    boost::mutex _hold_mutex; //Held from hold_time() to release_time(), taken before _mutex
     size_t _seq_out;
     uhd::time_spec_t _time;
     bool _use_time;
+    boost::thread::id _held_owner;
+    uhd::time_spec_t _held_time;
+    bool _held_use_time;
     double _tick_rate;
     double _timeout;
-    std::queue<size_t> _outstanding_seqs;
+    std::queue<outstanding_type> _outstanding_seqs;
     bounded_buffer<resp_buff_type> _resp_queue;
     const size_t _resp_queue_size;
 };
@@ -23,9 +23,34 @@
 #include <uhd/transport/zero_copy.hpp>
 #include <uhd/types/wb_iface.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
 #include <boost/utility.hpp>
 #include <string>
 
+/*!
+ * The result of a readback that was sent without waiting for its response.
+ * get() blocks until the response arrived, processing the responses to
+ * all operations that were sent before the readback.
+ * A future must not outlive the control object that made it.
+ */
+template <typename T> class radio_ctrl_future
+{
+public:
+    typedef boost::function<T(void)> getter_type;
+
+    radio_ctrl_future(void){}
+    radio_ctrl_future(const getter_type &getter): _getter(getter){}
+
+    //! True if this future belongs to a readback
+    bool valid(void) const{return bool(_getter);}
+
+    //! Wait for the readback value, throws on a response error
+    T get(void) const{return _getter();}
+
+private:
+    getter_type _getter;
+};
+
 /*!
  * Provide access to peek, poke for the radio ctrl module
  */
@@ -57,8 +82,25 @@ public:
     //! Get the command time that will activate
     virtual uhd::time_spec_t get_time(void) = 0;
 
+    /*!
+     * Set a command time for the accesses of the calling thread only.
+     * Accesses from other threads keep the time of set_time().
+     * Only one thread holds a time at once, others wait in hold_time().
+     * Every hold_time() must be matched by a release_time().
+     */
+    virtual void hold_time(const uhd::time_spec_t &time) = 0;
+
+    //! Drop the command time of hold_time() and let the next thread hold one
+    virtual void release_time(void) = 0;
+
     //! Set the tick rate (converting time into ticks)
     virtual void set_tick_rate(const double rate) = 0;
+
+    //! Send a 32 bit readback and return without waiting for the response
+    virtual radio_ctrl_future<boost::uint32_t> peek32_async(const wb_addr_type addr) = 0;
+
+    //! Send a 64 bit readback and return without waiting for the response
+    virtual radio_ctrl_future<boost::uint64_t> peek64_async(const wb_addr_type addr) = 0;
 };
 
 #endif /* INCLUDED_LIBUHD_USRP_RADIO_CTRL_3000_HPP */
@@ -0,0 +1,262 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "wb_iface_tracer.hpp"
+#include <uhd/exception.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/utils/atomic.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/format.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <algorithm>
+#include <sstream>
+#include <map>
+
+using namespace uhd;
+
+wb_iface_tracer::~wb_iface_tracer(void){
+    /* NOP */
+}
+
+std::string wb_iface_tracer::op_to_string(const op_type op){
+    switch(op){
+    case OP_PEEK16: return "peek16";
+    case OP_POKE16: return "poke16";
+    case OP_PEEK32: return "peek32";
+    case OP_POKE32: return "poke32";
+    case OP_PEEK64: return "peek64";
+    case OP_POKE64: return "poke64";
+    case OP_PEEK32_BATCH: return "peek32_batch";
+    case OP_POKE32_BATCH: return "poke32_batch";
+    }
+    return "unknown";
+}
+
+class wb_iface_tracer_impl : public wb_iface_tracer{
+public:
+    wb_iface_tracer_impl(wb_iface::sptr iface, const size_t capacity):
+        _iface(iface),
+        _timed_iface(boost::dynamic_pointer_cast<timed_wb_iface>(iface)),
+        _t0(time_spec_t::get_system_time())
+    {
+        size_t size = 1;
+        while (size < capacity) size *= 2;
+        _ring.reset(new slot_type[size]);
+        _mask = size - 1;
+        _start.write(0);
+        _next.write(0);
+    }
+
+    /*******************************************************************
+     * Traced peeks and pokes
+     ******************************************************************/
+    void poke64(const wb_addr_type addr, const boost::uint64_t data){
+        const time_spec_t start = time_spec_t::get_system_time();
+        _iface->poke64(addr, data);
+        this->record(OP_POKE64, addr, data, start);
+    }
+
+    boost::uint64_t peek64(const wb_addr_type addr){
+        const time_spec_t start = time_spec_t::get_system_time();
+        const boost::uint64_t data = _iface->peek64(addr);
+        this->record(OP_PEEK64, addr, data, start);
+        return data;
+    }
+
+    void poke32(const wb_addr_type addr, const boost::uint32_t data){
+        const time_spec_t start = time_spec_t::get_system_time();
+        _iface->poke32(addr, data);
+        this->record(OP_POKE32, addr, data, start);
+    }
+
+    boost::uint32_t peek32(const wb_addr_type addr){
+        const time_spec_t start = time_spec_t::get_system_time();
+        const boost::uint32_t data = _iface->peek32(addr);
+        this->record(OP_PEEK32, addr, data, start);
+        return data;
+    }
+
+    void poke16(const wb_addr_type addr, const boost::uint16_t data){
+        const time_spec_t start = time_spec_t::get_system_time();
+        _iface->poke16(addr, data);
+        this->record(OP_POKE16, addr, data, start);
+    }
+
+    boost::uint16_t peek16(const wb_addr_type addr){
+        const time_spec_t start = time_spec_t::get_system_time();
+        const boost::uint16_t data = _iface->peek16(addr);
+        this->record(OP_PEEK16, addr, data, start);
+        return data;
+    }
+
+    void poke32_batch(const poke32_batch_type &pokes){
+        if (pokes.empty()) return;
+        const time_spec_t start = time_spec_t::get_system_time();
+        _iface->poke32_batch(pokes);
+        this->record(OP_POKE32_BATCH, pokes.front().first, pokes.size(), start);
+    }
+
+    std::vector<boost::uint32_t> peek32_batch(const std::vector<wb_addr_type> &addrs){
+        if (addrs.empty()) return std::vector<boost::uint32_t>();
+        const time_spec_t start = time_spec_t::get_system_time();
+        const std::vector<boost::uint32_t> data = _iface->peek32_batch(addrs);
+        this->record(OP_PEEK32_BATCH, addrs.front(), addrs.size(), start);
+        return data;
+    }
+
+    /*******************************************************************
+     * Command time is forwarded as is
+     ******************************************************************/
+    time_spec_t get_time(void){
+        if (not _timed_iface) throw uhd::not_implemented_error("wb_iface_tracer: the traced interface has no command time");
+        return _timed_iface->get_time();
+    }
+
+    void set_time(const time_spec_t &t){
+        if (not _timed_iface) throw uhd::not_implemented_error("wb_iface_tracer: the traced interface has no command time");
+        _timed_iface->set_time(t);
+    }
+
+    /*******************************************************************
+     * Record access
+     ******************************************************************/
+    std::vector<record_type> get_records(void){
+        const boost::uint32_t next = _next.read();
+        boost::uint32_t first = _start.read();
+        if (next - first > _mask + 1) first = next - (_mask + 1);
+
+        std::vector<record_type> records;
+        records.reserve(next - first);
+        for (boost::uint32_t n = first; n != next; n++){
+            slot_type &slot = _ring[n & _mask];
+            //a writer may be filling the slot, keep it only if its sequence held still
+            if (slot.seq.read() != n + 1) continue;
+            const record_type record = slot.record;
+            if (slot.seq.read() != n + 1) continue;
+            records.push_back(record);
+        }
+        return records;
+    }
+
+    size_t get_num_accesses(void){
+        return _next.read() - _start.read();
+    }
+
+    void clear(void){
+        _start.write(_next.read());
+    }
+
+    std::string get_summary(void){
+        const std::vector<record_type> records = this->get_records();
+
+        std::map<op_type, stats_type> op_stats;
+        std::map<wb_addr_type, size_t> addr_counts;
+        BOOST_FOREACH(const record_type &record, records){
+            stats_type &stats = op_stats[record.op];
+            stats.count++;
+            stats.total += record.latency;
+            stats.max = std::max(stats.max, record.latency);
+            addr_counts[record.addr]++;
+        }
+
+        std::ostringstream ss;
+        ss << boost::format("%u accesses, %u recorded") % this->get_num_accesses() % records.size() << std::endl;
+        ss << boost::format("%-14s %8s %12s %12s %12s") % "operation" % "count" % "total (us)" % "avg (us)" % "max (us)" << std::endl;
+        typedef std::map<op_type, stats_type>::value_type op_stats_pair;
+        BOOST_FOREACH(const op_stats_pair &p, op_stats){
+            ss << boost::format("%-14s %8u %12.1f %12.1f %12.1f")
+                % op_to_string(p.first) % p.second.count % (p.second.total*1e6)
+                % (p.second.total*1e6/p.second.count) % (p.second.max*1e6) << std::endl;
+        }
+
+        //the busiest addresses first
+        std::vector<std::pair<size_t, wb_addr_type> > busiest;
+        typedef std::map<wb_addr_type, size_t>::value_type addr_count_pair;
+        BOOST_FOREACH(const addr_count_pair &p, addr_counts){
+            busiest.push_back(std::make_pair(p.second, p.first));
+        }
+        std::sort(busiest.rbegin(), busiest.rend());
+        if (busiest.size() > 10) busiest.resize(10);
+        ss << boost::format("%-14s %8s") % "address" % "count" << std::endl;
+        for (size_t i = 0; i < busiest.size(); i++){
+            ss << boost::format("0x%08x     %8u") % busiest[i].second % busiest[i].first << std::endl;
+        }
+        return ss.str();
+    }
+
+    std::string get_records_csv(void){
+        std::ostringstream ss;
+        ss << "time,operation,address,data,latency" << std::endl;
+        BOOST_FOREACH(const record_type &record, this->get_records()){
+            ss << boost::format("%.9f,%s,0x%08x,0x%x,%.9f")
+                % record.time % op_to_string(record.op) % record.addr % record.data % record.latency << std::endl;
+        }
+        return ss.str();
+    }
+
+    void populate_subtree(property_tree::sptr subtree){
+        subtree->create<std::string>("summary")
+            .set_publisher(boost::bind(&wb_iface_tracer::get_summary, this));
+        subtree->create<std::string>("records")
+            .set_publisher(boost::bind(&wb_iface_tracer::get_records_csv, this));
+        subtree->create<bool>("clear")
+            .set(false)
+            .add_coerced_subscriber(boost::bind(&wb_iface_tracer_impl::clear_on_true, this, _1));
+    }
+
+private:
+    struct stats_type{
+        stats_type(void): count(0), total(0.0), max(0.0){}
+        size_t count;
+        double total, max;
+    };
+
+    struct slot_type{
+        uhd::atomic_uint32_t seq; //access number + 1 when the record is complete
+        record_type record;
+    };
+
+    void record(const op_type op, const wb_addr_type addr, const boost::uint64_t data, const time_spec_t &start){
+        const time_spec_t now = time_spec_t::get_system_time();
+        const boost::uint32_t n = _next.inc();
+        slot_type &slot = _ring[n & _mask];
+        slot.seq.write(0);
+        slot.record.op = op;
+        slot.record.addr = addr;
+        slot.record.data = data;
+        slot.record.time = (start - _t0).get_real_secs();
+        slot.record.latency = (now - start).get_real_secs();
+        slot.seq.write(n + 1);
+    }
+
+    void clear_on_true(const bool clear){
+        if (clear) this->clear();
+    }
+
+    const wb_iface::sptr _iface;
+    const timed_wb_iface::sptr _timed_iface;
+    const time_spec_t _t0;
+    boost::scoped_array<slot_type> _ring;
+    boost::uint32_t _mask;
+    uhd::atomic_uint32_t _start; //access number of the first access since the last clear
+    uhd::atomic_uint32_t _next; //access number of the next access
+};
+
+wb_iface_tracer::sptr wb_iface_tracer::make(wb_iface::sptr iface, const size_t capacity){
+    return sptr(new wb_iface_tracer_impl(iface, capacity));
+}
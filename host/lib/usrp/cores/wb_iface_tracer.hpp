@@ -0,0 +1,93 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INCLUDED_LIBUHD_USRP_WB_IFACE_TRACER_HPP
+#define INCLUDED_LIBUHD_USRP_WB_IFACE_TRACER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/wb_iface.hpp>
+#include <uhd/property_tree.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <vector>
+
+/*!
+ * Register access tracer:
+ * Wraps a wb_iface, forwards every peek and poke and records the
+ * operation, address, data, start time and latency of each one.
+ * Records go into a ring of fixed size without taking a lock,
+ * so the ring always holds the most recent accesses.
+ */
+class UHD_API wb_iface_tracer : public uhd::timed_wb_iface
+{
+public:
+    typedef boost::shared_ptr<wb_iface_tracer> sptr;
+
+    enum op_type
+    {
+        OP_PEEK16,
+        OP_POKE16,
+        OP_PEEK32,
+        OP_POKE32,
+        OP_PEEK64,
+        OP_POKE64,
+        OP_PEEK32_BATCH,
+        OP_POKE32_BATCH
+    };
+
+    struct record_type
+    {
+        op_type op;
+        wb_addr_type addr;      //the first address for a batch
+        boost::uint64_t data;   //the number of registers for a batch
+        double time;            //start time in seconds since the tracer was made
+        double latency;         //in seconds
+    };
+
+    virtual ~wb_iface_tracer(void) = 0;
+
+    /*!
+     * Make a new tracer around iface.
+     * get_time() and set_time() are forwarded when iface is a timed_wb_iface.
+     * \param iface the interface to trace
+     * \param capacity the number of records kept, rounded up to a power of two
+     */
+    static sptr make(uhd::wb_iface::sptr iface, const size_t capacity = 4096);
+
+    //! Get the name of an operation
+    static std::string op_to_string(const op_type op);
+
+    //! Get the recorded accesses since the last clear, oldest first
+    virtual std::vector<record_type> get_records(void) = 0;
+
+    //! Get the number of accesses since the last clear, also those no longer in the ring
+    virtual size_t get_num_accesses(void) = 0;
+
+    //! Forget all accesses made so far
+    virtual void clear(void) = 0;
+
+    //! Get a table of the count and latency per operation, and the busiest addresses
+    virtual std::string get_summary(void) = 0;
+
+    //! Get the records as comma separated values
+    virtual std::string get_records_csv(void) = 0;
+
+    //! Publish the summary, the records and a clear control in the property tree
+    virtual void populate_subtree(uhd::property_tree::sptr subtree) = 0;
+};
+
+#endif /* INCLUDED_LIBUHD_USRP_WB_IFACE_TRACER_HPP */
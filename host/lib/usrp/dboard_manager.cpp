@@ -177,18 +177,23 @@ public:
         dboard_id_t rx_dboard_id,
         dboard_id_t tx_dboard_id,
         dboard_iface::sptr iface,
-        property_tree::sptr subtree
+        property_tree::sptr subtree,
+        const bool defer_init
     );
     ~dboard_manager_impl(void);
 
 private:
     void init(dboard_id_t, dboard_id_t, property_tree::sptr);
+    void make_subdev(dboard_ctor_t, const dboard_ctor_args_t &, property_tree::sptr, const bool rx, const bool tx);
+    void make_subdev_once(boost::shared_ptr<bool>, dboard_ctor_t, const dboard_ctor_args_t &, const bool rx, const bool tx);
+    void make_subdev_now(dboard_ctor_t, const dboard_ctor_args_t &, const bool rx, const bool tx);
     //list of rx and tx dboards in this dboard_manager
     //each dboard here is actually a subdevice proxy
     //the subdevice proxy is internal to the cpp file
     uhd::dict<std::string, dboard_base::sptr> _rx_dboards;
     uhd::dict<std::string, dboard_base::sptr> _tx_dboards;
     dboard_iface::sptr _iface;
+    const bool _defer_init;
     void set_nice_dboard_if(void);
 };
 
@@ -200,13 +205,14 @@ dboard_manager::sptr dboard_manager::make(
     dboard_id_t tx_dboard_id,
     dboard_id_t gdboard_id,
     dboard_iface::sptr iface,
-    property_tree::sptr subtree
+    property_tree::sptr subtree,
+    const bool defer_init
 ){
     return dboard_manager::sptr(
         new dboard_manager_impl(
             rx_dboard_id,
             (gdboard_id == dboard_id_t::none())? tx_dboard_id : gdboard_id,
-            iface, subtree
+            iface, subtree, defer_init
         )
     );
 }
@@ -218,9 +224,10 @@ dboard_manager_impl::dboard_manager_impl(
     dboard_id_t rx_dboard_id,
     dboard_id_t tx_dboard_id,
     dboard_iface::sptr iface,
-    property_tree::sptr subtree
+    property_tree::sptr subtree,
+    const bool defer_init
 ):
-    _iface(iface)
+    _iface(iface), _defer_init(defer_init)
 {
     try{
         this->init(rx_dboard_id, tx_dboard_id, subtree);
@@ -292,9 +299,7 @@ void dboard_manager_impl::init(
             db_ctor_args.tx_id = tx_dboard_id;
             db_ctor_args.rx_subtree = subtree->subtree("rx_frontends/" + subdev);
             db_ctor_args.tx_subtree = subtree->subtree("tx_frontends/" + subdev);
-            dboard_base::sptr xcvr_dboard = dboard_ctor(&db_ctor_args);
-            _rx_dboards[subdev] = xcvr_dboard;
-            _tx_dboards[subdev] = xcvr_dboard;
+            this->make_subdev(dboard_ctor, db_ctor_args, subtree, true, true);
         }
     }
 
@@ -317,7 +322,7 @@ void dboard_manager_impl::init(
             db_ctor_args.tx_id = dboard_id_t::none();
             db_ctor_args.rx_subtree = subtree->subtree("rx_frontends/" + subdev);
             db_ctor_args.tx_subtree = property_tree::sptr(); //null
-            _rx_dboards[subdev] = rx_dboard_ctor(&db_ctor_args);
+            this->make_subdev(rx_dboard_ctor, db_ctor_args, subtree, true, false);
         }
 
         //force the tx key to the unknown board for bad combinations
@@ -336,11 +341,49 @@ void dboard_manager_impl::init(
             db_ctor_args.tx_id = tx_dboard_id;
             db_ctor_args.rx_subtree = property_tree::sptr(); //null
             db_ctor_args.tx_subtree = subtree->subtree("tx_frontends/" + subdev);
-            _tx_dboards[subdev] = tx_dboard_ctor(&db_ctor_args);
+            this->make_subdev(tx_dboard_ctor, db_ctor_args, subtree, false, true);
         }
     }
 }
 
+void dboard_manager_impl::make_subdev(
+    dboard_ctor_t dboard_ctor, const dboard_ctor_args_t &db_ctor_args,
+    property_tree::sptr subtree, const bool rx, const bool tx
+){
+    if (not _defer_init){
+        this->make_subdev_now(dboard_ctor, db_ctor_args, rx, tx);
+        return;
+    }
+
+    //make the subdev on first use of its frontend, xcvr subdevs through either one
+    const property_tree::lazy_init_type make_fcn = boost::bind(
+        &dboard_manager_impl::make_subdev_once, this,
+        boost::shared_ptr<bool>(new bool(false)), dboard_ctor, db_ctor_args, rx, tx);
+    if (rx) subtree->create_lazy("rx_frontends/" + db_ctor_args.sd_name, make_fcn);
+    if (tx) subtree->create_lazy("tx_frontends/" + db_ctor_args.sd_name, make_fcn);
+}
+
+void dboard_manager_impl::make_subdev_once(
+    boost::shared_ptr<bool> started, dboard_ctor_t dboard_ctor,
+    const dboard_ctor_args_t &db_ctor_args, const bool rx, const bool tx
+){
+    //started before the ctor runs, so a xcvr subdev is made only once,
+    //even if its ctor uses the other frontend or throws
+    if (*started) return;
+    *started = true;
+    this->make_subdev_now(dboard_ctor, db_ctor_args, rx, tx);
+}
+
+void dboard_manager_impl::make_subdev_now(
+    dboard_ctor_t dboard_ctor, const dboard_ctor_args_t &db_ctor_args,
+    const bool rx, const bool tx
+){
+    dboard_ctor_args_t args = db_ctor_args;
+    dboard_base::sptr dboard = dboard_ctor(&args);
+    if (rx) _rx_dboards[db_ctor_args.sd_name] = dboard;
+    if (tx) _tx_dboards[db_ctor_args.sd_name] = dboard;
+}
+
 dboard_manager_impl::~dboard_manager_impl(void){UHD_SAFE_CALL(
     set_nice_dboard_if();
 )}
@@ -153,7 +153,7 @@ rx_streamer::sptr e100_impl::get_rx_stream(const uhd::stream_args_t &args_){
     id.num_inputs = 1;
     id.output_format = args.cpu_format;
     id.num_outputs = 1;
-    my_streamer->set_converter(id);
+    my_streamer->set_converter(id, args.args);
 
     //bind callbacks for the handler
     for (size_t chan_i = 0; chan_i < args.channels.size(); chan_i++){
@@ -212,7 +212,7 @@ tx_streamer::sptr e100_impl::get_tx_stream(const uhd::stream_args_t &args_){
     id.num_inputs = 1;
     id.output_format = args.otw_format + "_item32_le";
     id.num_outputs = 1;
-    my_streamer->set_converter(id);
+    my_streamer->set_converter(id, args.args);
 
     //bind callbacks for the handler
     for (size_t chan_i = 0; chan_i < args.channels.size(); chan_i++){
@@ -467,7 +467,7 @@ rx_streamer::sptr e300_impl::get_rx_stream(const uhd::stream_args_t &args_)
         id.num_inputs = 1;
         id.output_format = args.cpu_format;
         id.num_outputs = 1;
-        my_streamer->set_converter(id);
+        my_streamer->set_converter(id, args.args);
 
         perif.framer->clear();
         perif.framer->set_nsamps_per_packet(spp); //seems to be a good place to set this
@@ -581,7 +581,7 @@ tx_streamer::sptr e300_impl::get_tx_stream(const uhd::stream_args_t &args_)
         id.num_inputs = 1;
         id.output_format = args.otw_format + "_item32_le";
         id.num_outputs = 1;
-        my_streamer->set_converter(id);
+        my_streamer->set_converter(id, args.args);
 
         perif.deframer->clear();
         perif.deframer->setup(args);
@@ -27,13 +27,18 @@
 #include <uhd/usrp/dboard_eeprom.hpp>
 #include <uhd/convert.hpp>
 #include <uhd/utils/soft_register.hpp>
+#include <uhd/utils/atomic.hpp>
 #include <boost/assign/list_of.hpp>
 #include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
 #include <boost/foreach.hpp>
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
 #include <algorithm>
 #include <cmath>
+#include <map>
+#include <set>
 
 using namespace uhd;
 using namespace uhd::usrp;
@@ -229,6 +234,27 @@ static gain_fcns_t make_gain_fcns_from_subtree(property_tree::sptr subtree){
 static const double RX_SIGN = +1.0;
 static const double TX_SIGN = -1.0;
 
+static double get_auto_lo_offset(
+    property_tree::sptr dsp_subtree,
+    property_tree::sptr rf_fe_subtree
+){
+    double lo_offset = 0.0;
+    if (rf_fe_subtree->access<bool>("use_lo_offset").get()){
+        // If the frontend has lo_offset value and range properties, trust it
+        // for lo_offset
+        if (rf_fe_subtree->exists("lo_offset/value")) {
+            lo_offset = rf_fe_subtree->access<double>("lo_offset/value").get();
+        }
+
+        //If the local oscillator will be in the passband, use an offset.
+        //But constrain the LO offset by the width of the filter bandwidth.
+        const double rate = dsp_subtree->access<double>("rate/value").get();
+        const double bw = rf_fe_subtree->access<double>("bandwidth/value").get();
+        if (bw > rate) lo_offset = std::min((bw - rate)/2, rate/2);
+    }
+    return lo_offset;
+}
+
 static tune_result_t tune_xx_subdev_and_dsp(
     const double xx_sign,
     property_tree::sptr dsp_subtree,
@@ -259,20 +285,7 @@ static tune_result_t tune_xx_subdev_and_dsp(
      * user should specify the MANUAL tune policy and lo_offset as part of the
      * tune_request. This lo_offset is based on the requirements of the FE, and
      * does not reflect a user-requested lo_offset, which is handled later. */
-    double lo_offset = 0.0;
-    if (rf_fe_subtree->access<bool>("use_lo_offset").get()){
-        // If the frontend has lo_offset value and range properties, trust it
-        // for lo_offset
-        if (rf_fe_subtree->exists("lo_offset/value")) {
-            lo_offset = rf_fe_subtree->access<double>("lo_offset/value").get();
-        }
-
-        //If the local oscillator will be in the passband, use an offset.
-        //But constrain the LO offset by the width of the filter bandwidth.
-        const double rate = dsp_subtree->access<double>("rate/value").get();
-        const double bw = rf_fe_subtree->access<double>("bandwidth/value").get();
-        if (bw > rate) lo_offset = std::min((bw - rate)/2, rate/2);
-    }
+    const double lo_offset = get_auto_lo_offset(dsp_subtree, rf_fe_subtree);
 
     //------------------------------------------------------------------
     //-- poke the tune request args into the dboard
@@ -370,12 +383,12 @@ static tune_result_t tune_xx_subdev_and_dsp(
 
 static double derive_freq_from_xx_subdev_and_dsp(
     const double xx_sign,
-    property_tree::sptr dsp_subtree,
-    property_tree::sptr rf_fe_subtree
+    const property<double> &dsp_freq,
+    const property<double> &rf_fe_freq
 ){
     //extract actual dsp and IF frequencies
-    const double actual_rf_freq = rf_fe_subtree->access<double>("freq/value").get();
-    const double actual_dsp_freq = dsp_subtree->access<double>("freq/value").get();
+    const double actual_rf_freq = rf_fe_freq.get();
+    const double actual_dsp_freq = dsp_freq.get();
 
     //invert the sign on the dsp freq for transmit
     return actual_rf_freq - actual_dsp_freq * xx_sign;
@@ -386,9 +399,28 @@ static double derive_freq_from_xx_subdev_and_dsp(
  **********************************************************************/
 class multi_usrp_impl : public multi_usrp{
 public:
-    multi_usrp_impl(const device_addr_t &addr){
+    multi_usrp_impl(const device_addr_t &addr):
+        _cache_gen(new uhd::atomic_uint32_t()),
+        _cache_gen_seen(0)
+    {
         _dev = device::make(addr, device::USRP);
         _tree = _dev->get_tree();
+
+        //drop the resolved paths when the channel layout changes
+        BOOST_FOREACH(const std::string &name, _tree->list("/mboards")){
+            const fs_path mb_path = "/mboards/" + name;
+            for (size_t is_tx = 0; is_tx < 2; is_tx++){
+                const std::string dir = is_tx? "tx" : "rx";
+                if (_tree->exists(mb_path / (dir + "_subdev_spec"))){
+                    _tree->access<subdev_spec_t>(mb_path / (dir + "_subdev_spec"))
+                        .add_coerced_subscriber(boost::bind(&multi_usrp_impl::bump_cache_gen, _cache_gen));
+                }
+                if (_tree->exists(mb_path / (dir + "_chan_dsp_mapping"))){
+                    _tree->access<std::vector<size_t> >(mb_path / (dir + "_chan_dsp_mapping"))
+                        .add_coerced_subscriber(boost::bind(&multi_usrp_impl::bump_cache_gen, _cache_gen));
+                }
+            }
+        }
     }
 
     device::sptr get_device(void){
@@ -605,6 +637,14 @@ public:
         }
     }
 
+    void set_rx_hop_schedule(const hop_schedule_t &schedule){
+        this->set_xx_hop_schedule(schedule, false);
+    }
+
+    void set_tx_hop_schedule(const hop_schedule_t &schedule){
+        this->set_xx_hop_schedule(schedule, true);
+    }
+
     void issue_stream_cmd(const stream_cmd_t &stream_cmd, size_t chan){
         if (chan != ALL_CHANS){
             _tree->access<stream_cmd_t>(rx_dsp_root(chan) / "stream_cmd").set(stream_cmd);
@@ -790,17 +830,29 @@ public:
 
     void set_rx_rate(double rate, size_t chan){
         if (chan != ALL_CHANS){
-            _tree->access<double>(rx_dsp_root(chan) / "rate" / "value").set(rate);
+            chan_prop(chan, false, PROP_DSP_RATE).set(rate);
             do_samp_rate_warning_message(rate, get_rx_rate(chan), "RX");
             return;
         }
+        //one commit, so the rate dependent settings of all channels settle once
+        _tree->begin_transaction();
+        try{
+            for (size_t c = 0; c < get_rx_num_channels(); c++){
+                chan_prop(c, false, PROP_DSP_RATE).set(rate);
+            }
+        }
+        catch(...){
+            _tree->commit_transaction();
+            throw;
+        }
+        _tree->commit_transaction();
         for (size_t c = 0; c < get_rx_num_channels(); c++){
-            set_rx_rate(rate, c);
+            do_samp_rate_warning_message(rate, get_rx_rate(c), "RX");
         }
     }
 
     double get_rx_rate(size_t chan){
-        return _tree->access<double>(rx_dsp_root(chan) / "rate" / "value").get();
+        return chan_prop(chan, false, PROP_DSP_RATE).get();
     }
 
     meta_range_t get_rx_rates(size_t chan){
@@ -817,7 +869,7 @@ public:
     }
 
     double get_rx_freq(size_t chan){
-        return derive_freq_from_xx_subdev_and_dsp(RX_SIGN, _tree->subtree(rx_dsp_root(chan)), _tree->subtree(rx_rf_fe_root(chan)));
+        return derive_freq_from_xx_subdev_and_dsp(RX_SIGN, chan_prop(chan, false, PROP_DSP_FREQ), chan_prop(chan, false, PROP_RF_FREQ));
     }
 
     freq_range_t get_rx_freq_range(size_t chan){
@@ -1150,17 +1202,29 @@ public:
 
     void set_tx_rate(double rate, size_t chan){
         if (chan != ALL_CHANS){
-            _tree->access<double>(tx_dsp_root(chan) / "rate" / "value").set(rate);
+            chan_prop(chan, true, PROP_DSP_RATE).set(rate);
             do_samp_rate_warning_message(rate, get_tx_rate(chan), "TX");
             return;
         }
+        //one commit, so the rate dependent settings of all channels settle once
+        _tree->begin_transaction();
+        try{
+            for (size_t c = 0; c < get_tx_num_channels(); c++){
+                chan_prop(c, true, PROP_DSP_RATE).set(rate);
+            }
+        }
+        catch(...){
+            _tree->commit_transaction();
+            throw;
+        }
+        _tree->commit_transaction();
         for (size_t c = 0; c < get_tx_num_channels(); c++){
-            set_tx_rate(rate, c);
+            do_samp_rate_warning_message(rate, get_tx_rate(c), "TX");
         }
     }
 
     double get_tx_rate(size_t chan){
-        return _tree->access<double>(tx_dsp_root(chan) / "rate" / "value").get();
+        return chan_prop(chan, true, PROP_DSP_RATE).get();
     }
 
     meta_range_t get_tx_rates(size_t chan){
@@ -1177,7 +1241,7 @@ public:
     }
 
     double get_tx_freq(size_t chan){
-        return derive_freq_from_xx_subdev_and_dsp(TX_SIGN, _tree->subtree(tx_dsp_root(chan)), _tree->subtree(tx_rf_fe_root(chan)));
+        return derive_freq_from_xx_subdev_and_dsp(TX_SIGN, chan_prop(chan, true, PROP_DSP_FREQ), chan_prop(chan, true, PROP_RF_FREQ));
     }
 
     freq_range_t get_tx_freq_range(size_t chan){
@@ -1502,8 +1566,148 @@ private:
         mboard_chan_pair(void): mboard(0), chan(0){}
     };
 
+    /*******************************************************************
+     * Resolved path cache:
+     * Channel mappings, roots and gain groups are resolved once per
+     * channel instead of walking the tree on every call.
+     * The properties used on every rate and frequency call are kept
+     * as handles, so those calls do not look up the tree at all.
+     * Subscribers on the subdev specs and the dsp mappings bump the
+     * generation, which drops the whole cache on the next lookup.
+     * A result is only stored when the generation did not change
+     * while it was being resolved.
+     ******************************************************************/
+    enum root_type{ROOT_DSP, ROOT_FE, ROOT_RF_FE, NUM_ROOTS};
+    enum prop_type{PROP_DSP_RATE, PROP_DSP_FREQ, PROP_RF_FREQ, NUM_PROPS};
+
+    struct chan_cache_t{
+        chan_cache_t(void): has_mcp(false){
+            std::fill(props, props + NUM_PROPS, static_cast<property<double> *>(NULL));
+        }
+        bool has_mcp;
+        mboard_chan_pair mcp;
+        fs_path roots[NUM_ROOTS];
+        property<double> *props[NUM_PROPS];
+        gain_group::sptr gg;
+    };
+
+    boost::mutex _cache_mutex;
+    boost::shared_ptr<uhd::atomic_uint32_t> _cache_gen;
+    boost::uint32_t _cache_gen_seen;
+    std::vector<fs_path> _mb_roots;
+    std::vector<chan_cache_t> _chan_caches[2]; //indexed by is_tx
+
+    static void bump_cache_gen(boost::shared_ptr<uhd::atomic_uint32_t> gen){
+        gen->inc();
+    }
+
+    //! Get the cache entry for reading, when present (lock held by caller)
+    const chan_cache_t *find_chan_cache(const size_t chan, const bool is_tx){
+        const boost::uint32_t gen = _cache_gen->read();
+        if (gen != _cache_gen_seen){
+            _chan_caches[0].clear();
+            _chan_caches[1].clear();
+            _cache_gen_seen = gen;
+        }
+        const std::vector<chan_cache_t> &caches = _chan_caches[is_tx? 1 : 0];
+        return (chan < caches.size())? &caches[chan] : NULL;
+    }
+
+    //! Get the cache entry for writing, NULL when it went stale (lock held by caller)
+    chan_cache_t *store_chan_cache(const size_t chan, const bool is_tx, const boost::uint32_t gen){
+        this->find_chan_cache(chan, is_tx);
+        if (gen != _cache_gen_seen) return NULL;
+        std::vector<chan_cache_t> &caches = _chan_caches[is_tx? 1 : 0];
+        if (caches.size() <= chan) caches.resize(chan + 1);
+        return &caches[chan];
+    }
+
+    bool get_cached_mcp(const size_t chan, const bool is_tx, mboard_chan_pair &mcp){
+        boost::mutex::scoped_lock lock(_cache_mutex);
+        const chan_cache_t *cache = this->find_chan_cache(chan, is_tx);
+        if (cache == NULL or not cache->has_mcp) return false;
+        mcp = cache->mcp;
+        return true;
+    }
+
+    void set_cached_mcp(const size_t chan, const bool is_tx, const boost::uint32_t gen, const mboard_chan_pair &mcp){
+        boost::mutex::scoped_lock lock(_cache_mutex);
+        chan_cache_t *cache = this->store_chan_cache(chan, is_tx, gen);
+        if (cache == NULL) return;
+        cache->mcp = mcp;
+        cache->has_mcp = true;
+    }
+
+    bool get_cached_root(const size_t chan, const bool is_tx, const root_type which, fs_path &root){
+        boost::mutex::scoped_lock lock(_cache_mutex);
+        const chan_cache_t *cache = this->find_chan_cache(chan, is_tx);
+        if (cache == NULL or cache->roots[which].empty()) return false;
+        root = cache->roots[which];
+        return true;
+    }
+
+    fs_path set_cached_root(const size_t chan, const bool is_tx, const root_type which, const boost::uint32_t gen, const fs_path &root){
+        boost::mutex::scoped_lock lock(_cache_mutex);
+        chan_cache_t *cache = this->store_chan_cache(chan, is_tx, gen);
+        if (cache != NULL) cache->roots[which] = root;
+        return root;
+    }
+
+    property<double> *get_cached_prop(const size_t chan, const bool is_tx, const prop_type which){
+        boost::mutex::scoped_lock lock(_cache_mutex);
+        const chan_cache_t *cache = this->find_chan_cache(chan, is_tx);
+        return (cache == NULL)? NULL : cache->props[which];
+    }
+
+    void set_cached_prop(const size_t chan, const bool is_tx, const prop_type which, const boost::uint32_t gen, property<double> *prop){
+        boost::mutex::scoped_lock lock(_cache_mutex);
+        chan_cache_t *cache = this->store_chan_cache(chan, is_tx, gen);
+        if (cache != NULL) cache->props[which] = prop;
+    }
+
+    /*!
+     * Get a property of a channel from its cached handle.
+     * The device never removes properties from its tree,
+     * so a handle stays valid until the channel layout changes.
+     */
+    property<double> &chan_prop(const size_t chan, const bool is_tx, const prop_type which){
+        property<double> *prop = get_cached_prop(chan, is_tx, which);
+        if (prop != NULL) return *prop;
+        const boost::uint32_t gen = _cache_gen->read();
+        fs_path path;
+        switch (which){
+        case PROP_DSP_RATE:
+            path = (is_tx? tx_dsp_root(chan) : rx_dsp_root(chan)) / "rate" / "value";
+            break;
+        case PROP_DSP_FREQ:
+            path = (is_tx? tx_dsp_root(chan) : rx_dsp_root(chan)) / "freq" / "value";
+            break;
+        default:
+            path = (is_tx? tx_rf_fe_root(chan) : rx_rf_fe_root(chan)) / "freq" / "value";
+            break;
+        }
+        prop = &_tree->access<double>(path);
+        set_cached_prop(chan, is_tx, which, gen, prop);
+        return *prop;
+    }
+
+    gain_group::sptr get_cached_gain_group(const size_t chan, const bool is_tx){
+        boost::mutex::scoped_lock lock(_cache_mutex);
+        const chan_cache_t *cache = this->find_chan_cache(chan, is_tx);
+        return (cache == NULL)? gain_group::sptr() : cache->gg;
+    }
+
+    gain_group::sptr set_cached_gain_group(const size_t chan, const bool is_tx, const boost::uint32_t gen, gain_group::sptr gg){
+        boost::mutex::scoped_lock lock(_cache_mutex);
+        chan_cache_t *cache = this->store_chan_cache(chan, is_tx, gen);
+        if (cache != NULL) cache->gg = gg;
+        return gg;
+    }
+
     mboard_chan_pair rx_chan_to_mcp(size_t chan){
         mboard_chan_pair mcp;
+        if (get_cached_mcp(chan, false, mcp)) return mcp;
+        const boost::uint32_t gen = _cache_gen->read();
         mcp.chan = chan;
         for (mcp.mboard = 0; mcp.mboard < get_num_mboards(); mcp.mboard++){
             size_t sss = get_rx_subdev_spec(mcp.mboard).size();
@@ -1514,11 +1718,14 @@ private:
         {
             throw uhd::index_error(str(boost::format("multi_usrp: RX channel %u out of range for configured RX frontends") % chan));
         }
+        set_cached_mcp(chan, false, gen, mcp);
         return mcp;
     }
 
     mboard_chan_pair tx_chan_to_mcp(size_t chan){
         mboard_chan_pair mcp;
+        if (get_cached_mcp(chan, true, mcp)) return mcp;
+        const boost::uint32_t gen = _cache_gen->read();
         mcp.chan = chan;
         for (mcp.mboard = 0; mcp.mboard < get_num_mboards(); mcp.mboard++){
             size_t sss = get_tx_subdev_spec(mcp.mboard).size();
@@ -1529,14 +1736,24 @@ private:
         {
             throw uhd::index_error(str(boost::format("multi_usrp: TX channel %u out of range for configured TX frontends") % chan));
         }
+        set_cached_mcp(chan, true, gen, mcp);
         return mcp;
     }
 
     fs_path mb_root(const size_t mboard)
     {
+        {
+            //the motherboards don't change once the device is made
+            boost::mutex::scoped_lock lock(_cache_mutex);
+            if (mboard < _mb_roots.size()) return _mb_roots[mboard];
+        }
         try
         {
-            const std::string name = _tree->list("/mboards").at(mboard);
+            const std::vector<std::string> names = _tree->list("/mboards");
+            const std::string name = names.at(mboard);
+            boost::mutex::scoped_lock lock(_cache_mutex);
+            _mb_roots.clear();
+            BOOST_FOREACH(const std::string &n, names) _mb_roots.push_back("/mboards/" + n);
             return "/mboards/" + name;
         }
         catch(const std::exception &e)
@@ -1547,6 +1764,9 @@ private:
 
     fs_path rx_dsp_root(const size_t chan)
     {
+        fs_path root;
+        if (get_cached_root(chan, false, ROOT_DSP, root)) return root;
+        const boost::uint32_t gen = _cache_gen->read();
         mboard_chan_pair mcp = rx_chan_to_mcp(chan);
         if (_tree->exists(mb_root(mcp.mboard) / "rx_chan_dsp_mapping")) {
             std::vector<size_t> map = _tree->access<std::vector<size_t> >(mb_root(mcp.mboard) / "rx_chan_dsp_mapping").get();
@@ -1557,7 +1777,7 @@ private:
         try
         {
             const std::string name = _tree->list(mb_root(mcp.mboard) / "rx_dsps").at(mcp.chan);
-            return mb_root(mcp.mboard) / "rx_dsps" / name;
+            return set_cached_root(chan, false, ROOT_DSP, gen, mb_root(mcp.mboard) / "rx_dsps" / name);
         }
         catch(const std::exception &e)
         {
@@ -1567,6 +1787,9 @@ private:
 
     fs_path tx_dsp_root(const size_t chan)
     {
+        fs_path root;
+        if (get_cached_root(chan, true, ROOT_DSP, root)) return root;
+        const boost::uint32_t gen = _cache_gen->read();
         mboard_chan_pair mcp = tx_chan_to_mcp(chan);
         if (_tree->exists(mb_root(mcp.mboard) / "tx_chan_dsp_mapping")) {
             std::vector<size_t> map = _tree->access<std::vector<size_t> >(mb_root(mcp.mboard) / "tx_chan_dsp_mapping").get();
@@ -1576,7 +1799,7 @@ private:
         try
         {
             const std::string name = _tree->list(mb_root(mcp.mboard) / "tx_dsps").at(mcp.chan);
-            return mb_root(mcp.mboard) / "tx_dsps" / name;
+            return set_cached_root(chan, true, ROOT_DSP, gen, mb_root(mcp.mboard) / "tx_dsps" / name);
         }
         catch(const std::exception &e)
         {
@@ -1586,11 +1809,14 @@ private:
 
     fs_path rx_fe_root(const size_t chan)
     {
+        fs_path root;
+        if (get_cached_root(chan, false, ROOT_FE, root)) return root;
+        const boost::uint32_t gen = _cache_gen->read();
         mboard_chan_pair mcp = rx_chan_to_mcp(chan);
         try
         {
             const subdev_spec_pair_t spec = get_rx_subdev_spec(mcp.mboard).at(mcp.chan);
-            return mb_root(mcp.mboard) / "rx_frontends" / spec.db_name;
+            return set_cached_root(chan, false, ROOT_FE, gen, mb_root(mcp.mboard) / "rx_frontends" / spec.db_name);
         }
         catch(const std::exception &e)
         {
@@ -1600,11 +1826,14 @@ private:
 
     fs_path tx_fe_root(const size_t chan)
     {
+        fs_path root;
+        if (get_cached_root(chan, true, ROOT_FE, root)) return root;
+        const boost::uint32_t gen = _cache_gen->read();
         mboard_chan_pair mcp = tx_chan_to_mcp(chan);
         try
         {
             const subdev_spec_pair_t spec = get_tx_subdev_spec(mcp.mboard).at(mcp.chan);
-            return mb_root(mcp.mboard) / "tx_frontends" / spec.db_name;
+            return set_cached_root(chan, true, ROOT_FE, gen, mb_root(mcp.mboard) / "tx_frontends" / spec.db_name);
         }
         catch(const std::exception &e)
         {
@@ -1614,11 +1843,14 @@ private:
 
     fs_path rx_rf_fe_root(const size_t chan)
     {
+        fs_path root;
+        if (get_cached_root(chan, false, ROOT_RF_FE, root)) return root;
+        const boost::uint32_t gen = _cache_gen->read();
         mboard_chan_pair mcp = rx_chan_to_mcp(chan);
         try
         {
             const subdev_spec_pair_t spec = get_rx_subdev_spec(mcp.mboard).at(mcp.chan);
-            return mb_root(mcp.mboard) / "dboards" / spec.db_name / "rx_frontends" / spec.sd_name;
+            return set_cached_root(chan, false, ROOT_RF_FE, gen, mb_root(mcp.mboard) / "dboards" / spec.db_name / "rx_frontends" / spec.sd_name);
         }
         catch(const std::exception &e)
         {
@@ -1628,11 +1860,14 @@ private:
 
     fs_path tx_rf_fe_root(const size_t chan)
     {
+        fs_path root;
+        if (get_cached_root(chan, true, ROOT_RF_FE, root)) return root;
+        const boost::uint32_t gen = _cache_gen->read();
         mboard_chan_pair mcp = tx_chan_to_mcp(chan);
         try
         {
             const subdev_spec_pair_t spec = get_tx_subdev_spec(mcp.mboard).at(mcp.chan);
-            return mb_root(mcp.mboard) / "dboards" / spec.db_name / "tx_frontends" / spec.sd_name;
+            return set_cached_root(chan, true, ROOT_RF_FE, gen, mb_root(mcp.mboard) / "dboards" / spec.db_name / "tx_frontends" / spec.sd_name);
         }
         catch(const std::exception &e)
         {
@@ -1641,6 +1876,9 @@ private:
     }
 
     gain_group::sptr rx_gain_group(size_t chan){
+        gain_group::sptr cached = get_cached_gain_group(chan, false);
+        if (cached) return cached;
+        const boost::uint32_t gen = _cache_gen->read();
         mboard_chan_pair mcp = rx_chan_to_mcp(chan);
         const subdev_spec_pair_t spec = get_rx_subdev_spec(mcp.mboard).at(mcp.chan);
         gain_group::sptr gg = gain_group::make();
@@ -1650,10 +1888,13 @@ private:
         BOOST_FOREACH(const std::string &name, _tree->list(rx_rf_fe_root(chan) / "gains")){
             gg->register_fcns(name, make_gain_fcns_from_subtree(_tree->subtree(rx_rf_fe_root(chan) / "gains" / name)), 1 /* high prio */);
         }
-        return gg;
+        return set_cached_gain_group(chan, false, gen, gg);
     }
 
     gain_group::sptr tx_gain_group(size_t chan){
+        gain_group::sptr cached = get_cached_gain_group(chan, true);
+        if (cached) return cached;
+        const boost::uint32_t gen = _cache_gen->read();
         mboard_chan_pair mcp = tx_chan_to_mcp(chan);
         const subdev_spec_pair_t spec = get_tx_subdev_spec(mcp.mboard).at(mcp.chan);
         gain_group::sptr gg = gain_group::make();
@@ -1663,7 +1904,212 @@ private:
         BOOST_FOREACH(const std::string &name, _tree->list(tx_rf_fe_root(chan) / "gains")){
             gg->register_fcns(name, make_gain_fcns_from_subtree(_tree->subtree(tx_rf_fe_root(chan) / "gains" / name)), 0 /* low prio */);
         }
-        return gg;
+        return set_cached_gain_group(chan, true, gen, gg);
+    }
+
+    /*******************************************************************
+     * Hop schedules:
+     * Every hop is turned into its command time property and an action
+     * before the first hop is sent, so sending only sets properties.
+     ******************************************************************/
+    struct hop_step_t{
+        time_spec_t time;
+        property<time_spec_t> *cmd_time;
+        boost::function<void(void)> action;
+    };
+
+    /*!
+     * A default tune of a frontend and DSP to one hop frequency.
+     * The RF target only depends on ranges and settings, so it is found
+     * before the first hop. The DSP target depends on the frequency the
+     * frontend tunes to, so the first hop finds it and the following
+     * hops to the same frequency reuse it.
+     */
+    struct hop_tune_t{
+        typedef boost::shared_ptr<hop_tune_t> sptr;
+        property<double> *rf_freq;
+        property<double> *dsp_freq;
+        property<device_addr_t> *tune_args; //NULL if the frontend has none
+        double xx_sign;
+        double clipped_freq;
+        double rf_target;
+        bool dsp_known;
+        double dsp_target;
+    };
+
+    static bool hop_time_less(const hop_t &a, const hop_t &b){
+        return a.time < b.time;
+    }
+
+    //! \param is_tx True for tx
+    void set_xx_hop_schedule(const hop_schedule_t &schedule, const bool is_tx){
+        hop_schedule_t hops(schedule);
+        std::stable_sort(hops.begin(), hops.end(), &multi_usrp_impl::hop_time_less);
+
+        //check every hop before anything is written
+        typedef std::map<double, size_t> profile_map_t;
+        std::map<size_t, std::set<fs_path> > profile_rf_fe_roots;
+        const std::map<size_t, profile_map_t> profiles = this->assign_fast_lock_profiles(hops, is_tx, profile_rf_fe_roots);
+        BOOST_FOREACH(const hop_t &hop, hops){
+            const mboard_chan_pair mcp = is_tx ? tx_chan_to_mcp(hop.chan) : rx_chan_to_mcp(hop.chan);
+            if (not _tree->exists(mb_root(mcp.mboard) / "time/cmd")){
+                throw uhd::not_implemented_error("timed command feature not implemented on this hardware");
+            }
+            const fs_path rf_fe_root = is_tx ? tx_rf_fe_root(hop.chan) : rx_rf_fe_root(hop.chan);
+            if (not _tree->exists(rf_fe_root / "timed_commands") or _tree->access<bool>(rf_fe_root / "timed_commands").get()){
+                continue;
+            }
+            if (hop.setting == hop_t::SETTING_GAIN){
+                throw uhd::not_implemented_error(str(boost::format(
+                    "multi_usrp: the gain of channel %u does not follow the command time") % hop.chan));
+            }
+            if (profiles.count(mcp.mboard) == 0 or profile_rf_fe_roots[mcp.mboard].count(rf_fe_root) == 0){
+                throw uhd::not_implemented_error(str(boost::format(
+                    "multi_usrp: the frequency of channel %u only follows the command time with fast lock profiles") % hop.chan));
+            }
+        }
+        this->store_fast_lock_profiles(profiles, profile_rf_fe_roots);
+
+        std::vector<hop_step_t> steps;
+        std::set<property<time_spec_t> *> cmd_times;
+        std::map<std::pair<size_t, double>, hop_tune_t::sptr> tunes;
+        BOOST_FOREACH(const hop_t &hop, hops){
+            const mboard_chan_pair mcp = is_tx ? tx_chan_to_mcp(hop.chan) : rx_chan_to_mcp(hop.chan);
+            hop_step_t step;
+            step.time = hop.time;
+            step.cmd_time = &_tree->access<time_spec_t>(mb_root(mcp.mboard) / "time/cmd");
+            cmd_times.insert(step.cmd_time);
+
+            if (hop.setting == hop_t::SETTING_GAIN){
+                step.action = boost::bind(&gain_group::set_value,
+                    is_tx ? tx_gain_group(hop.chan) : rx_gain_group(hop.chan), hop.value, ALL_GAINS);
+                steps.push_back(step);
+                continue;
+            }
+
+            const fs_path rf_fe_root = is_tx ? tx_rf_fe_root(hop.chan) : rx_rf_fe_root(hop.chan);
+            std::map<size_t, profile_map_t>::const_iterator it = profiles.find(mcp.mboard);
+            if (it != profiles.end() and profile_rf_fe_roots[mcp.mboard].count(rf_fe_root)){
+                step.action = boost::bind(&property<size_t>::set,
+                    &_tree->access<size_t>(rf_fe_root / "freq" / "fast_lock" / "recall"),
+                    it->second.find(hop.value)->second);
+            }
+            else{
+                hop_tune_t::sptr &tune = tunes[std::make_pair(hop.chan, hop.value)];
+                if (not tune) tune = this->make_hop_tune(hop.chan, hop.value, is_tx);
+                step.action = boost::bind(&multi_usrp_impl::run_hop_tune, tune);
+            }
+            steps.push_back(step);
+        }
+
+        //timed commands back-pressure when the command queue is full
+        try{
+            BOOST_FOREACH(const hop_step_t &step, steps){
+                step.cmd_time->set(step.time);
+                step.action();
+            }
+        }
+        catch(...){
+            BOOST_FOREACH(property<time_spec_t> *cmd_time, cmd_times){
+                cmd_time->set(time_spec_t(0.0));
+            }
+            throw;
+        }
+        BOOST_FOREACH(property<time_spec_t> *cmd_time, cmd_times){
+            cmd_time->set(time_spec_t(0.0));
+        }
+    }
+
+    //! Find the RF target of a default tune, like tune_xx_subdev_and_dsp()
+    hop_tune_t::sptr make_hop_tune(const size_t chan, const double freq, const bool is_tx){
+        property_tree::sptr dsp_subtree = _tree->subtree(is_tx ? tx_dsp_root(chan) : rx_dsp_root(chan));
+        property_tree::sptr rf_fe_subtree = _tree->subtree(is_tx ? tx_rf_fe_root(chan) : rx_rf_fe_root(chan));
+        const freq_range_t tune_range = make_overall_tune_range(
+            rf_fe_subtree->access<meta_range_t>("freq/range").get(),
+            dsp_subtree->access<meta_range_t>("freq/range").get(),
+            rf_fe_subtree->access<double>("bandwidth/value").get()
+        );
+
+        hop_tune_t::sptr tune(new hop_tune_t());
+        tune->rf_freq = &rf_fe_subtree->access<double>("freq/value");
+        tune->dsp_freq = &dsp_subtree->access<double>("freq/value");
+        tune->tune_args = rf_fe_subtree->exists("tune_args") ?
+            &rf_fe_subtree->access<device_addr_t>("tune_args") : NULL;
+        tune->xx_sign = is_tx ? TX_SIGN : RX_SIGN;
+        tune->clipped_freq = tune_range.clip(freq);
+        tune->rf_target = tune->clipped_freq + get_auto_lo_offset(dsp_subtree, rf_fe_subtree);
+        tune->dsp_known = false;
+        tune->dsp_target = 0.0;
+        return tune;
+    }
+
+    static void run_hop_tune(hop_tune_t::sptr tune){
+        if (tune->tune_args) tune->tune_args->set(device_addr_t());
+        tune->rf_freq->set(tune->rf_target);
+        if (not tune->dsp_known){
+            tune->dsp_target = (tune->rf_freq->get() - tune->clipped_freq) * tune->xx_sign;
+            tune->dsp_known = true;
+        }
+        tune->dsp_freq->set(tune->dsp_target);
+    }
+
+    /*!
+     * Give every hop frequency of a motherboard a fast lock profile.
+     * Only motherboards whose hop frequencies fit into the profiles of
+     * all their hopping frontends are returned, with the profile index
+     * of each frequency. Nothing is stored yet.
+     * \param rf_fe_roots the frontends of each returned motherboard
+     */
+    std::map<size_t, std::map<double, size_t> > assign_fast_lock_profiles(
+        const hop_schedule_t &hops, const bool is_tx, std::map<size_t, std::set<fs_path> > &rf_fe_roots
+    ){
+        std::map<size_t, std::map<double, size_t> > profiles;
+        BOOST_FOREACH(const hop_t &hop, hops){
+            if (hop.setting != hop_t::SETTING_FREQ) continue;
+            const mboard_chan_pair mcp = is_tx ? tx_chan_to_mcp(hop.chan) : rx_chan_to_mcp(hop.chan);
+            const fs_path rf_fe_root = is_tx ? tx_rf_fe_root(hop.chan) : rx_rf_fe_root(hop.chan);
+            if (not _tree->exists(rf_fe_root / "freq" / "fast_lock" / "recall")) continue;
+            rf_fe_roots[mcp.mboard].insert(rf_fe_root);
+            std::map<double, size_t> &freqs = profiles[mcp.mboard];
+            if (freqs.count(hop.value) == 0){
+                const size_t profile = freqs.size();
+                freqs[hop.value] = profile;
+            }
+        }
+
+        std::map<size_t, std::set<fs_path> > fitting_rf_fe_roots;
+        typedef std::map<size_t, std::set<fs_path> >::value_type mb_roots_pair;
+        BOOST_FOREACH(const mb_roots_pair &p, rf_fe_roots){
+            const std::map<double, size_t> &freqs = profiles[p.first];
+            bool fits = true;
+            BOOST_FOREACH(const fs_path &rf_fe_root, p.second){
+                fits = fits and freqs.size() <= _tree->access<size_t>(rf_fe_root / "freq" / "fast_lock" / "num_profiles").get();
+            }
+            if (not fits){
+                UHD_LOG << boost::format("multi_usrp: %u hop frequencies exceed the fast lock profiles of mboard %u") % freqs.size() % p.first << std::endl;
+                profiles.erase(p.first);
+                continue;
+            }
+            fitting_rf_fe_roots.insert(p);
+        }
+        rf_fe_roots.swap(fitting_rf_fe_roots);
+        return profiles;
+    }
+
+    //! Store the profiles from assign_fast_lock_profiles()
+    void store_fast_lock_profiles(
+        const std::map<size_t, std::map<double, size_t> > &profiles,
+        const std::map<size_t, std::set<fs_path> > &rf_fe_roots
+    ){
+        typedef std::map<size_t, std::set<fs_path> >::value_type mb_roots_pair;
+        BOOST_FOREACH(const mb_roots_pair &p, rf_fe_roots){
+            typedef std::map<double, size_t>::value_type freq_profile_pair;
+            BOOST_FOREACH(const fs_path &rf_fe_root, p.second){
+                BOOST_FOREACH(const freq_profile_pair &fp, profiles.find(p.first)->second){
+                    _tree->access<double>(rf_fe_root / "freq" / "fast_lock" / "profiles" / fp.second / "value").set(fp.first);
+                }
+            }
+        }
     }
 
     //! \param is_tx True for tx
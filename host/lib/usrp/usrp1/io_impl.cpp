@@ -652,7 +652,7 @@ rx_streamer::sptr usrp1_impl::get_rx_stream(const uhd::stream_args_t &args_){
     id.num_inputs = 1;
     id.output_format = args.cpu_format;
     id.num_outputs = args.channels.size();
-    my_streamer->set_converter(id);
+    my_streamer->set_converter(id, args.args);
 
     //special scale factor change for sc8
     if (args.otw_format == "sc8")
@@ -709,7 +709,7 @@ tx_streamer::sptr usrp1_impl::get_tx_stream(const uhd::stream_args_t &args_){
     id.num_inputs = args.channels.size();
     id.output_format = args.otw_format + "_item16_usrp1";
     id.num_outputs = 1;
-    my_streamer->set_converter(id);
+    my_streamer->set_converter(id, args.args);
 
     //save as weak ptr for update access
     _tx_streamer = my_streamer;
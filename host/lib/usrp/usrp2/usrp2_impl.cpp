@@ -18,6 +18,7 @@
 #include "usrp2_impl.hpp"
 #include "fw_common.h"
 #include "apply_corrections.hpp"
+#include "parallel_mboard_setup.hpp"
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/exception.hpp>
@@ -373,387 +374,19 @@ usrp2_impl::usrp2_impl(const device_addr_t &_device_addr) :
     _ignore_cal_file = device_addr.has_key("ignore-cal-file");
     _tree->create<std::string>("/name").set("USRP2 / N-Series Device");
 
+    //create the motherboard nodes in order, their setups finish in any order
     for (size_t mbi = 0; mbi < device_args.size(); mbi++){
-        const device_addr_t device_args_i = device_args[mbi];
         const std::string mb = boost::lexical_cast<std::string>(mbi);
-        const std::string addr = device_args_i["addr"];
-        const fs_path mb_path = "/mboards/" + mb;
-
-        ////////////////////////////////////////////////////////////////
-        // create the iface that controls i2c, spi, uart, and wb
-        ////////////////////////////////////////////////////////////////
-        _mbc[mb].iface = usrp2_iface::make(udp_simple::make_connected(
-            addr, BOOST_STRINGIZE(USRP2_UDP_CTRL_PORT)
-        ));
-        _tree->create<std::string>(mb_path / "name").set(_mbc[mb].iface->get_cname());
-        _tree->create<std::string>(mb_path / "fw_version").set(_mbc[mb].iface->get_fw_version_string());
-
-        //check the fpga compatibility number
-        const boost::uint32_t fpga_compat_num = _mbc[mb].iface->peek32(U2_REG_COMPAT_NUM_RB);
-        boost::uint16_t fpga_major = fpga_compat_num >> 16, fpga_minor = fpga_compat_num & 0xffff;
-        if (fpga_major == 0){ //old version scheme
-            fpga_major = fpga_minor;
-            fpga_minor = 0;
-        }
-        int expected_fpga_compat_num = std::min(USRP2_FPGA_COMPAT_NUM, N200_FPGA_COMPAT_NUM);
-        switch (_mbc[mb].iface->get_rev())
-        {
-        case usrp2_iface::USRP2_REV3:
-        case usrp2_iface::USRP2_REV4:
-            expected_fpga_compat_num = USRP2_FPGA_COMPAT_NUM;
-            break;
-        case usrp2_iface::USRP_N200:
-        case usrp2_iface::USRP_N200_R4:
-        case usrp2_iface::USRP_N210:
-        case usrp2_iface::USRP_N210_R4:
-            expected_fpga_compat_num = N200_FPGA_COMPAT_NUM;
-            break;
-        default:
-            // handle case where the MB EEPROM is not programmed
-            if (fpga_major == USRP2_FPGA_COMPAT_NUM or fpga_major == N200_FPGA_COMPAT_NUM)
-            {
-                UHD_MSG(warning)  << "Unable to identify device - assuming USRP2/N-Series device" << std::endl;
-                expected_fpga_compat_num = fpga_major;
-            }
-        }
-        if (fpga_major != expected_fpga_compat_num){
-            throw uhd::runtime_error(str(boost::format(
-                "\nPlease update the firmware and FPGA images for your device.\n"
-                "See the application notes for USRP2/N-Series for instructions.\n"
-                "Expected FPGA compatibility number %d, but got %d:\n"
-                "The FPGA build is not compatible with the host code build.\n"
-                "%s\n"
-            ) % expected_fpga_compat_num % fpga_major % _mbc[mb].iface->images_warn_help_message()));
-        }
-        _tree->create<std::string>(mb_path / "fpga_version").set(str(boost::format("%u.%u") % fpga_major % fpga_minor));
-
-        //lock the device/motherboard to this process
-        _mbc[mb].iface->lock_device(true);
-
-        ////////////////////////////////////////////////////////////////
-        // construct transports for RX and TX DSPs
-        ////////////////////////////////////////////////////////////////
-        UHD_LOG << "Making transport for RX DSP0..." << std::endl;
-        _mbc[mb].rx_dsp_xports.push_back(make_xport(
-            addr, BOOST_STRINGIZE(USRP2_UDP_RX_DSP0_PORT), device_args_i, "recv"
-        ));
-        UHD_LOG << "Making transport for RX DSP1..." << std::endl;
-        _mbc[mb].rx_dsp_xports.push_back(make_xport(
-            addr, BOOST_STRINGIZE(USRP2_UDP_RX_DSP1_PORT), device_args_i, "recv"
-        ));
-        UHD_LOG << "Making transport for TX DSP0..." << std::endl;
-        _mbc[mb].tx_dsp_xport = make_xport(
-            addr, BOOST_STRINGIZE(USRP2_UDP_TX_DSP0_PORT), device_args_i, "send"
-        );
-        UHD_LOG << "Making transport for Control..." << std::endl;
-        _mbc[mb].fifo_ctrl_xport = make_xport(
-            addr, BOOST_STRINGIZE(USRP2_UDP_FIFO_CRTL_PORT), device_addr_t(), ""
-        );
-        //set the filter on the router to take dsp data from this port
-        _mbc[mb].iface->poke32(U2_REG_ROUTER_CTRL_PORTS, (USRP2_UDP_FIFO_CRTL_PORT << 16) | USRP2_UDP_TX_DSP0_PORT);
-
-        //create the fifo control interface for high speed register access
-        _mbc[mb].fifo_ctrl = usrp2_fifo_ctrl::make(_mbc[mb].fifo_ctrl_xport);
-        switch(_mbc[mb].iface->get_rev()){
-        case usrp2_iface::USRP_N200:
-        case usrp2_iface::USRP_N210:
-        case usrp2_iface::USRP_N200_R4:
-        case usrp2_iface::USRP_N210_R4:
-            _mbc[mb].wbiface = _mbc[mb].fifo_ctrl;
-            _mbc[mb].spiface = _mbc[mb].fifo_ctrl;
-            break;
-        default:
-            _mbc[mb].wbiface = _mbc[mb].iface;
-            _mbc[mb].spiface = _mbc[mb].iface;
-            break;
-        }
-        _tree->create<double>(mb_path / "link_max_rate").set(USRP2_LINK_RATE_BPS);
-
-        ////////////////////////////////////////////////////////////////
-        // setup the mboard eeprom
-        ////////////////////////////////////////////////////////////////
-        _tree->create<mboard_eeprom_t>(mb_path / "eeprom")
-            .set(_mbc[mb].iface->mb_eeprom)
-            .add_coerced_subscriber(boost::bind(&usrp2_impl::set_mb_eeprom, this, mb, _1));
-
-        ////////////////////////////////////////////////////////////////
-        // create clock control objects
-        ////////////////////////////////////////////////////////////////
-        _mbc[mb].clock = usrp2_clock_ctrl::make(_mbc[mb].iface, _mbc[mb].spiface);
-        _tree->create<double>(mb_path / "tick_rate")
-            .set_publisher(boost::bind(&usrp2_clock_ctrl::get_master_clock_rate, _mbc[mb].clock))
-            .add_coerced_subscriber(boost::bind(&usrp2_impl::update_tick_rate, this, _1));
-
-        ////////////////////////////////////////////////////////////////
-        // create codec control objects
-        ////////////////////////////////////////////////////////////////
-        const fs_path rx_codec_path = mb_path / "rx_codecs/A";
-        const fs_path tx_codec_path = mb_path / "tx_codecs/A";
-        _tree->create<int>(rx_codec_path / "gains"); //phony property so this dir exists
-        _tree->create<int>(tx_codec_path / "gains"); //phony property so this dir exists
-        _mbc[mb].codec = usrp2_codec_ctrl::make(_mbc[mb].iface, _mbc[mb].spiface);
-        switch(_mbc[mb].iface->get_rev()){
-        case usrp2_iface::USRP_N200:
-        case usrp2_iface::USRP_N210:
-        case usrp2_iface::USRP_N200_R4:
-        case usrp2_iface::USRP_N210_R4:{
-            _tree->create<std::string>(rx_codec_path / "name").set("ads62p44");
-            _tree->create<meta_range_t>(rx_codec_path / "gains/digital/range").set(meta_range_t(0, 6.0, 0.5));
-            _tree->create<double>(rx_codec_path / "gains/digital/value")
-                .add_coerced_subscriber(boost::bind(&usrp2_codec_ctrl::set_rx_digital_gain, _mbc[mb].codec, _1)).set(0);
-            _tree->create<meta_range_t>(rx_codec_path / "gains/fine/range").set(meta_range_t(0, 0.5, 0.05));
-            _tree->create<double>(rx_codec_path / "gains/fine/value")
-                .add_coerced_subscriber(boost::bind(&usrp2_codec_ctrl::set_rx_digital_fine_gain, _mbc[mb].codec, _1)).set(0);
-        }break;
-
-        case usrp2_iface::USRP2_REV3:
-        case usrp2_iface::USRP2_REV4:
-            _tree->create<std::string>(rx_codec_path / "name").set("ltc2284");
-            break;
-
-        case usrp2_iface::USRP_NXXX:
-            _tree->create<std::string>(rx_codec_path / "name").set("??????");
-            break;
-        }
-        _tree->create<std::string>(tx_codec_path / "name").set("ad9777");
-
-        ////////////////////////////////////////////////////////////////////
-        // Create the GPSDO control
-        ////////////////////////////////////////////////////////////////////
-        static const boost::uint32_t dont_look_for_gpsdo = 0x1234abcdul;
-
-        //disable check for internal GPSDO when not the following:
-        switch(_mbc[mb].iface->get_rev()){
-        case usrp2_iface::USRP_N200:
-        case usrp2_iface::USRP_N210:
-        case usrp2_iface::USRP_N200_R4:
-        case usrp2_iface::USRP_N210_R4:
-            break;
-        default:
-            _mbc[mb].iface->pokefw(U2_FW_REG_HAS_GPSDO, dont_look_for_gpsdo);
-        }
-
-        //otherwise if not disabled, look for the internal GPSDO
-        if (_mbc[mb].iface->peekfw(U2_FW_REG_HAS_GPSDO) != dont_look_for_gpsdo)
-        {
-            UHD_MSG(status) << "Detecting internal GPSDO.... " << std::flush;
-            try{
-                _mbc[mb].gps = gps_ctrl::make(udp_simple::make_uart(udp_simple::make_connected(
-                    addr, BOOST_STRINGIZE(USRP2_UDP_UART_GPS_PORT)
-                )));
-            }
-            catch(std::exception &e){
-                UHD_MSG(error) << "An error occurred making GPSDO control: " << e.what() << std::endl;
-            }
-            if (_mbc[mb].gps and _mbc[mb].gps->gps_detected())
-            {
-                BOOST_FOREACH(const std::string &name, _mbc[mb].gps->get_sensors())
-                {
-                    _tree->create<sensor_value_t>(mb_path / "sensors" / name)
-                        .set_publisher(boost::bind(&gps_ctrl::get_sensor, _mbc[mb].gps, name));
-                }
-            }
-            else
-            {
-                _mbc[mb].iface->pokefw(U2_FW_REG_HAS_GPSDO, dont_look_for_gpsdo);
-            }
-        }
-
-        ////////////////////////////////////////////////////////////////
-        // and do the misc mboard sensors
-        ////////////////////////////////////////////////////////////////
-        _tree->create<sensor_value_t>(mb_path / "sensors/mimo_locked")
-            .set_publisher(boost::bind(&usrp2_impl::get_mimo_locked, this, mb));
-        _tree->create<sensor_value_t>(mb_path / "sensors/ref_locked")
-            .set_publisher(boost::bind(&usrp2_impl::get_ref_locked, this, mb));
-
-        ////////////////////////////////////////////////////////////////
-        // create frontend control objects
-        ////////////////////////////////////////////////////////////////
-        _mbc[mb].rx_fe = rx_frontend_core_200::make(
-            _mbc[mb].wbiface, U2_REG_SR_ADDR(SR_RX_FRONT)
-        );
-        _mbc[mb].tx_fe = tx_frontend_core_200::make(
-            _mbc[mb].wbiface, U2_REG_SR_ADDR(SR_TX_FRONT)
-        );
-
-        _tree->create<subdev_spec_t>(mb_path / "rx_subdev_spec")
-            .add_coerced_subscriber(boost::bind(&usrp2_impl::update_rx_subdev_spec, this, mb, _1));
-        _tree->create<subdev_spec_t>(mb_path / "tx_subdev_spec")
-            .add_coerced_subscriber(boost::bind(&usrp2_impl::update_tx_subdev_spec, this, mb, _1));
-
-        const fs_path rx_fe_path = mb_path / "rx_frontends" / "A";
-        const fs_path tx_fe_path = mb_path / "tx_frontends" / "A";
-
-        _tree->create<std::complex<double> >(rx_fe_path / "dc_offset" / "value")
-            .set_coercer(boost::bind(&rx_frontend_core_200::set_dc_offset, _mbc[mb].rx_fe, _1))
-            .set(std::complex<double>(0.0, 0.0));
-        _tree->create<bool>(rx_fe_path / "dc_offset" / "enable")
-            .add_coerced_subscriber(boost::bind(&rx_frontend_core_200::set_dc_offset_auto, _mbc[mb].rx_fe, _1))
-            .set(true);
-        _tree->create<std::complex<double> >(rx_fe_path / "iq_balance" / "value")
-            .add_coerced_subscriber(boost::bind(&rx_frontend_core_200::set_iq_balance, _mbc[mb].rx_fe, _1))
-            .set(std::complex<double>(0.0, 0.0));
-        _tree->create<std::complex<double> >(tx_fe_path / "dc_offset" / "value")
-            .set_coercer(boost::bind(&tx_frontend_core_200::set_dc_offset, _mbc[mb].tx_fe, _1))
-            .set(std::complex<double>(0.0, 0.0));
-        _tree->create<std::complex<double> >(tx_fe_path / "iq_balance" / "value")
-            .add_coerced_subscriber(boost::bind(&tx_frontend_core_200::set_iq_balance, _mbc[mb].tx_fe, _1))
-            .set(std::complex<double>(0.0, 0.0));
-
-        ////////////////////////////////////////////////////////////////
-        // create rx dsp control objects
-        ////////////////////////////////////////////////////////////////
-        _mbc[mb].rx_dsps.push_back(rx_dsp_core_200::make(
-            _mbc[mb].wbiface, U2_REG_SR_ADDR(SR_RX_DSP0), U2_REG_SR_ADDR(SR_RX_CTRL0), USRP2_RX_SID_BASE + 0, true
-        ));
-        _mbc[mb].rx_dsps.push_back(rx_dsp_core_200::make(
-            _mbc[mb].wbiface, U2_REG_SR_ADDR(SR_RX_DSP1), U2_REG_SR_ADDR(SR_RX_CTRL1), USRP2_RX_SID_BASE + 1, true
-        ));
-        for (size_t dspno = 0; dspno < _mbc[mb].rx_dsps.size(); dspno++){
-            _mbc[mb].rx_dsps[dspno]->set_link_rate(USRP2_LINK_RATE_BPS);
-            _tree->access<double>(mb_path / "tick_rate")
-                .add_coerced_subscriber(boost::bind(&rx_dsp_core_200::set_tick_rate, _mbc[mb].rx_dsps[dspno], _1));
-            fs_path rx_dsp_path = mb_path / str(boost::format("rx_dsps/%u") % dspno);
-            _tree->create<meta_range_t>(rx_dsp_path / "rate/range")
-                .set_publisher(boost::bind(&rx_dsp_core_200::get_host_rates, _mbc[mb].rx_dsps[dspno]));
-            _tree->create<double>(rx_dsp_path / "rate/value")
-                .set(1e6) //some default
-                .set_coercer(boost::bind(&rx_dsp_core_200::set_host_rate, _mbc[mb].rx_dsps[dspno], _1))
-                .add_coerced_subscriber(boost::bind(&usrp2_impl::update_rx_samp_rate, this, mb, dspno, _1));
-            _tree->create<double>(rx_dsp_path / "freq/value")
-                .set_coercer(boost::bind(&rx_dsp_core_200::set_freq, _mbc[mb].rx_dsps[dspno], _1));
-            _tree->create<meta_range_t>(rx_dsp_path / "freq/range")
-                .set_publisher(boost::bind(&rx_dsp_core_200::get_freq_range, _mbc[mb].rx_dsps[dspno]));
-            _tree->create<stream_cmd_t>(rx_dsp_path / "stream_cmd")
-                .add_coerced_subscriber(boost::bind(&rx_dsp_core_200::issue_stream_command, _mbc[mb].rx_dsps[dspno], _1));
-        }
-
-        ////////////////////////////////////////////////////////////////
-        // create tx dsp control objects
-        ////////////////////////////////////////////////////////////////
-        _mbc[mb].tx_dsp = tx_dsp_core_200::make(
-            _mbc[mb].wbiface, U2_REG_SR_ADDR(SR_TX_DSP), U2_REG_SR_ADDR(SR_TX_CTRL), USRP2_TX_ASYNC_SID
-        );
-        _mbc[mb].tx_dsp->set_link_rate(USRP2_LINK_RATE_BPS);
-        _tree->access<double>(mb_path / "tick_rate")
-            .add_coerced_subscriber(boost::bind(&tx_dsp_core_200::set_tick_rate, _mbc[mb].tx_dsp, _1));
-        _tree->create<meta_range_t>(mb_path / "tx_dsps/0/rate/range")
-            .set_publisher(boost::bind(&tx_dsp_core_200::get_host_rates, _mbc[mb].tx_dsp));
-        _tree->create<double>(mb_path / "tx_dsps/0/rate/value")
-            .set(1e6) //some default
-            .set_coercer(boost::bind(&tx_dsp_core_200::set_host_rate, _mbc[mb].tx_dsp, _1))
-            .add_coerced_subscriber(boost::bind(&usrp2_impl::update_tx_samp_rate, this, mb, 0, _1));
-        _tree->create<double>(mb_path / "tx_dsps/0/freq/value")
-            .set_coercer(boost::bind(&tx_dsp_core_200::set_freq, _mbc[mb].tx_dsp, _1));
-        _tree->create<meta_range_t>(mb_path / "tx_dsps/0/freq/range")
-            .set_publisher(boost::bind(&tx_dsp_core_200::get_freq_range, _mbc[mb].tx_dsp));
-
-        //setup dsp flow control
-        const double ups_per_sec = device_args_i.cast<double>("ups_per_sec", 20);
-        const size_t send_frame_size = _mbc[mb].tx_dsp_xport->get_send_frame_size();
-        const double ups_per_fifo = device_args_i.cast<double>("ups_per_fifo", 8.0);
-        _mbc[mb].tx_dsp->set_updates(
-            (ups_per_sec > 0.0)? size_t(100e6/*approx tick rate*//ups_per_sec) : 0,
-            (ups_per_fifo > 0.0)? size_t(USRP2_SRAM_BYTES/ups_per_fifo/send_frame_size) : 0
-        );
-
-        ////////////////////////////////////////////////////////////////
-        // create time control objects
-        ////////////////////////////////////////////////////////////////
-        time64_core_200::readback_bases_type time64_rb_bases;
-        time64_rb_bases.rb_hi_now = U2_REG_TIME64_HI_RB_IMM;
-        time64_rb_bases.rb_lo_now = U2_REG_TIME64_LO_RB_IMM;
-        time64_rb_bases.rb_hi_pps = U2_REG_TIME64_HI_RB_PPS;
-        time64_rb_bases.rb_lo_pps = U2_REG_TIME64_LO_RB_PPS;
-        _mbc[mb].time64 = time64_core_200::make(
-            _mbc[mb].wbiface, U2_REG_SR_ADDR(SR_TIME64), time64_rb_bases, mimo_clock_sync_delay_cycles
-        );
-        _tree->access<double>(mb_path / "tick_rate")
-            .add_coerced_subscriber(boost::bind(&time64_core_200::set_tick_rate, _mbc[mb].time64, _1));
-        _tree->create<time_spec_t>(mb_path / "time/now")
-            .set_publisher(boost::bind(&time64_core_200::get_time_now, _mbc[mb].time64))
-            .add_coerced_subscriber(boost::bind(&time64_core_200::set_time_now, _mbc[mb].time64, _1));
-        _tree->create<time_spec_t>(mb_path / "time/pps")
-            .set_publisher(boost::bind(&time64_core_200::get_time_last_pps, _mbc[mb].time64))
-            .add_coerced_subscriber(boost::bind(&time64_core_200::set_time_next_pps, _mbc[mb].time64, _1));
-        //setup time source props
-        _tree->create<std::string>(mb_path / "time_source/value")
-            .add_coerced_subscriber(boost::bind(&time64_core_200::set_time_source, _mbc[mb].time64, _1))
-            .set("none");
-        _tree->create<std::vector<std::string> >(mb_path / "time_source/options")
-            .set_publisher(boost::bind(&time64_core_200::get_time_sources, _mbc[mb].time64));
-        //setup reference source props
-        _tree->create<std::string>(mb_path / "clock_source/value")
-            .add_coerced_subscriber(boost::bind(&usrp2_impl::update_clock_source, this, mb, _1))
-            .set("internal");
-        std::vector<std::string> clock_sources = boost::assign::list_of("internal")("external")("mimo");
-        if (_mbc[mb].gps and _mbc[mb].gps->gps_detected()) clock_sources.push_back("gpsdo");
-        _tree->create<std::vector<std::string> >(mb_path / "clock_source/options").set(clock_sources);
-        //plug timed commands into tree here
-        switch(_mbc[mb].iface->get_rev()){
-        case usrp2_iface::USRP_N200:
-        case usrp2_iface::USRP_N210:
-        case usrp2_iface::USRP_N200_R4:
-        case usrp2_iface::USRP_N210_R4:
-            _tree->create<time_spec_t>(mb_path / "time/cmd")
-                .add_coerced_subscriber(boost::bind(&usrp2_fifo_ctrl::set_time, _mbc[mb].fifo_ctrl, _1));
-        default: break; //otherwise, do not register
-        }
-        _tree->access<double>(mb_path / "tick_rate")
-            .add_coerced_subscriber(boost::bind(&usrp2_fifo_ctrl::set_tick_rate, _mbc[mb].fifo_ctrl, _1));
-
-        ////////////////////////////////////////////////////////////////////
-        // create user-defined control objects
-        ////////////////////////////////////////////////////////////////////
-        _mbc[mb].user = user_settings_core_200::make(_mbc[mb].wbiface, U2_REG_SR_ADDR(SR_USER_REGS));
-        _tree->create<user_settings_core_200::user_reg_t>(mb_path / "user/regs")
-            .add_coerced_subscriber(boost::bind(&user_settings_core_200::set_reg, _mbc[mb].user, _1));
-
-        ////////////////////////////////////////////////////////////////
-        // create dboard control objects
-        ////////////////////////////////////////////////////////////////
-
-        //read the dboard eeprom to extract the dboard ids
-        dboard_eeprom_t rx_db_eeprom, tx_db_eeprom, gdb_eeprom;
-        rx_db_eeprom.load(*_mbc[mb].iface, USRP2_I2C_ADDR_RX_DB);
-        tx_db_eeprom.load(*_mbc[mb].iface, USRP2_I2C_ADDR_TX_DB);
-        gdb_eeprom.load(*_mbc[mb].iface, USRP2_I2C_ADDR_TX_DB ^ 5);
-
-        //disable rx dc offset if LFRX
-        if (rx_db_eeprom.id == 0x000f) _tree->access<bool>(rx_fe_path / "dc_offset" / "enable").set(false);
-
-        //create the properties and register subscribers
-        _tree->create<dboard_eeprom_t>(mb_path / "dboards/A/rx_eeprom")
-            .set(rx_db_eeprom)
-            .add_coerced_subscriber(boost::bind(&usrp2_impl::set_db_eeprom, this, mb, "rx", _1));
-        _tree->create<dboard_eeprom_t>(mb_path / "dboards/A/tx_eeprom")
-            .set(tx_db_eeprom)
-            .add_coerced_subscriber(boost::bind(&usrp2_impl::set_db_eeprom, this, mb, "tx", _1));
-        _tree->create<dboard_eeprom_t>(mb_path / "dboards/A/gdb_eeprom")
-            .set(gdb_eeprom)
-            .add_coerced_subscriber(boost::bind(&usrp2_impl::set_db_eeprom, this, mb, "gdb", _1));
-
-        //create a new dboard interface and manager
-        _mbc[mb].dboard_manager = dboard_manager::make(
-            rx_db_eeprom.id, tx_db_eeprom.id, gdb_eeprom.id,
-            make_usrp2_dboard_iface(_mbc[mb].wbiface, _mbc[mb].iface/*i2c*/, _mbc[mb].spiface, _mbc[mb].clock),
-            _tree->subtree(mb_path / "dboards/A")
-        );
-
-        //bind frontend corrections to the dboard freq props
-        const fs_path db_tx_fe_path = mb_path / "dboards" / "A" / "tx_frontends";
-        BOOST_FOREACH(const std::string &name, _tree->list(db_tx_fe_path)){
-            _tree->access<double>(db_tx_fe_path / name / "freq" / "value")
-                .add_coerced_subscriber(boost::bind(&usrp2_impl::set_tx_fe_corrections, this, mb, _1));
-        }
-        const fs_path db_rx_fe_path = mb_path / "dboards" / "A" / "rx_frontends";
-        BOOST_FOREACH(const std::string &name, _tree->list(db_rx_fe_path)){
-            _tree->access<double>(db_rx_fe_path / name / "freq" / "value")
-                .add_coerced_subscriber(boost::bind(&usrp2_impl::set_rx_fe_corrections, this, mb, _1));
-        }
+        _mbc[mb] = mb_container_type();
+        _tree->create<std::string>("/mboards/" + mb + "/name");
     }
 
+    //the motherboards are independent, so set them up in parallel
+    parallel_mboard_setup::run(
+        boost::bind(&usrp2_impl::setup_mb, this, _1, _2),
+        device_args,
+        device_addr.cast<size_t>("init_threads", device_args.size()));
+
     //initialize io handling
     this->io_init();
 
@@ -786,6 +419,386 @@ usrp2_impl::usrp2_impl(const device_addr_t &_device_addr) :
 
 }
 
+void usrp2_impl::setup_mb(const size_t mbi, const device_addr_t &device_args_i){
+    const std::string mb = boost::lexical_cast<std::string>(mbi);
+    const std::string addr = device_args_i["addr"];
+    const fs_path mb_path = "/mboards/" + mb;
+
+    ////////////////////////////////////////////////////////////////
+    // create the iface that controls i2c, spi, uart, and wb
+    ////////////////////////////////////////////////////////////////
+    _mbc[mb].iface = usrp2_iface::make(udp_simple::make_connected(
+        addr, BOOST_STRINGIZE(USRP2_UDP_CTRL_PORT)
+    ));
+    _tree->access<std::string>(mb_path / "name").set(_mbc[mb].iface->get_cname());
+    _tree->create<std::string>(mb_path / "fw_version").set(_mbc[mb].iface->get_fw_version_string());
+
+    //check the fpga compatibility number
+    const boost::uint32_t fpga_compat_num = _mbc[mb].iface->peek32(U2_REG_COMPAT_NUM_RB);
+    boost::uint16_t fpga_major = fpga_compat_num >> 16, fpga_minor = fpga_compat_num & 0xffff;
+    if (fpga_major == 0){ //old version scheme
+        fpga_major = fpga_minor;
+        fpga_minor = 0;
+    }
+    int expected_fpga_compat_num = std::min(USRP2_FPGA_COMPAT_NUM, N200_FPGA_COMPAT_NUM);
+    switch (_mbc[mb].iface->get_rev())
+    {
+    case usrp2_iface::USRP2_REV3:
+    case usrp2_iface::USRP2_REV4:
+        expected_fpga_compat_num = USRP2_FPGA_COMPAT_NUM;
+        break;
+    case usrp2_iface::USRP_N200:
+    case usrp2_iface::USRP_N200_R4:
+    case usrp2_iface::USRP_N210:
+    case usrp2_iface::USRP_N210_R4:
+        expected_fpga_compat_num = N200_FPGA_COMPAT_NUM;
+        break;
+    default:
+        // handle case where the MB EEPROM is not programmed
+        if (fpga_major == USRP2_FPGA_COMPAT_NUM or fpga_major == N200_FPGA_COMPAT_NUM)
+        {
+            UHD_MSG(warning)  << "Unable to identify device - assuming USRP2/N-Series device" << std::endl;
+            expected_fpga_compat_num = fpga_major;
+        }
+    }
+    if (fpga_major != expected_fpga_compat_num){
+        throw uhd::runtime_error(str(boost::format(
+            "\nPlease update the firmware and FPGA images for your device.\n"
+            "See the application notes for USRP2/N-Series for instructions.\n"
+            "Expected FPGA compatibility number %d, but got %d:\n"
+            "The FPGA build is not compatible with the host code build.\n"
+            "%s\n"
+        ) % expected_fpga_compat_num % fpga_major % _mbc[mb].iface->images_warn_help_message()));
+    }
+    _tree->create<std::string>(mb_path / "fpga_version").set(str(boost::format("%u.%u") % fpga_major % fpga_minor));
+
+    //lock the device/motherboard to this process
+    _mbc[mb].iface->lock_device(true);
+
+    ////////////////////////////////////////////////////////////////
+    // construct transports for RX and TX DSPs
+    ////////////////////////////////////////////////////////////////
+    UHD_LOG << "Making transport for RX DSP0..." << std::endl;
+    _mbc[mb].rx_dsp_xports.push_back(make_xport(
+        addr, BOOST_STRINGIZE(USRP2_UDP_RX_DSP0_PORT), device_args_i, "recv"
+    ));
+    UHD_LOG << "Making transport for RX DSP1..." << std::endl;
+    _mbc[mb].rx_dsp_xports.push_back(make_xport(
+        addr, BOOST_STRINGIZE(USRP2_UDP_RX_DSP1_PORT), device_args_i, "recv"
+    ));
+    UHD_LOG << "Making transport for TX DSP0..." << std::endl;
+    _mbc[mb].tx_dsp_xport = make_xport(
+        addr, BOOST_STRINGIZE(USRP2_UDP_TX_DSP0_PORT), device_args_i, "send"
+    );
+    UHD_LOG << "Making transport for Control..." << std::endl;
+    _mbc[mb].fifo_ctrl_xport = make_xport(
+        addr, BOOST_STRINGIZE(USRP2_UDP_FIFO_CRTL_PORT), device_addr_t(), ""
+    );
+    //set the filter on the router to take dsp data from this port
+    _mbc[mb].iface->poke32(U2_REG_ROUTER_CTRL_PORTS, (USRP2_UDP_FIFO_CRTL_PORT << 16) | USRP2_UDP_TX_DSP0_PORT);
+
+    //create the fifo control interface for high speed register access
+    _mbc[mb].fifo_ctrl = usrp2_fifo_ctrl::make(_mbc[mb].fifo_ctrl_xport);
+    switch(_mbc[mb].iface->get_rev()){
+    case usrp2_iface::USRP_N200:
+    case usrp2_iface::USRP_N210:
+    case usrp2_iface::USRP_N200_R4:
+    case usrp2_iface::USRP_N210_R4:
+        _mbc[mb].wbiface = _mbc[mb].fifo_ctrl;
+        _mbc[mb].spiface = _mbc[mb].fifo_ctrl;
+        break;
+    default:
+        _mbc[mb].wbiface = _mbc[mb].iface;
+        _mbc[mb].spiface = _mbc[mb].iface;
+        break;
+    }
+    _tree->create<double>(mb_path / "link_max_rate").set(USRP2_LINK_RATE_BPS);
+
+    ////////////////////////////////////////////////////////////////
+    // setup the mboard eeprom
+    ////////////////////////////////////////////////////////////////
+    _tree->create<mboard_eeprom_t>(mb_path / "eeprom")
+        .set(_mbc[mb].iface->mb_eeprom)
+        .add_coerced_subscriber(boost::bind(&usrp2_impl::set_mb_eeprom, this, mb, _1));
+
+    ////////////////////////////////////////////////////////////////
+    // create clock control objects
+    ////////////////////////////////////////////////////////////////
+    _mbc[mb].clock = usrp2_clock_ctrl::make(_mbc[mb].iface, _mbc[mb].spiface);
+    _tree->create<double>(mb_path / "tick_rate")
+        .set_publisher(boost::bind(&usrp2_clock_ctrl::get_master_clock_rate, _mbc[mb].clock))
+        .add_coerced_subscriber(boost::bind(&usrp2_impl::update_tick_rate, this, _1));
+
+    ////////////////////////////////////////////////////////////////
+    // create codec control objects
+    ////////////////////////////////////////////////////////////////
+    const fs_path rx_codec_path = mb_path / "rx_codecs/A";
+    const fs_path tx_codec_path = mb_path / "tx_codecs/A";
+    _tree->create<int>(rx_codec_path / "gains"); //phony property so this dir exists
+    _tree->create<int>(tx_codec_path / "gains"); //phony property so this dir exists
+    _mbc[mb].codec = usrp2_codec_ctrl::make(_mbc[mb].iface, _mbc[mb].spiface);
+    switch(_mbc[mb].iface->get_rev()){
+    case usrp2_iface::USRP_N200:
+    case usrp2_iface::USRP_N210:
+    case usrp2_iface::USRP_N200_R4:
+    case usrp2_iface::USRP_N210_R4:{
+        _tree->create<std::string>(rx_codec_path / "name").set("ads62p44");
+        _tree->create<meta_range_t>(rx_codec_path / "gains/digital/range").set(meta_range_t(0, 6.0, 0.5));
+        _tree->create<double>(rx_codec_path / "gains/digital/value")
+            .add_coerced_subscriber(boost::bind(&usrp2_codec_ctrl::set_rx_digital_gain, _mbc[mb].codec, _1)).set(0);
+        _tree->create<meta_range_t>(rx_codec_path / "gains/fine/range").set(meta_range_t(0, 0.5, 0.05));
+        _tree->create<double>(rx_codec_path / "gains/fine/value")
+            .add_coerced_subscriber(boost::bind(&usrp2_codec_ctrl::set_rx_digital_fine_gain, _mbc[mb].codec, _1)).set(0);
+    }break;
+
+    case usrp2_iface::USRP2_REV3:
+    case usrp2_iface::USRP2_REV4:
+        _tree->create<std::string>(rx_codec_path / "name").set("ltc2284");
+        break;
+
+    case usrp2_iface::USRP_NXXX:
+        _tree->create<std::string>(rx_codec_path / "name").set("??????");
+        break;
+    }
+    _tree->create<std::string>(tx_codec_path / "name").set("ad9777");
+
+    ////////////////////////////////////////////////////////////////////
+    // Create the GPSDO control
+    ////////////////////////////////////////////////////////////////////
+    static const boost::uint32_t dont_look_for_gpsdo = 0x1234abcdul;
+
+    //disable check for internal GPSDO when not the following:
+    switch(_mbc[mb].iface->get_rev()){
+    case usrp2_iface::USRP_N200:
+    case usrp2_iface::USRP_N210:
+    case usrp2_iface::USRP_N200_R4:
+    case usrp2_iface::USRP_N210_R4:
+        break;
+    default:
+        _mbc[mb].iface->pokefw(U2_FW_REG_HAS_GPSDO, dont_look_for_gpsdo);
+    }
+
+    //otherwise if not disabled, look for the internal GPSDO
+    if (_mbc[mb].iface->peekfw(U2_FW_REG_HAS_GPSDO) != dont_look_for_gpsdo)
+    {
+        UHD_MSG(status) << "Detecting internal GPSDO.... " << std::flush;
+        try{
+            _mbc[mb].gps = gps_ctrl::make(udp_simple::make_uart(udp_simple::make_connected(
+                addr, BOOST_STRINGIZE(USRP2_UDP_UART_GPS_PORT)
+            )));
+        }
+        catch(std::exception &e){
+            UHD_MSG(error) << "An error occurred making GPSDO control: " << e.what() << std::endl;
+        }
+        if (_mbc[mb].gps and _mbc[mb].gps->gps_detected())
+        {
+            BOOST_FOREACH(const std::string &name, _mbc[mb].gps->get_sensors())
+            {
+                _tree->create<sensor_value_t>(mb_path / "sensors" / name)
+                    .set_publisher(boost::bind(&gps_ctrl::get_sensor, _mbc[mb].gps, name));
+            }
+        }
+        else
+        {
+            _mbc[mb].iface->pokefw(U2_FW_REG_HAS_GPSDO, dont_look_for_gpsdo);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // and do the misc mboard sensors
+    ////////////////////////////////////////////////////////////////
+    _tree->create<sensor_value_t>(mb_path / "sensors/mimo_locked")
+        .set_publisher(boost::bind(&usrp2_impl::get_mimo_locked, this, mb));
+    _tree->create<sensor_value_t>(mb_path / "sensors/ref_locked")
+        .set_publisher(boost::bind(&usrp2_impl::get_ref_locked, this, mb));
+
+    ////////////////////////////////////////////////////////////////
+    // create frontend control objects
+    ////////////////////////////////////////////////////////////////
+    _mbc[mb].rx_fe = rx_frontend_core_200::make(
+        _mbc[mb].wbiface, U2_REG_SR_ADDR(SR_RX_FRONT)
+    );
+    _mbc[mb].tx_fe = tx_frontend_core_200::make(
+        _mbc[mb].wbiface, U2_REG_SR_ADDR(SR_TX_FRONT)
+    );
+
+    _tree->create<subdev_spec_t>(mb_path / "rx_subdev_spec")
+        .add_coerced_subscriber(boost::bind(&usrp2_impl::update_rx_subdev_spec, this, mb, _1));
+    _tree->create<subdev_spec_t>(mb_path / "tx_subdev_spec")
+        .add_coerced_subscriber(boost::bind(&usrp2_impl::update_tx_subdev_spec, this, mb, _1));
+
+    const fs_path rx_fe_path = mb_path / "rx_frontends" / "A";
+    const fs_path tx_fe_path = mb_path / "tx_frontends" / "A";
+
+    _tree->create<std::complex<double> >(rx_fe_path / "dc_offset" / "value")
+        .set_coercer(boost::bind(&rx_frontend_core_200::set_dc_offset, _mbc[mb].rx_fe, _1))
+        .set(std::complex<double>(0.0, 0.0));
+    _tree->create<bool>(rx_fe_path / "dc_offset" / "enable")
+        .add_coerced_subscriber(boost::bind(&rx_frontend_core_200::set_dc_offset_auto, _mbc[mb].rx_fe, _1))
+        .set(true);
+    _tree->create<std::complex<double> >(rx_fe_path / "iq_balance" / "value")
+        .add_coerced_subscriber(boost::bind(&rx_frontend_core_200::set_iq_balance, _mbc[mb].rx_fe, _1))
+        .set(std::complex<double>(0.0, 0.0));
+    _tree->create<std::complex<double> >(tx_fe_path / "dc_offset" / "value")
+        .set_coercer(boost::bind(&tx_frontend_core_200::set_dc_offset, _mbc[mb].tx_fe, _1))
+        .set(std::complex<double>(0.0, 0.0));
+    _tree->create<std::complex<double> >(tx_fe_path / "iq_balance" / "value")
+        .add_coerced_subscriber(boost::bind(&tx_frontend_core_200::set_iq_balance, _mbc[mb].tx_fe, _1))
+        .set(std::complex<double>(0.0, 0.0));
+
+    ////////////////////////////////////////////////////////////////
+    // create rx dsp control objects
+    ////////////////////////////////////////////////////////////////
+    _mbc[mb].rx_dsps.push_back(rx_dsp_core_200::make(
+        _mbc[mb].wbiface, U2_REG_SR_ADDR(SR_RX_DSP0), U2_REG_SR_ADDR(SR_RX_CTRL0), USRP2_RX_SID_BASE + 0, true
+    ));
+    _mbc[mb].rx_dsps.push_back(rx_dsp_core_200::make(
+        _mbc[mb].wbiface, U2_REG_SR_ADDR(SR_RX_DSP1), U2_REG_SR_ADDR(SR_RX_CTRL1), USRP2_RX_SID_BASE + 1, true
+    ));
+    for (size_t dspno = 0; dspno < _mbc[mb].rx_dsps.size(); dspno++){
+        _mbc[mb].rx_dsps[dspno]->set_link_rate(USRP2_LINK_RATE_BPS);
+        _tree->access<double>(mb_path / "tick_rate")
+            .add_coerced_subscriber(boost::bind(&rx_dsp_core_200::set_tick_rate, _mbc[mb].rx_dsps[dspno], _1));
+        fs_path rx_dsp_path = mb_path / str(boost::format("rx_dsps/%u") % dspno);
+        _tree->create<meta_range_t>(rx_dsp_path / "rate/range")
+            .set_publisher(boost::bind(&rx_dsp_core_200::get_host_rates, _mbc[mb].rx_dsps[dspno]));
+        _tree->create<double>(rx_dsp_path / "rate/value")
+            .set(1e6) //some default
+            .set_coercer(boost::bind(&rx_dsp_core_200::set_host_rate, _mbc[mb].rx_dsps[dspno], _1))
+            .add_coerced_subscriber(boost::bind(&usrp2_impl::update_rx_samp_rate, this, mb, dspno, _1));
+        _tree->create<double>(rx_dsp_path / "freq/value")
+            .set_coercer(boost::bind(&rx_dsp_core_200::set_freq, _mbc[mb].rx_dsps[dspno], _1));
+        _tree->create<meta_range_t>(rx_dsp_path / "freq/range")
+            .set_publisher(boost::bind(&rx_dsp_core_200::get_freq_range, _mbc[mb].rx_dsps[dspno]));
+        _tree->create<stream_cmd_t>(rx_dsp_path / "stream_cmd")
+            .add_coerced_subscriber(boost::bind(&rx_dsp_core_200::issue_stream_command, _mbc[mb].rx_dsps[dspno], _1));
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // create tx dsp control objects
+    ////////////////////////////////////////////////////////////////
+    _mbc[mb].tx_dsp = tx_dsp_core_200::make(
+        _mbc[mb].wbiface, U2_REG_SR_ADDR(SR_TX_DSP), U2_REG_SR_ADDR(SR_TX_CTRL), USRP2_TX_ASYNC_SID
+    );
+    _mbc[mb].tx_dsp->set_link_rate(USRP2_LINK_RATE_BPS);
+    _tree->access<double>(mb_path / "tick_rate")
+        .add_coerced_subscriber(boost::bind(&tx_dsp_core_200::set_tick_rate, _mbc[mb].tx_dsp, _1));
+    _tree->create<meta_range_t>(mb_path / "tx_dsps/0/rate/range")
+        .set_publisher(boost::bind(&tx_dsp_core_200::get_host_rates, _mbc[mb].tx_dsp));
+    _tree->create<double>(mb_path / "tx_dsps/0/rate/value")
+        .set(1e6) //some default
+        .set_coercer(boost::bind(&tx_dsp_core_200::set_host_rate, _mbc[mb].tx_dsp, _1))
+        .add_coerced_subscriber(boost::bind(&usrp2_impl::update_tx_samp_rate, this, mb, 0, _1));
+    _tree->create<double>(mb_path / "tx_dsps/0/freq/value")
+        .set_coercer(boost::bind(&tx_dsp_core_200::set_freq, _mbc[mb].tx_dsp, _1));
+    _tree->create<meta_range_t>(mb_path / "tx_dsps/0/freq/range")
+        .set_publisher(boost::bind(&tx_dsp_core_200::get_freq_range, _mbc[mb].tx_dsp));
+
+    //setup dsp flow control
+    const double ups_per_sec = device_args_i.cast<double>("ups_per_sec", 20);
+    const size_t send_frame_size = _mbc[mb].tx_dsp_xport->get_send_frame_size();
+    const double ups_per_fifo = device_args_i.cast<double>("ups_per_fifo", 8.0);
+    _mbc[mb].tx_dsp->set_updates(
+        (ups_per_sec > 0.0)? size_t(100e6/*approx tick rate*//ups_per_sec) : 0,
+        (ups_per_fifo > 0.0)? size_t(USRP2_SRAM_BYTES/ups_per_fifo/send_frame_size) : 0
+    );
+
+    ////////////////////////////////////////////////////////////////
+    // create time control objects
+    ////////////////////////////////////////////////////////////////
+    time64_core_200::readback_bases_type time64_rb_bases;
+    time64_rb_bases.rb_hi_now = U2_REG_TIME64_HI_RB_IMM;
+    time64_rb_bases.rb_lo_now = U2_REG_TIME64_LO_RB_IMM;
+    time64_rb_bases.rb_hi_pps = U2_REG_TIME64_HI_RB_PPS;
+    time64_rb_bases.rb_lo_pps = U2_REG_TIME64_LO_RB_PPS;
+    _mbc[mb].time64 = time64_core_200::make(
+        _mbc[mb].wbiface, U2_REG_SR_ADDR(SR_TIME64), time64_rb_bases, mimo_clock_sync_delay_cycles
+    );
+    _tree->access<double>(mb_path / "tick_rate")
+        .add_coerced_subscriber(boost::bind(&time64_core_200::set_tick_rate, _mbc[mb].time64, _1));
+    _tree->create<time_spec_t>(mb_path / "time/now")
+        .set_publisher(boost::bind(&time64_core_200::get_time_now, _mbc[mb].time64))
+        .add_coerced_subscriber(boost::bind(&time64_core_200::set_time_now, _mbc[mb].time64, _1));
+    _tree->create<time_spec_t>(mb_path / "time/pps")
+        .set_publisher(boost::bind(&time64_core_200::get_time_last_pps, _mbc[mb].time64))
+        .add_coerced_subscriber(boost::bind(&time64_core_200::set_time_next_pps, _mbc[mb].time64, _1));
+    //setup time source props
+    _tree->create<std::string>(mb_path / "time_source/value")
+        .add_coerced_subscriber(boost::bind(&time64_core_200::set_time_source, _mbc[mb].time64, _1))
+        .set("none");
+    _tree->create<std::vector<std::string> >(mb_path / "time_source/options")
+        .set_publisher(boost::bind(&time64_core_200::get_time_sources, _mbc[mb].time64));
+    //setup reference source props
+    _tree->create<std::string>(mb_path / "clock_source/value")
+        .add_coerced_subscriber(boost::bind(&usrp2_impl::update_clock_source, this, mb, _1))
+        .set("internal");
+    std::vector<std::string> clock_sources = boost::assign::list_of("internal")("external")("mimo");
+    if (_mbc[mb].gps and _mbc[mb].gps->gps_detected()) clock_sources.push_back("gpsdo");
+    _tree->create<std::vector<std::string> >(mb_path / "clock_source/options").set(clock_sources);
+    //plug timed commands into tree here
+    switch(_mbc[mb].iface->get_rev()){
+    case usrp2_iface::USRP_N200:
+    case usrp2_iface::USRP_N210:
+    case usrp2_iface::USRP_N200_R4:
+    case usrp2_iface::USRP_N210_R4:
+        _tree->create<time_spec_t>(mb_path / "time/cmd")
+            .add_coerced_subscriber(boost::bind(&usrp2_fifo_ctrl::set_time, _mbc[mb].fifo_ctrl, _1));
+    default: break; //otherwise, do not register
+    }
+    _tree->access<double>(mb_path / "tick_rate")
+        .add_coerced_subscriber(boost::bind(&usrp2_fifo_ctrl::set_tick_rate, _mbc[mb].fifo_ctrl, _1));
+
+    ////////////////////////////////////////////////////////////////////
+    // create user-defined control objects
+    ////////////////////////////////////////////////////////////////////
+    _mbc[mb].user = user_settings_core_200::make(_mbc[mb].wbiface, U2_REG_SR_ADDR(SR_USER_REGS));
+    _tree->create<user_settings_core_200::user_reg_t>(mb_path / "user/regs")
+        .add_coerced_subscriber(boost::bind(&user_settings_core_200::set_reg, _mbc[mb].user, _1));
+
+    ////////////////////////////////////////////////////////////////
+    // create dboard control objects
+    ////////////////////////////////////////////////////////////////
+
+    //read the dboard eeprom to extract the dboard ids
+    dboard_eeprom_t rx_db_eeprom, tx_db_eeprom, gdb_eeprom;
+    rx_db_eeprom.load(*_mbc[mb].iface, USRP2_I2C_ADDR_RX_DB);
+    tx_db_eeprom.load(*_mbc[mb].iface, USRP2_I2C_ADDR_TX_DB);
+    gdb_eeprom.load(*_mbc[mb].iface, USRP2_I2C_ADDR_TX_DB ^ 5);
+
+    //disable rx dc offset if LFRX
+    if (rx_db_eeprom.id == 0x000f) _tree->access<bool>(rx_fe_path / "dc_offset" / "enable").set(false);
+
+    //create the properties and register subscribers
+    _tree->create<dboard_eeprom_t>(mb_path / "dboards/A/rx_eeprom")
+        .set(rx_db_eeprom)
+        .add_coerced_subscriber(boost::bind(&usrp2_impl::set_db_eeprom, this, mb, "rx", _1));
+    _tree->create<dboard_eeprom_t>(mb_path / "dboards/A/tx_eeprom")
+        .set(tx_db_eeprom)
+        .add_coerced_subscriber(boost::bind(&usrp2_impl::set_db_eeprom, this, mb, "tx", _1));
+    _tree->create<dboard_eeprom_t>(mb_path / "dboards/A/gdb_eeprom")
+        .set(gdb_eeprom)
+        .add_coerced_subscriber(boost::bind(&usrp2_impl::set_db_eeprom, this, mb, "gdb", _1));
+
+    //create a new dboard interface and manager
+    _mbc[mb].dboard_manager = dboard_manager::make(
+        rx_db_eeprom.id, tx_db_eeprom.id, gdb_eeprom.id,
+        make_usrp2_dboard_iface(_mbc[mb].wbiface, _mbc[mb].iface/*i2c*/, _mbc[mb].spiface, _mbc[mb].clock),
+        _tree->subtree(mb_path / "dboards/A")
+    );
+
+    //bind frontend corrections to the dboard freq props
+    const fs_path db_tx_fe_path = mb_path / "dboards" / "A" / "tx_frontends";
+    BOOST_FOREACH(const std::string &name, _tree->list(db_tx_fe_path)){
+        _tree->access<double>(db_tx_fe_path / name / "freq" / "value")
+            .add_coerced_subscriber(boost::bind(&usrp2_impl::set_tx_fe_corrections, this, mb, _1));
+    }
+    const fs_path db_rx_fe_path = mb_path / "dboards" / "A" / "rx_frontends";
+    BOOST_FOREACH(const std::string &name, _tree->list(db_rx_fe_path)){
+        _tree->access<double>(db_rx_fe_path / name / "freq" / "value")
+            .add_coerced_subscriber(boost::bind(&usrp2_impl::set_rx_fe_corrections, this, mb, _1));
+    }
+}
+
 usrp2_impl::~usrp2_impl(void){UHD_SAFE_CALL(
     BOOST_FOREACH(const std::string &mb, _mbc.keys()){
         _mbc[mb].tx_dsp->set_updates(0, 0);
@@ -106,6 +106,7 @@ private:
         mb_container_type(void): rx_chan_occ(0), tx_chan_occ(0){}
     };
     uhd::dict<std::string, mb_container_type> _mbc;
+    void setup_mb(const size_t mbi, const uhd::device_addr_t &device_args_i);
 
     void set_mb_eeprom(const std::string &, const uhd::usrp::mboard_eeprom_t &);
     void set_db_eeprom(const std::string &, const std::string &, const uhd::usrp::dboard_eeprom_t &);
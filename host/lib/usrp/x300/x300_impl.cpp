@@ -21,6 +21,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/asio.hpp>
 #include "apply_corrections.hpp"
+#include "parallel_mboard_setup.hpp"
 #include <uhd/utils/static.hpp>
 #include <uhd/utils/msg.hpp>
 #include <uhd/utils/paths.hpp>
@@ -380,10 +381,19 @@ x300_impl::x300_impl(const uhd::device_addr_t &dev_addr)
 
     const device_addrs_t device_args = separate_device_addr(dev_addr);
     _mb.resize(device_args.size());
+
+    //create the motherboard nodes in order, their setups finish in any order
     for (size_t i = 0; i < device_args.size(); i++)
     {
-        this->setup_mb(i, device_args[i]);
+        const fs_path mb_path = "/mboards/"+boost::lexical_cast<std::string>(i);
+        _tree->create<std::string>(mb_path / "name");
     }
+
+    //the motherboards are independent, so set them up in parallel
+    parallel_mboard_setup::run(
+        boost::bind(&x300_impl::setup_mb, this, _1, _2),
+        device_args,
+        dev_addr.cast<size_t>("init_threads", device_args.size()));
 }
 
 void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
@@ -469,16 +479,16 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
 
         // Detect the frame size on the path to the USRP
         try {
-            _max_frame_sizes = determine_max_frame_size(mb.addr, req_max_frame_size);
+            mb.max_frame_sizes = determine_max_frame_size(mb.addr, req_max_frame_size);
         } catch(std::exception &e) {
             UHD_MSG(error) << e.what() << std::endl;
         }
 
         if ((mb.recv_args.has_key("recv_frame_size"))
-                && (req_max_frame_size.recv_frame_size < _max_frame_sizes.recv_frame_size)) {
+                && (req_max_frame_size.recv_frame_size < mb.max_frame_sizes.recv_frame_size)) {
             UHD_MSG(warning)
                 << boost::format("You requested a receive frame size of (%lu) but your NIC's max frame size is (%lu).")
-                % req_max_frame_size.recv_frame_size << _max_frame_sizes.recv_frame_size << std::endl
+                % req_max_frame_size.recv_frame_size << mb.max_frame_sizes.recv_frame_size << std::endl
                 << boost::format("Please verify your NIC's MTU setting using '%s' or set the recv_frame_size argument appropriately.")
                 % mtu_tool << std::endl
                 << "UHD will use the auto-detected max frame size for this connection."
@@ -486,10 +496,10 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
         }
 
         if ((mb.recv_args.has_key("send_frame_size"))
-                && (req_max_frame_size.send_frame_size < _max_frame_sizes.send_frame_size)) {
+                && (req_max_frame_size.send_frame_size < mb.max_frame_sizes.send_frame_size)) {
             UHD_MSG(warning)
                 << boost::format("You requested a send frame size of (%lu) but your NIC's max frame size is (%lu).")
-                % req_max_frame_size.send_frame_size << _max_frame_sizes.send_frame_size << std::endl
+                % req_max_frame_size.send_frame_size << mb.max_frame_sizes.send_frame_size << std::endl
                 << boost::format("Please verify your NIC's MTU setting using '%s' or set the send_frame_size argument appropriately.")
                 % mtu_tool << std::endl
                 << "UHD will use the auto-detected max frame size for this connection."
@@ -502,7 +512,7 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
     //create basic communication
     UHD_MSG(status) << "Setup basic communication..." << std::endl;
     if (mb.xport_path == "nirio") {
-        boost::mutex::scoped_lock(pcie_zpu_iface_registry_mutex);
+        boost::mutex::scoped_lock lock(pcie_zpu_iface_registry_mutex);
         if (get_pcie_zpu_iface_registry().has_key(mb.addr)) {
             throw uhd::assertion_error("Someone else has a ZPU transport to the device open. Internal error!");
         } else {
@@ -516,6 +526,13 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
 
     mb.claimer_task = uhd::task::make(boost::bind(&x300_impl::claimer_loop, this, mb.zpu_ctrl));
 
+    //optionally trace the register accesses (after the claimer, it pokes every second)
+    if (dev_addr.has_key("trace_ctrl")) {
+        wb_iface_tracer::sptr tracer = wb_iface_tracer::make(mb.zpu_ctrl);
+        tracer->populate_subtree(_tree->subtree(mb_path / "ctrl_trace" / "zpu"));
+        mb.zpu_ctrl = tracer;
+    }
+
     //extract the FW path for the X300
     //and live load fw over ethernet link
     if (dev_addr.has_key("fw"))
@@ -604,7 +621,7 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
                                          "Either the software does not support this device in which case please update your driver software to the latest version and retry OR\n"
                                          "The product code in the EEPROM is corrupt and may require reprogramming.");
     }
-    _tree->create<std::string>(mb_path / "name").set(product_name);
+    _tree->access<std::string>(mb_path / "name").set(product_name);
     _tree->create<std::string>(mb_path / "codename").set("Yetti");
 
     ////////////////////////////////////////////////////////////////////
@@ -891,6 +908,12 @@ void x300_impl::setup_mb(const size_t mb_i, const uhd::device_addr_t &dev_addr)
     tx_fe_spec.push_back(subdev_spec_pair_t("B",
                 _tree->list(mb_path / "dboards" / "B" / "tx_frontends").at(0)));
 
+    //with lazy dboards, the initial spec decides which frontends are made right away
+    if (dev_addr.has_key("lazy_dboards")) {
+        if (dev_addr.has_key("rx_subdev_spec")) rx_fe_spec = subdev_spec_t(dev_addr["rx_subdev_spec"]);
+        if (dev_addr.has_key("tx_subdev_spec")) tx_fe_spec = subdev_spec_t(dev_addr["tx_subdev_spec"]);
+    }
+
     _tree->access<subdev_spec_t>(mb_path / "rx_subdev_spec").set(rx_fe_spec);
     _tree->access<subdev_spec_t>(mb_path / "tx_subdev_spec").set(tx_fe_spec);
 
@@ -922,7 +945,7 @@ x300_impl::~x300_impl(void)
             //kill the claimer task and unclaim the device
             mb.claimer_task.reset();
             {   //Critical section
-                boost::mutex::scoped_lock(pcie_zpu_iface_registry_mutex);
+                boost::mutex::scoped_lock lock(pcie_zpu_iface_registry_mutex);
                 mb.zpu_ctrl->poke32(SR_ADDR(X300_FW_SHMEM_BASE, X300_FW_SHMEM_CLAIM_TIME), 0);
                 mb.zpu_ctrl->poke32(SR_ADDR(X300_FW_SHMEM_BASE, X300_FW_SHMEM_CLAIM_SRC), 0);
                 //If the process is killed, the entire registry will disappear so we
@@ -955,8 +978,17 @@ void x300_impl::setup_radio(const size_t mb_i, const std::string &slot_name, con
     both_xports_t xport = this->make_transport(mb_i, dest, X300_RADIO_DEST_PREFIX_CTRL, device_addr_t(), ctrl_sid);
     perif.ctrl = radio_ctrl_core_3000::make(mb.if_pkt_is_big_endian, xport.recv, xport.send, ctrl_sid, slot_name);
 
+    //the peripherals access the radio registers through perif.regs,
+    //which is the control itself or a tracer around it
+    perif.regs = perif.ctrl;
+    if (dev_addr.has_key("trace_ctrl")) {
+        wb_iface_tracer::sptr tracer = wb_iface_tracer::make(perif.ctrl);
+        tracer->populate_subtree(_tree->subtree(mb_path / "ctrl_trace" / str(boost::format("radio%d") % radio_index)));
+        perif.regs = tracer;
+    }
+
     perif.regmap = boost::make_shared<radio_regmap_t>(radio_index);
-    perif.regmap->initialize(*perif.ctrl, true);
+    perif.regmap->initialize(*perif.regs, true);
 
     //Only Radio0 has the ADC/DAC reset bits. Those bits are reserved for Radio1
     if (radio_index == 0) {
@@ -974,25 +1006,25 @@ void x300_impl::setup_radio(const size_t mb_i, const std::string &slot_name, con
     ////////////////////////////////////////////////////////////////
     // Setup peripherals
     ////////////////////////////////////////////////////////////////
-    perif.spi = spi_core_3000::make(perif.ctrl, radio::sr_addr(radio::SPI), radio::RB32_SPI);
+    perif.spi = spi_core_3000::make(perif.regs, radio::sr_addr(radio::SPI), radio::RB32_SPI);
     perif.adc = x300_adc_ctrl::make(perif.spi, DB_ADC_SEN);
     perif.dac = x300_dac_ctrl::make(perif.spi, DB_DAC_SEN, mb.clock->get_master_clock_rate());
-    perif.leds = gpio_atr_3000::make_write_only(perif.ctrl, radio::sr_addr(radio::LEDS));
+    perif.leds = gpio_atr_3000::make_write_only(perif.regs, radio::sr_addr(radio::LEDS));
     perif.leds->set_atr_mode(MODE_ATR, 0xFFFFFFFF);
-    perif.rx_fe = rx_frontend_core_200::make(perif.ctrl, radio::sr_addr(radio::RX_FRONT));
+    perif.rx_fe = rx_frontend_core_200::make(perif.regs, radio::sr_addr(radio::RX_FRONT));
     perif.rx_fe->set_dc_offset(rx_frontend_core_200::DEFAULT_DC_OFFSET_VALUE);
     perif.rx_fe->set_dc_offset_auto(rx_frontend_core_200::DEFAULT_DC_OFFSET_ENABLE);
-    perif.tx_fe = tx_frontend_core_200::make(perif.ctrl, radio::sr_addr(radio::TX_FRONT));
+    perif.tx_fe = tx_frontend_core_200::make(perif.regs, radio::sr_addr(radio::TX_FRONT));
     perif.tx_fe->set_dc_offset(tx_frontend_core_200::DEFAULT_DC_OFFSET_VALUE);
     perif.tx_fe->set_iq_balance(tx_frontend_core_200::DEFAULT_IQ_BALANCE_VALUE);
-    perif.framer = rx_vita_core_3000::make(perif.ctrl, radio::sr_addr(radio::RX_CTRL));
-    perif.ddc = rx_dsp_core_3000::make(perif.ctrl, radio::sr_addr(radio::RX_DSP));
+    perif.framer = rx_vita_core_3000::make(perif.regs, radio::sr_addr(radio::RX_CTRL));
+    perif.ddc = rx_dsp_core_3000::make(perif.regs, radio::sr_addr(radio::RX_DSP));
     perif.ddc->set_link_rate(10e9/8); //whatever
     //The DRAM FIFO is treated as in internal radio FIFO for flow control purposes
     tx_vita_core_3000::fc_monitor_loc fc_loc =
         mb.has_dram_buff ? tx_vita_core_3000::FC_PRE_FIFO : tx_vita_core_3000::FC_PRE_RADIO;
-    perif.deframer = tx_vita_core_3000::make(perif.ctrl, radio::sr_addr(radio::TX_CTRL), fc_loc);
-    perif.duc = tx_dsp_core_3000::make(perif.ctrl, radio::sr_addr(radio::TX_DSP));
+    perif.deframer = tx_vita_core_3000::make(perif.regs, radio::sr_addr(radio::TX_CTRL), fc_loc);
+    perif.duc = tx_dsp_core_3000::make(perif.regs, radio::sr_addr(radio::TX_DSP));
     perif.duc->set_link_rate(10e9/8); //whatever
 
     ////////////////////////////////////////////////////////////////////
@@ -1001,7 +1033,7 @@ void x300_impl::setup_radio(const size_t mb_i, const std::string &slot_name, con
     time_core_3000::readback_bases_type time64_rb_bases;
     time64_rb_bases.rb_now = radio::RB64_TIME_NOW;
     time64_rb_bases.rb_pps = radio::RB64_TIME_PPS;
-    perif.time64 = time_core_3000::make(perif.ctrl, radio::sr_addr(radio::TIME), time64_rb_bases);
+    perif.time64 = time_core_3000::make(perif.regs, radio::sr_addr(radio::TIME), time64_rb_bases);
 
     //Capture delays are calibrated every time. The status is only printed is the user
     //asks to run the xfer self cal using "self_cal_adc_delay"
@@ -1065,7 +1097,7 @@ void x300_impl::setup_radio(const size_t mb_i, const std::string &slot_name, con
 
     //create a new dboard interface
     x300_dboard_iface_config_t db_config;
-    db_config.gpio = db_gpio_atr_3000::make(perif.ctrl, radio::sr_addr(radio::GPIO), radio::RB32_GPIO);
+    db_config.gpio = db_gpio_atr_3000::make(perif.regs, radio::sr_addr(radio::GPIO), radio::RB32_GPIO);
     db_config.spi = perif.spi;
     db_config.rx_spi_slaveno = DB_RX_SEN;
     db_config.tx_spi_slaveno = DB_TX_SEN;
@@ -1076,31 +1108,56 @@ void x300_impl::setup_radio(const size_t mb_i, const std::string &slot_name, con
     db_config.dboard_slot = (slot_name == "A")? 0 : 1;
     db_config.cmd_time_ctrl = perif.ctrl;
 
-    //create a new dboard manager
-    _dboard_managers[db_path] = dboard_manager::make(
+    //create a new dboard manager, lazy dboards make each frontend on first use
+    const bool lazy_dboards = dev_addr.has_key("lazy_dboards");
+    dboard_manager::sptr db_manager = dboard_manager::make(
         mb.db_eeproms[X300_DB0_RX_EEPROM | j].id,
         mb.db_eeproms[X300_DB0_TX_EEPROM | j].id,
         mb.db_eeproms[X300_DB0_GDB_EEPROM | j].id,
         x300_make_dboard_iface(db_config),
-        _tree->subtree(db_path)
+        _tree->subtree(db_path),
+        lazy_dboards
     );
-
-    //now that dboard is created -- register into rx antenna event
-    const std::string fe_name = _tree->list(db_path / "rx_frontends").front();
-    _tree->access<std::string>(db_path / "rx_frontends" / fe_name / "antenna" / "value")
-        .add_coerced_subscriber(boost::bind(&x300_impl::update_atr_leds, this, mb.radio_perifs[radio_index].leds, _1));
+    {
+        boost::mutex::scoped_lock lock(_mb_setup_mutex);
+        _dboard_managers[db_path] = db_manager;
+    }
     this->update_atr_leds(mb.radio_perifs[radio_index].leds, ""); //init anyway, even if never called
 
-    //bind frontend corrections to the dboard freq props
-    const fs_path db_tx_fe_path = db_path / "tx_frontends";
-    BOOST_FOREACH(const std::string &name, _tree->list(db_tx_fe_path)) {
-        _tree->access<double>(db_tx_fe_path / name / "freq" / "value")
-            .add_coerced_subscriber(boost::bind(&x300_impl::set_tx_fe_corrections, this, mb_path, slot_name, _1));
+    //connect each frontend once its dboard made it
+    static const std::vector<std::string> directions = boost::assign::list_of("rx")("tx");
+    BOOST_FOREACH(const std::string &tx_rx, directions) {
+        const fs_path db_fe_path = db_path / (tx_rx + "_frontends");
+        BOOST_FOREACH(const std::string &name, _tree->list(db_fe_path)) {
+            const property_tree::lazy_init_type connect =
+                boost::bind(&x300_impl::connect_frontend, this, mb_i, slot_name, tx_rx, name);
+            if (lazy_dboards) _tree->create_lazy(db_fe_path / name, connect);
+            else connect();
+        }
     }
-    const fs_path db_rx_fe_path = db_path / "rx_frontends";
-    BOOST_FOREACH(const std::string &name, _tree->list(db_rx_fe_path)) {
-        _tree->access<double>(db_rx_fe_path / name / "freq" / "value")
+}
+
+void x300_impl::connect_frontend(
+    const size_t mb_i, const std::string &slot_name,
+    const std::string &tx_rx, const std::string &fe_name)
+{
+    const fs_path mb_path = "/mboards/"+boost::lexical_cast<std::string>(mb_i);
+    mboard_members_t &mb = _mb[mb_i];
+    const fs_path db_fe_path = mb_path / "dboards" / slot_name / (tx_rx + "_frontends");
+
+    //the antenna of the first rx frontend drives the ATR LEDs
+    if (tx_rx == "rx" and fe_name == _tree->list(db_fe_path).front()) {
+        _tree->access<std::string>(db_fe_path / fe_name / "antenna" / "value")
+            .add_coerced_subscriber(boost::bind(&x300_impl::update_atr_leds, this, mb.radio_perifs[mb.get_radio_index(slot_name)].leds, _1));
+    }
+
+    //bind frontend corrections to the dboard freq props
+    if (tx_rx == "rx") {
+        _tree->access<double>(db_fe_path / fe_name / "freq" / "value")
             .add_coerced_subscriber(boost::bind(&x300_impl::set_rx_fe_corrections, this, mb_path, slot_name, _1));
+    } else {
+        _tree->access<double>(db_fe_path / fe_name / "freq" / "value")
+            .add_coerced_subscriber(boost::bind(&x300_impl::set_tx_fe_corrections, this, mb_path, slot_name, _1));
     }
 }
 
@@ -1211,28 +1268,28 @@ x300_impl::both_xports_t x300_impl::make_transport(
 
         /* Print a warning if the system's max available frame size is less than the most optimal
          * frame size for this type of connection. */
-        if (_max_frame_sizes.send_frame_size < eth_data_rec_frame_size) {
+        if (mb.max_frame_sizes.send_frame_size < eth_data_rec_frame_size) {
             UHD_MSG(warning)
                 << boost::format("For this connection, UHD recommends a send frame size of at least %lu for best\nperformance, but your system's MTU will only allow %lu.")
                 % eth_data_rec_frame_size
-                % _max_frame_sizes.send_frame_size
+                % mb.max_frame_sizes.send_frame_size
                 << std::endl
                 << "This will negatively impact your maximum achievable sample rate."
                 << std::endl;
         }
 
-        if (_max_frame_sizes.recv_frame_size < eth_data_rec_frame_size) {
+        if (mb.max_frame_sizes.recv_frame_size < eth_data_rec_frame_size) {
             UHD_MSG(warning)
                 << boost::format("For this connection, UHD recommends a receive frame size of at least %lu for best\nperformance, but your system's MTU will only allow %lu.")
                 % eth_data_rec_frame_size
-                % _max_frame_sizes.recv_frame_size
+                % mb.max_frame_sizes.recv_frame_size
                 << std::endl
                 << "This will negatively impact your maximum achievable sample rate."
                 << std::endl;
         }
 
-        size_t system_max_send_frame_size = (size_t) _max_frame_sizes.send_frame_size;
-        size_t system_max_recv_frame_size = (size_t) _max_frame_sizes.recv_frame_size;
+        size_t system_max_send_frame_size = (size_t) mb.max_frame_sizes.send_frame_size;
+        size_t system_max_recv_frame_size = (size_t) mb.max_frame_sizes.recv_frame_size;
 
         // Make sure frame sizes do not exceed the max available value supported by UHD
         default_buff_args.send_frame_size =
@@ -1305,15 +1362,22 @@ boost::uint32_t x300_impl::allocate_sid(mboard_members_t &mb, const sid_config_t
     const std::string &xport_path = mb.xport_path;
     const boost::uint32_t stream = (config.dst_prefix | (config.router_dst_there << 2)) & 0xff;
 
+    //take the next framer, motherboards may allocate concurrently
+    size_t sid_framer;
+    {
+        boost::mutex::scoped_lock lock(_mb_setup_mutex);
+        sid_framer = _sid_framer++;
+    }
+
     const boost::uint32_t sid = 0
         | (X300_DEVICE_HERE << 24)
-        | (_sid_framer << 16)
+        | (sid_framer << 16)
         | (config.router_addr_there << 8)
         | (stream << 0)
     ;
     UHD_LOG << std::hex
         << " sid 0x" << sid
-        << " framer 0x" << _sid_framer
+        << " framer 0x" << sid_framer
         << " stream 0x" << stream
         << " router_dst_there 0x" << int(config.router_dst_there)
         << " router_addr_there 0x" << int(config.router_addr_there)
@@ -1329,7 +1393,7 @@ boost::uint32_t x300_impl::allocate_sid(mboard_members_t &mb, const sid_config_t
     mb.zpu_ctrl->poke32(SR_ADDR(SETXB_BASE, 0 + (X300_DEVICE_HERE)), config.router_dst_here);
 
     if (xport_path == "nirio") {
-        boost::uint32_t router_config_word = ((_sid_framer & 0xff) << 16) |                                    //Return SID
+        boost::uint32_t router_config_word = ((sid_framer & 0xff) << 16) |                                    //Return SID
                                       get_pcie_dma_channel(config.router_dst_there, config.dst_prefix); //Dest
         mb.rio_fpga_interface->get_kernel_proxy()->poke(PCIE_ROUTER_REG(0), router_config_word);
     }
@@ -1338,9 +1402,6 @@ boost::uint32_t x300_impl::allocate_sid(mboard_members_t &mb, const sid_config_t
         << "done router config for sid 0x" << sid
         << std::dec << std::endl;
 
-    //increment for next setup
-    _sid_framer++;
-
     return sid;
 }
 
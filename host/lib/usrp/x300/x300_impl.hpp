@@ -43,6 +43,7 @@
 #include "tx_frontend_core_200.hpp"
 #include "gpio_atr_3000.hpp"
 #include "dma_fifo_core_3000.hpp"
+#include "wb_iface_tracer.hpp"
 #include <boost/weak_ptr.hpp>
 #include <uhd/usrp/gps_ctrl.hpp>
 #include <uhd/usrp/mboard_eeprom.hpp>
@@ -181,6 +182,7 @@ private:
     {
         //Interfaces
         radio_ctrl_core_3000::sptr ctrl;
+        uhd::timed_wb_iface::sptr regs;
         spi_core_3000::sptr spi;
         x300_adc_ctrl::sptr adc;
         x300_dac_ctrl::sptr dac;
@@ -199,6 +201,12 @@ private:
     //overflow recovery impl
     void handle_overflow(radio_perifs_t &perif, boost::weak_ptr<uhd::rx_streamer> streamer);
 
+    struct frame_size_t
+    {
+        size_t recv_frame_size;
+        size_t send_frame_size;
+    };
+
     //vector of member objects per motherboard
     struct mboard_members_t
     {
@@ -213,6 +221,7 @@ private:
         uhd::device_addr_t send_args;
         uhd::device_addr_t recv_args;
         bool if_pkt_is_big_endian;
+        frame_size_t max_frame_sizes;
         uhd::niusrprio::niusrprio_session::sptr  rio_fpga_interface;
 
         //perifs in the zpu
@@ -256,6 +265,9 @@ private:
 
     boost::mutex _transport_setup_mutex;
 
+    //the motherboards are set up concurrently, this guards what they share
+    boost::mutex _mb_setup_mutex;
+
     void register_loopback_self_test(uhd::wb_iface::sptr iface);
 
     void radio_loopback(uhd::wb_iface::sptr iface, const bool on);
@@ -275,6 +287,12 @@ private:
       */
     void setup_radio(const size_t, const std::string &slot_name, const uhd::device_addr_t &dev_addr);
 
+    /*! Connect the corrections and LEDs to a dboard frontend
+     *
+     * With lazy dboards, this runs when the frontend is first used.
+     */
+    void connect_frontend(const size_t mb_i, const std::string &slot_name, const std::string &tx_rx, const std::string &fe_name);
+
     size_t _sid_framer;
     struct sid_config_t
     {
@@ -299,13 +317,6 @@ private:
         const uhd::device_addr_t& args,
         boost::uint32_t& sid);
 
-    struct frame_size_t
-    {
-        size_t recv_frame_size;
-        size_t send_frame_size;
-    };
-    frame_size_t _max_frame_sizes;
-
     /*!
      * Automatically determine the maximum frame size available by sending a UDP packet
      * to the device and see which packet sizes actually work. This way, we can take
@@ -18,6 +18,7 @@
 #include <uhd/utils/gain_group.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/types/dict.hpp>
+#include <uhd/types/hash_dict.hpp>
 #include <uhd/utils/algorithm.hpp>
 #include <uhd/exception.hpp>
 #include <boost/foreach.hpp>
@@ -179,7 +180,7 @@ private:
     }
 
     uhd::dict<size_t, std::vector<gain_fcns_t> > _registry;
-    uhd::dict<std::string, gain_fcns_t> _name_to_fcns;
+    uhd::hash_dict<std::string, gain_fcns_t> _name_to_fcns;
 };
 
 /***********************************************************************
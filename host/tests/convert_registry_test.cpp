@@ -0,0 +1,122 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+
+using namespace uhd;
+
+//! A converter that only tells which registration made it
+class tagged_converter : public convert::converter{
+public:
+    tagged_converter(const int tag): tag(tag){}
+    void set_scalar(const double){}
+    const int tag;
+private:
+    void operator()(const input_type &, const output_type &, const size_t){}
+};
+
+static convert::converter::sptr make_tagged(const int tag){
+    return convert::converter::sptr(new tagged_converter(tag));
+}
+
+static int get_tag(const convert::function_type &fcn){
+    return boost::dynamic_pointer_cast<tagged_converter>(fcn())->tag;
+}
+
+static convert::id_type make_id(const std::string &in, const std::string &out, const size_t num = 1){
+    convert::id_type id;
+    id.input_format = in;
+    id.num_inputs = num;
+    id.output_format = out;
+    id.num_outputs = num;
+    return id;
+}
+
+static size_t find_id(const std::vector<convert::id_type> &ids, const convert::id_type &id){
+    return std::find(ids.begin(), ids.end(), id) - ids.begin();
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_registry_lookup){
+    const convert::id_type id = make_id("reg_test_in", "reg_test_out");
+    convert::register_converter(id, boost::bind(&make_tagged, 1), 1);
+    convert::register_converter(id, boost::bind(&make_tagged, 3), 3);
+    convert::register_converter(id, boost::bind(&make_tagged, 2), 2);
+
+    //the default is the highest priority, any priority can be asked for
+    BOOST_CHECK_EQUAL(get_tag(convert::get_converter(id)), 3);
+    BOOST_CHECK_EQUAL(get_tag(convert::get_converter(id, 1)), 1);
+    BOOST_CHECK_EQUAL(get_tag(convert::get_converter(id, 2)), 2);
+    BOOST_CHECK_THROW(convert::get_converter(id, 4), uhd::key_error);
+
+    std::vector<convert::priority_type> prios = convert::get_converter_priorities(id);
+    BOOST_REQUIRE_EQUAL(prios.size(), 3);
+    BOOST_CHECK_EQUAL(prios[0], 1);
+    BOOST_CHECK_EQUAL(prios[2], 3);
+
+    //every part of the ID takes part in the lookup
+    BOOST_CHECK_THROW(convert::get_converter(make_id("reg_test_in", "reg_test_out", 2)), uhd::key_error);
+    BOOST_CHECK_THROW(convert::get_converter(make_id("reg_test_out", "reg_test_in")), uhd::key_error);
+    BOOST_CHECK_THROW(convert::get_converter(make_id("reg_test_in", "reg_test_unknown")), uhd::key_error);
+    BOOST_CHECK_THROW(convert::get_converter_priorities(make_id("reg_test_unknown", "reg_test_out")), uhd::key_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_registry_default){
+    const convert::id_type id = make_id("reg_default_in", "reg_default_out");
+    convert::register_converter(id, boost::bind(&make_tagged, 1), 1);
+    BOOST_CHECK_EQUAL(get_tag(convert::get_converter(id)), 1);
+
+    //a higher priority replaces the cached default
+    convert::register_converter(id, boost::bind(&make_tagged, 5), 5);
+    BOOST_CHECK_EQUAL(get_tag(convert::get_converter(id)), 5);
+
+    //registering a priority again replaces its function
+    convert::register_converter(id, boost::bind(&make_tagged, 6), 5);
+    BOOST_CHECK_EQUAL(get_tag(convert::get_converter(id)), 6);
+    BOOST_CHECK_EQUAL(get_tag(convert::get_converter(id, 5)), 6);
+
+    //an explicit -1 registration is the default, whatever else is registered
+    convert::register_converter(id, boost::bind(&make_tagged, -1), -1);
+    convert::register_converter(id, boost::bind(&make_tagged, 7), 7);
+    BOOST_CHECK_EQUAL(get_tag(convert::get_converter(id)), -1);
+    BOOST_CHECK_EQUAL(get_tag(convert::get_converter(id, 7)), 7);
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_registry_ids){
+    const size_t num_ids = convert::get_converter_ids().size();
+    const convert::id_type id0 = make_id("reg_order_b", "reg_order_a");
+    const convert::id_type id1 = make_id("reg_order_a", "reg_order_b");
+    const convert::id_type id2 = make_id("reg_order_a", "reg_order_b", 2);
+    convert::register_converter(id0, boost::bind(&make_tagged, 0), 0);
+    convert::register_converter(id1, boost::bind(&make_tagged, 1), 0);
+    convert::register_converter(id2, boost::bind(&make_tagged, 2), 0);
+    convert::register_converter(id0, boost::bind(&make_tagged, 3), 1); //not a new ID
+
+    //new IDs are listed once each, in registration order
+    const std::vector<convert::id_type> ids = convert::get_converter_ids();
+    BOOST_REQUIRE_EQUAL(ids.size(), num_ids + 3);
+    BOOST_CHECK_EQUAL(find_id(ids, id0), num_ids + 0);
+    BOOST_CHECK_EQUAL(find_id(ids, id1), num_ids + 1);
+    BOOST_CHECK_EQUAL(find_id(ids, id2), num_ids + 2);
+
+    //the built-in converters are registered before main()
+    BOOST_CHECK(num_ids > 0);
+    BOOST_CHECK(find_id(ids, make_id("sc16_item32_le", "fc32")) < num_ids);
+}
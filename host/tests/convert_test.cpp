@@ -16,10 +16,15 @@
 //
 
 #include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/utils/paths.hpp>
+#include <uhd/utils/byteswap.hpp>
 #include <boost/test/unit_test.hpp>
 #include <boost/foreach.hpp>
 #include <boost/cstdint.hpp>
 #include <boost/assign/list_of.hpp>
+#include <boost/math/special_functions/round.hpp>
+#include <algorithm>
 #include <complex>
 #include <vector>
 #include <cstdlib>
@@ -416,6 +421,125 @@ BOOST_AUTO_TEST_CASE(test_convert_types_sc16_and_sc8){
     }
 }
 
+/***********************************************************************
+ * Test sc4 conversions
+ **********************************************************************/
+BOOST_AUTO_TEST_CASE(test_convert_types_fc64_and_sc4){
+    convert::id_type id;
+    id.input_format = "fc64";
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+
+    //try various lengths to test edge cases
+    id.output_format = "sc4_item32_le";
+    for (size_t nsamps = 1; nsamps < 16; nsamps++){
+        test_convert_types_for_floats<fc64_t>(nsamps, id, 1./4096);
+    }
+
+    //try various lengths to test edge cases
+    id.output_format = "sc4_item32_be";
+    for (size_t nsamps = 1; nsamps < 16; nsamps++){
+        test_convert_types_for_floats<fc64_t>(nsamps, id, 1./4096);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_types_fc32_and_sc4){
+    convert::id_type id;
+    id.input_format = "fc32";
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+
+    //try various lengths to test edge cases, generic and best routines
+    id.output_format = "sc4_item32_le";
+    for (size_t nsamps = 1; nsamps < 40; nsamps++){
+        test_convert_types_for_floats<fc32_t>(nsamps, id, 1./4096);
+    }
+
+    //try various lengths to test edge cases, generic and best routines
+    id.output_format = "sc4_item32_be";
+    for (size_t nsamps = 1; nsamps < 40; nsamps++){
+        test_convert_types_for_floats<fc32_t>(nsamps, id, 1./4096);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_types_sc16_and_sc4){
+    convert::id_type id;
+    id.input_format = "sc16";
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+
+    //try various lengths to test edge cases
+    id.output_format = "sc4_item32_le";
+    for (size_t nsamps = 1; nsamps < 40; nsamps++){
+        test_convert_types_sc16(nsamps, id, 4096);
+    }
+
+    //try various lengths to test edge cases
+    id.output_format = "sc4_item32_be";
+    for (size_t nsamps = 1; nsamps < 40; nsamps++){
+        test_convert_types_sc16(nsamps, id, 4096);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_types_sc4_layout){
+    convert::id_type id;
+    id.input_format = "fc32";
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+
+    //first sample in the most significant byte, I in the upper nibble
+    std::vector<fc32_t> input = boost::assign::list_of
+        (fc32_t(1, -2))(fc32_t(3, -4))(fc32_t(7, -8))(fc32_t(0, 1));
+    input.resize(16, fc32_t(0, 0)); //long enough for the SIMD routines
+    std::vector<boost::uint32_t> output(input.size()/4);
+    std::vector<const void *> input0(1, &input[0]);
+    std::vector<void *> output0(1, &output[0]);
+
+    id.output_format = "sc4_item32_be";
+    convert::converter::sptr c_be = convert::get_converter(id)();
+    c_be->set_scalar(1.0);
+    c_be->conv(input0, output0, input.size());
+    BOOST_CHECK_EQUAL(output[0], uhd::htonx<boost::uint32_t>(0x1e3c7801));
+
+    id.output_format = "sc4_item32_le";
+    convert::converter::sptr c_le = convert::get_converter(id)();
+    c_le->set_scalar(1.0);
+    c_le->conv(input0, output0, input.size());
+    BOOST_CHECK_EQUAL(output[0], uhd::htowx<boost::uint32_t>(0x1e3c7801));
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_types_sc4_unaligned_input){
+    convert::id_type id;
+    id.output_format = "fc32";
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+
+    //the packet handlers resume inside of an item, one byte per sample
+    const std::vector<std::string> formats = boost::assign::list_of
+        ("sc4_item32_le")("sc4_item32_be");
+    BOOST_FOREACH(const std::string &format, formats){
+        id.input_format = format;
+        std::vector<boost::uint32_t> input(16);
+        BOOST_FOREACH(boost::uint32_t &in, input) in = boost::uint32_t(std::rand());
+        for (size_t offset = 0; offset < 4; offset++){
+            for (size_t nsamps = 1; nsamps + offset <= input.size()*4; nsamps += 7){
+                std::vector<fc32_t> expected(nsamps), output(nsamps);
+                std::vector<const void *> input0(1, reinterpret_cast<const char *>(&input[0]) + offset);
+                std::vector<void *> output0(1, &expected[0]), output1(1, &output[0]);
+
+                convert::converter::sptr c0 = convert::get_converter(id, 0)();
+                c0->set_scalar(1/8.);
+                c0->conv(input0, output0, nsamps);
+
+                convert::converter::sptr c1 = convert::get_converter(id)();
+                c1->set_scalar(1/8.);
+                c1->conv(input0, output1, nsamps);
+                BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), output.begin(), output.end());
+            }
+        }
+    }
+}
+
 /***********************************************************************
  * Test u8 conversion
  **********************************************************************/
@@ -610,3 +734,285 @@ BOOST_AUTO_TEST_CASE(test_convert_types_f32_and_f32){
         test_convert_types_f32(nsamps, id);
     }
 }
+
+/***********************************************************************
+ * Test the auto-tuned converter selection
+ **********************************************************************/
+BOOST_AUTO_TEST_CASE(test_convert_tuned_sc16_to_fc32){
+#ifndef UHD_PLATFORM_WIN32
+    //keep the stored selections out of the user's config directory
+    setenv("UHD_CONFIG_DIR", uhd::get_tmp_path().c_str(), 1);
+#endif
+
+    convert::id_type id;
+    id.input_format = "sc16_item32_le";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    const size_t nsamps = 363;
+    std::vector<boost::uint32_t> input(nsamps);
+    BOOST_FOREACH(boost::uint32_t &in, input) in = boost::uint32_t(std::rand());
+    std::vector<fc32_t> output(nsamps), expected(nsamps);
+
+    std::vector<const void *> input0(1, &input[0]);
+    std::vector<void *> output0(1, &output[0]), output1(1, &expected[0]);
+
+    convert::converter::sptr c0 = convert::get_converter(id, 0)();
+    c0->set_scalar(1/32767.);
+    c0->conv(input0, output1, nsamps);
+
+    //second call is served from the stored selection
+    for (size_t i = 0; i < 2; i++){
+        convert::converter::sptr c1 = convert::get_converter_tuned(id, nsamps)();
+        c1->set_scalar(1/32767.);
+        c1->conv(input0, output0, nsamps);
+        for (size_t j = 0; j < nsamps; j++){
+            MY_CHECK_CLOSE(expected[j], output[j], float(1./(1 << 14)));
+        }
+    }
+}
+
+/***********************************************************************
+ * Test the corrected short to float conversion
+ **********************************************************************/
+static void test_convert_corrected_sc16_to_fc32(
+    size_t nsamps, convert::id_type &id, const int prio
+){
+    const double scalar = 1/32767.;
+    const fc64_t gain(0.9, -0.3), dc_offset(0.01, -0.02), iq_balance(0.05, -0.1);
+
+    std::vector<boost::uint32_t> input(nsamps);
+    BOOST_FOREACH(boost::uint32_t &in, input) in = boost::uint32_t(std::rand());
+    std::vector<fc32_t> plain(nsamps), output(nsamps);
+
+    std::vector<const void *> input0(1, &input[0]);
+    std::vector<void *> output0(1, &plain[0]), output1(1, &output[0]);
+
+    //the uncorrected conversion is the reference
+    convert::id_type plain_id = id;
+    plain_id.output_format = "fc32";
+    convert::converter::sptr c0 = convert::get_converter(plain_id, 0)();
+    c0->set_scalar(scalar);
+    c0->conv(input0, output0, nsamps);
+
+    convert::id_type corr_id = id;
+    corr_id.output_format = "fc32_corr";
+    convert::converter::sptr c1 = convert::get_converter(corr_id, prio)();
+    c1->set_scalar(scalar);
+    c1->set_correction(gain, dc_offset, iq_balance);
+    c1->conv(input0, output1, nsamps);
+
+    for (size_t i = 0; i < nsamps; i++){
+        const fc64_t x = fc64_t(plain[i]) - dc_offset;
+        const fc64_t b(
+            (1 + iq_balance.real())*x.real(),
+            x.imag() + iq_balance.imag()*x.real()
+        );
+        MY_CHECK_CLOSE(fc32_t(gain*b), output[i], float(1./(1 << 12)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_types_corrected_sc16_to_fc32){
+    convert::id_type id;
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+
+    //try various lengths to test edge cases, generic and best routines
+    const std::vector<std::string> formats = boost::assign::list_of
+        ("sc16_item32_le")("sc16_item32_be");
+    BOOST_FOREACH(const std::string &format, formats){
+        id.input_format = format;
+        for (size_t nsamps = 1; nsamps < 16; nsamps++){
+            test_convert_corrected_sc16_to_fc32(nsamps, id, 0);
+            test_convert_corrected_sc16_to_fc32(nsamps, id, -1);
+        }
+        test_convert_corrected_sc16_to_fc32(363, id, -1);
+    }
+
+    //converters without correction support must say so
+    id.output_format = "fc32";
+    BOOST_CHECK_THROW(
+        convert::get_converter(id)()->set_correction(1.0, 0.0, 0.0),
+        uhd::not_implemented_error
+    );
+}
+
+/***********************************************************************
+ * Test that table converters sharing tables keep their own scaling
+ **********************************************************************/
+BOOST_AUTO_TEST_CASE(test_convert_shared_tables_sc16_to_fc32){
+    convert::id_type id;
+    id.input_format = "sc16_item32_le";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    const size_t nsamps = 100;
+    std::vector<boost::uint32_t> input(nsamps);
+    BOOST_FOREACH(boost::uint32_t &in, input) in = boost::uint32_t(std::rand());
+    std::vector<fc32_t> expected(nsamps), output(nsamps);
+    std::vector<const void *> input0(1, &input[0]);
+    std::vector<void *> output0(1, &expected[0]), output1(1, &output[0]);
+
+    //the table routine is priority 1
+    const double scalars[] = {1/32767., 2.0, 1/32767.};
+    std::vector<convert::converter::sptr> tables;
+    for (size_t i = 0; i < 3; i++){
+        tables.push_back(convert::get_converter(id, 1)());
+        tables.back()->set_scalar(scalars[i]);
+    }
+
+    for (size_t i = 0; i < 3; i++){
+        convert::converter::sptr generic = convert::get_converter(id, 0)();
+        generic->set_scalar(scalars[i]);
+        generic->conv(input0, output0, nsamps);
+        tables[i]->conv(input0, output1, nsamps);
+        for (size_t j = 0; j < nsamps; j++){
+            MY_CHECK_CLOSE(expected[j], output[j], float(1e-3));
+        }
+    }
+}
+
+/***********************************************************************
+ * Test the arithmetic sc16 to sc8 routines against the table
+ **********************************************************************/
+BOOST_AUTO_TEST_CASE(test_convert_types_sc16_to_sc8_vs_table){
+    convert::id_type id;
+    id.input_format = "sc16";
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+
+    const std::vector<std::string> formats = boost::assign::list_of
+        ("sc8_item32_le")("sc8_item32_be");
+    BOOST_FOREACH(const std::string &format, formats){
+        id.output_format = format;
+        for (size_t nsamps = 1; nsamps < 40; nsamps++){
+            //in range after scaling by 1/5 (no ties), on a non-16 byte boundary too
+            std::vector<sc16_t> input(nsamps + 1);
+            BOOST_FOREACH(sc16_t &in, input) in = sc16_t(
+                short(std::rand()%1201 - 600), short(std::rand()%1201 - 600)
+            );
+            std::vector<boost::uint32_t> expected((nsamps + 1)/2), output((nsamps + 1)/2);
+            std::vector<const void *> input0(1, &input[nsamps%2]);
+            std::vector<void *> output0(1, &expected[0]), output1(1, &output[0]);
+
+            convert::converter::sptr c0 = convert::get_converter(id, 1)();
+            c0->set_scalar(32767./5);
+            c0->conv(input0, output0, nsamps);
+
+            convert::converter::sptr c1 = convert::get_converter(id)();
+            c1->set_scalar(32767./5);
+            c1->conv(input0, output1, nsamps);
+            BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), output.begin(), output.end());
+        }
+    }
+}
+
+static int sc8_sat(const short in){
+    //scaled by 1/5, no ties
+    return std::max(-128, std::min(127, int(boost::math::iround(in/5.0))));
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_types_sc16_to_sc8_saturation){
+    convert::id_type id;
+    id.input_format = "sc16";
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+
+    const std::vector<std::string> formats = boost::assign::list_of
+        ("sc8_item32_le")("sc8_item32_be");
+    BOOST_FOREACH(const std::string &format, formats){
+        id.output_format = format;
+        for (size_t nsamps = 1; nsamps < 40; nsamps++){
+            //mostly out of range, so the SIMD body and the tail both saturate
+            std::vector<sc16_t> input(nsamps);
+            BOOST_FOREACH(sc16_t &in, input) in = sc16_t(
+                short(std::rand()%60001 - 30000), short(std::rand()%60001 - 30000)
+            );
+            std::vector<boost::uint32_t> output((nsamps + 1)/2);
+            std::vector<const void *> input0(1, &input[0]);
+            std::vector<void *> output0(1, &output[0]);
+
+            convert::converter::sptr c = convert::get_converter(id)();
+            c->set_scalar(32767./5);
+            c->conv(input0, output0, nsamps);
+
+            for (size_t i = 0; i < nsamps; i++){
+                const boost::uint32_t word = (format == "sc8_item32_be")?
+                    uhd::ntohx(output[i/2]) : uhd::wtohx(output[i/2]);
+                const int shift = (i%2)? 0 : 16;
+                BOOST_CHECK_EQUAL(int(boost::int8_t(word >> (shift + 8))), sc8_sat(input[i].real()));
+                BOOST_CHECK_EQUAL(int(boost::int8_t(word >> shift)), sc8_sat(input[i].imag()));
+            }
+        }
+    }
+}
+
+/***********************************************************************
+ * Test the non-temporal store routines against the regular ones
+ **********************************************************************/
+BOOST_AUTO_TEST_CASE(test_convert_types_sc16_to_fc32_nt){
+    convert::id_type id;
+    id.output_format = "fc32";
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+    convert::id_type nt_id = id;
+    nt_id.output_format = "fc32_nt";
+
+    const std::vector<std::string> formats = boost::assign::list_of
+        ("sc16_item32_le")("sc16_item32_be");
+    BOOST_FOREACH(const std::string &format, formats){
+        id.input_format = nt_id.input_format = format;
+        convert::converter::sptr c1;
+        try{
+            c1 = convert::get_converter(nt_id)();
+        }
+        catch(const uhd::key_error &){
+            std::cout << "No non-temporal converter for " << nt_id.to_pp_string() << std::endl;
+            continue;
+        }
+        c1->set_scalar(1/32767.);
+        convert::converter::sptr c0 = convert::get_converter(id)();
+        c0->set_scalar(1/32767.);
+
+        //various lengths, on 16 and 8 byte output boundaries
+        for (size_t nsamps = 1; nsamps < 40; nsamps++){
+            for (size_t offset = 0; offset < 2; offset++){
+                std::vector<boost::uint32_t> input(nsamps);
+                BOOST_FOREACH(boost::uint32_t &in, input) in = boost::uint32_t(std::rand());
+                std::vector<fc32_t> expected(nsamps + 1), output(nsamps + 1);
+                std::vector<const void *> input0(1, &input[0]);
+                std::vector<void *> output0(1, &expected[offset]), output1(1, &output[offset]);
+
+                c0->conv(input0, output0, nsamps);
+                c1->conv(input0, output1, nsamps);
+                BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), output.begin(), output.end());
+            }
+        }
+    }
+}
+
+/***********************************************************************
+ * Test the registry listing
+ **********************************************************************/
+BOOST_AUTO_TEST_CASE(test_convert_list_converters){
+    convert::id_type id;
+    id.input_format = "sc16_item32_le";
+    id.output_format = "fc32";
+    id.num_inputs = 1;
+    id.num_outputs = 1;
+
+    const std::vector<convert::id_type> ids = convert::get_converter_ids();
+    BOOST_CHECK(std::find(ids.begin(), ids.end(), id) != ids.end());
+
+    const std::vector<convert::priority_type> prios = convert::get_converter_priorities(id);
+    BOOST_REQUIRE(not prios.empty());
+    BOOST_CHECK(std::find(prios.begin(), prios.end(), 0) != prios.end());
+    for (size_t i = 1; i < prios.size(); i++){
+        BOOST_CHECK(prios[i-1] < prios[i]);
+    }
+
+    id.output_format = "does_not_exist";
+    BOOST_CHECK_THROW(convert::get_converter_priorities(id), uhd::key_error);
+}
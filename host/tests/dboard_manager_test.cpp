@@ -0,0 +1,130 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/usrp/dboard_manager.hpp>
+#include <uhd/usrp/dboard_base.hpp>
+#include <uhd/usrp/dboard_iface.hpp>
+#include <uhd/property_tree.hpp>
+#include <uhd/utils/static.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+
+using namespace uhd;
+using namespace uhd::usrp;
+
+/***********************************************************************
+ * A dboard interface that does nothing
+ **********************************************************************/
+class fake_dboard_iface : public dboard_iface{
+public:
+    special_props_t get_special_props(void){
+        special_props_t props;
+        props.soft_clock_divider = false;
+        props.mangle_i2c_addrs = false;
+        return props;
+    }
+    void write_aux_dac(unit_t, aux_dac_t, double){}
+    double read_aux_adc(unit_t, aux_adc_t){return 0.0;}
+    void set_pin_ctrl(unit_t, boost::uint32_t, boost::uint32_t){}
+    boost::uint32_t get_pin_ctrl(unit_t){return 0;}
+    void set_atr_reg(unit_t, atr_reg_t, boost::uint32_t, boost::uint32_t){}
+    boost::uint32_t get_atr_reg(unit_t, atr_reg_t){return 0;}
+    void set_gpio_ddr(unit_t, boost::uint32_t, boost::uint32_t){}
+    boost::uint32_t get_gpio_ddr(unit_t){return 0;}
+    void set_gpio_out(unit_t, boost::uint32_t, boost::uint32_t){}
+    boost::uint32_t get_gpio_out(unit_t){return 0;}
+    boost::uint32_t read_gpio(unit_t){return 0;}
+    void write_spi(unit_t, const spi_config_t &, boost::uint32_t, size_t){}
+    boost::uint32_t read_write_spi(unit_t, const spi_config_t &, boost::uint32_t, size_t){return 0;}
+    void set_clock_rate(unit_t, double){}
+    double get_clock_rate(unit_t){return 0.0;}
+    std::vector<double> get_clock_rates(unit_t){return std::vector<double>();}
+    void set_clock_enabled(unit_t, bool){}
+    double get_codec_rate(unit_t){return 0.0;}
+    time_spec_t get_command_time(void){return time_spec_t(0.0);}
+    void set_command_time(const time_spec_t &){}
+    void write_i2c(boost::uint16_t, const byte_vector_t &){}
+    byte_vector_t read_i2c(boost::uint16_t, size_t){return byte_vector_t();}
+};
+
+/***********************************************************************
+ * A transceiver whose constructor fills and uses both frontends
+ **********************************************************************/
+static size_t num_xcvr_ctors = 0;
+
+class fake_xcvr : public xcvr_dboard_base{
+public:
+    fake_xcvr(ctor_args_t args): xcvr_dboard_base(args){
+        num_xcvr_ctors++;
+        get_rx_subtree()->create<double>("freq/value").set(1e9);
+        get_tx_subtree()->create<double>("freq/value");
+        get_tx_subtree()->access<double>("freq/value").set(2e9);
+    }
+};
+
+static dboard_base::sptr make_fake_xcvr(dboard_base::ctor_args_t args){
+    return dboard_base::sptr(new fake_xcvr(args));
+}
+
+static const dboard_id_t FAKE_XCVR_RX_ID(0xfe00);
+static const dboard_id_t FAKE_XCVR_TX_ID(0xfe01);
+
+UHD_STATIC_BLOCK(reg_fake_xcvr_dboard){
+    dboard_manager::register_dboard(FAKE_XCVR_RX_ID, FAKE_XCVR_TX_ID, &make_fake_xcvr, "Fake XCVR");
+}
+
+static void connect_tx(property_tree::sptr tree, double *freq){
+    *freq = tree->access<double>("/db/tx_frontends/0/freq/value").get();
+}
+
+/***********************************************************************
+ * Tests
+ **********************************************************************/
+BOOST_AUTO_TEST_CASE(test_dboard_manager_xcvr){
+    property_tree::sptr tree = property_tree::make();
+    num_xcvr_ctors = 0;
+    dboard_manager::sptr db = dboard_manager::make(
+        FAKE_XCVR_RX_ID, FAKE_XCVR_TX_ID, dboard_id_t::none(),
+        dboard_iface::sptr(new fake_dboard_iface()), tree->subtree("/db"));
+    BOOST_CHECK_EQUAL(num_xcvr_ctors, 1);
+    BOOST_CHECK_EQUAL(tree->access<double>("/db/tx_frontends/0/freq/value").get(), 2e9);
+}
+
+BOOST_AUTO_TEST_CASE(test_dboard_manager_xcvr_deferred){
+    property_tree::sptr tree = property_tree::make();
+    num_xcvr_ctors = 0;
+    dboard_manager::sptr db = dboard_manager::make(
+        FAKE_XCVR_RX_ID, FAKE_XCVR_TX_ID, dboard_id_t::none(),
+        dboard_iface::sptr(new fake_dboard_iface()), tree->subtree("/db"), true);
+    BOOST_CHECK_EQUAL(num_xcvr_ctors, 0);
+    BOOST_CHECK_EQUAL(tree->list("/db/rx_frontends").size(), 1);
+    BOOST_CHECK_EQUAL(tree->list("/db/tx_frontends").size(), 1);
+
+    //like the motherboard hookups, run after the subdev was made
+    double connected_freq = 0.0;
+    tree->create_lazy("/db/tx_frontends/0", boost::bind(&connect_tx, tree, &connected_freq));
+
+    //the rx frontend makes the subdev once, the ctor fills the tx frontend too
+    BOOST_CHECK_EQUAL(tree->access<double>("/db/rx_frontends/0/freq/value").get(), 1e9);
+    BOOST_CHECK_EQUAL(num_xcvr_ctors, 1);
+    BOOST_CHECK_EQUAL(connected_freq, 0.0);
+
+    //the tx frontend only runs its own hookup
+    BOOST_CHECK_EQUAL(tree->access<double>("/db/tx_frontends/0/freq/value").get(), 2e9);
+    BOOST_CHECK_EQUAL(num_xcvr_ctors, 1);
+    BOOST_CHECK_EQUAL(connected_freq, 2e9);
+}
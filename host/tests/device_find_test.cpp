@@ -0,0 +1,201 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/device.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/property_tree.hpp>
+#include <uhd/utils/paths.hpp>
+#include <uhd/utils/static.hpp>
+#include <uhd/utils/atomic.hpp>
+#include <uhd/version.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+using namespace uhd;
+
+/***********************************************************************
+ * Two fake device types that answer to type=find_test,
+ * and a slow one that also needs a slow=<seconds> key
+ **********************************************************************/
+static boost::mutex hints_mutex;
+static device_addrs_t b_hints;
+static atomic_uint32_t slow_running;
+
+static device_addrs_t find_test_addrs(const device_addr_t &hint, const std::string &serial, const std::string &addr){
+    device_addrs_t addrs;
+    if (hint.get("type", "") != "find_test") return addrs;
+    if (hint.has_key("serial") and hint["serial"] != serial) return addrs;
+    if (hint.has_key("addr") and hint["addr"] != addr) return addrs;
+    device_addr_t found;
+    found["type"] = "find_test";
+    found["serial"] = serial;
+    found["addr"] = addr;
+    addrs.push_back(found);
+    return addrs;
+}
+
+static device_addrs_t find_a(const device_addr_t &hint){
+    return find_test_addrs(hint, "a1", "10.0.0.1");
+}
+
+static device_addrs_t find_b(const device_addr_t &hint){
+    {
+        boost::mutex::scoped_lock lock(hints_mutex);
+        if (hint.get("type", "") == "find_test") b_hints.push_back(hint);
+    }
+    return find_test_addrs(hint, "b1", "10.0.0.2");
+}
+
+static device_addrs_t find_slow(const device_addr_t &hint){
+    if (not hint.has_key("slow")) return device_addrs_t();
+    slow_running.write(1);
+    try{
+        //like a find function without interruption points, e.g. a blocking socket read
+        boost::scoped_ptr<boost::this_thread::disable_interruption> no_interrupt;
+        if (hint.has_key("no_interrupt")) no_interrupt.reset(new boost::this_thread::disable_interruption());
+        boost::this_thread::sleep(boost::posix_time::milliseconds(long(hint.cast<double>("slow", 0.0)*1e3)));
+    }
+    catch(...){
+        slow_running.write(0);
+        throw;
+    }
+    slow_running.write(0);
+    return find_test_addrs(hint, "s1", "10.0.0.3");
+}
+
+class find_test_device : public device{
+public:
+    find_test_device(void){
+        _type = device::USRP;
+        _tree = property_tree::make();
+    }
+
+    rx_streamer::sptr get_rx_stream(const stream_args_t &){
+        throw uhd::not_implemented_error("find_test_device has no streamers");
+    }
+
+    tx_streamer::sptr get_tx_stream(const stream_args_t &){
+        throw uhd::not_implemented_error("find_test_device has no streamers");
+    }
+
+    bool recv_async_msg(async_metadata_t &, double){
+        return false;
+    }
+};
+
+static device::sptr find_test_make(const device_addr_t &){
+    return device::sptr(new find_test_device());
+}
+
+UHD_STATIC_BLOCK(register_find_test_devices){
+    device::register_device(&find_a, &find_test_make, device::USRP);
+    device::register_device(&find_b, &find_test_make, device::USRP);
+    device::register_device(&find_slow, &find_test_make, device::USRP);
+}
+
+static bool has_serial(const device_addrs_t &addrs, const std::string &serial){
+    for (size_t i = 0; i < addrs.size(); i++){
+        if (addrs[i]["serial"] == serial) return true;
+    }
+    return false;
+}
+
+//late find functions are detached, wait until they are done
+static bool wait_for_slow_find(const double timeout){
+    const boost::system_time deadline = boost::get_system_time()
+        + boost::posix_time::microseconds(long(timeout*1e6));
+    while (slow_running.read() != 0){
+        if (boost::get_system_time() > deadline) return false;
+        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    }
+    return true;
+}
+
+/***********************************************************************
+ * Tests
+ **********************************************************************/
+BOOST_AUTO_TEST_CASE(test_device_find_merge){
+    const device_addrs_t addrs = device::find(device_addr_t("type=find_test"));
+    BOOST_CHECK_EQUAL(addrs.size(), 2);
+    BOOST_CHECK(has_serial(addrs, "a1"));
+    BOOST_CHECK(has_serial(addrs, "b1"));
+
+    BOOST_CHECK_EQUAL(device::find(device_addr_t("type=find_test,serial=b1")).size(), 1);
+    BOOST_CHECK(device::find(device_addr_t("type=find_test"), device::CLOCK).empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_device_find_deadline){
+    //without a timeout, slow device types are waited for
+    device_addrs_t addrs = device::find(device_addr_t("type=find_test,slow=0.2"));
+    BOOST_CHECK_EQUAL(addrs.size(), 3);
+    BOOST_CHECK(has_serial(addrs, "s1"));
+
+    //with a timeout, they are interrupted and left behind
+    boost::system_time start = boost::get_system_time();
+    addrs = device::find(device_addr_t("type=find_test,slow=30,find_timeout=0.2"));
+    BOOST_CHECK((boost::get_system_time() - start).total_seconds() < 10);
+    BOOST_CHECK_EQUAL(addrs.size(), 2);
+    BOOST_CHECK(not has_serial(addrs, "s1"));
+    BOOST_CHECK(wait_for_slow_find(10.0));
+
+    //the deadline also holds when a find function can't be interrupted
+    start = boost::get_system_time();
+    addrs = device::find(device_addr_t("type=find_test,slow=3,no_interrupt,find_timeout=0.2"));
+    BOOST_CHECK((boost::get_system_time() - start).total_milliseconds() < 2000);
+    BOOST_CHECK_EQUAL(addrs.size(), 2);
+    BOOST_CHECK(not has_serial(addrs, "s1"));
+    BOOST_CHECK(wait_for_slow_find(10.0));
+}
+
+BOOST_AUTO_TEST_CASE(test_device_find_cache){
+    const boost::filesystem::path config_dir = boost::filesystem::path(uhd::get_tmp_path())
+        / ("device_find_test_" + boost::filesystem::unique_path().string());
+    boost::filesystem::create_directories(config_dir);
+    setenv("UHD_CONFIG_DIR", config_dir.string().c_str(), 1);
+
+    //the first make stores the address the device was found at
+    BOOST_CHECK(device::make(device_addr_t("type=find_test,serial=b1,discovery_cache=1")));
+    std::ifstream cache_file((config_dir / ".uhd" / "discovery_cache.csv").string().c_str());
+    std::string row;
+    BOOST_REQUIRE(std::getline(cache_file, row));
+    BOOST_CHECK(row.find("b1,") != std::string::npos);
+    BOOST_CHECK(row.find("addr=10.0.0.2") != std::string::npos);
+
+    //the next make looks there first
+    b_hints.clear();
+    BOOST_CHECK(device::make(device_addr_t("type=find_test,serial=b1,discovery_cache=1")));
+    BOOST_REQUIRE_EQUAL(b_hints.size(), 1);
+    BOOST_CHECK_EQUAL(b_hints[0].get("addr", ""), "10.0.0.2");
+
+    //a stale address falls back to a full search
+    std::ofstream stale_file((config_dir / ".uhd" / "discovery_cache.csv").string().c_str(), std::ios::app);
+    stale_file << uhd::get_version_string() << ",b1,type=find_test,serial=b1,addr=10.0.0.9" << std::endl;
+    stale_file.close();
+    b_hints.clear();
+    BOOST_CHECK(device::make(device_addr_t("type=find_test,serial=b1,discovery_cache=1")));
+    BOOST_REQUIRE_EQUAL(b_hints.size(), 2);
+    BOOST_CHECK_EQUAL(b_hints[0].get("addr", ""), "10.0.0.9");
+    BOOST_CHECK(not b_hints[1].has_key("addr"));
+
+    boost::filesystem::remove_all(config_dir);
+}
@@ -254,3 +254,119 @@ BOOST_AUTO_TEST_CASE(test_experts){
     container->resolve_to("Consume_G");
     VALIDATE_ALL_DEPENDENCIES
 }
+
+//=============================================================================
+
+class worker_negate_t : public worker_node_t {
+public:
+    worker_negate_t(const node_retriever_t& db, const std::string& in, const std::string& out)
+    : worker_node_t(in + "->" + out), _in(db, in), _out(db, out)
+    {
+        bind_accessor(_in);
+        bind_accessor(_out);
+    }
+
+private:
+    void resolve() {
+        if (_in.get() < 0) throw uhd::value_error("negative input for " + get_name());
+        _out.set(-_in.get());
+    }
+
+    data_reader_t<int> _in;
+    data_writer_t<int> _out;
+};
+
+BOOST_AUTO_TEST_CASE(test_experts_parallel){
+    expert_container::sptr container = expert_factory::create_container("example_parallel");
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    BOOST_CHECK_THROW(container->set_resolve_threads(0), uhd::value_error);
+    container->set_resolve_threads(3);
+
+    boost::shared_ptr<int> final_output = boost::make_shared<int>();
+
+    expert_factory::add_dual_prop_node<int>(container, tree, "A", 0, uhd::experts::AUTO_RESOLVE_ON_WRITE);
+    expert_factory::add_prop_node<int>(container, tree, "B", 0);
+    expert_factory::add_data_node<int>(container, "C", 0);
+    expert_factory::add_data_node<int>(container, "D", 1);
+    expert_factory::add_prop_node<int>(container, tree, "E", 0, uhd::experts::AUTO_RESOLVE_ON_READ);
+    expert_factory::add_data_node<int>(container, "F", 0);
+    expert_factory::add_data_node<int>(container, "G", 0);
+
+    expert_factory::add_worker_node<worker1_t>(container, container->node_retriever());
+    expert_factory::add_worker_node<worker2_t>(container, container->node_retriever());
+    expert_factory::add_worker_node<worker3_t>(container, container->node_retriever());
+    expert_factory::add_worker_node<worker4_t>(container, container->node_retriever());
+    expert_factory::add_worker_node<worker5_t>(container, container->node_retriever(), final_output);
+    expert_factory::add_worker_node<worker6_t>(container);
+
+    data_node_t<int>& nodeA = *(const_cast< data_node_t<int>* >(dynamic_cast< const data_node_t<int>* >(&container->node_retriever().lookup("A/desired"))));
+    data_node_t<int>& nodeB = *(const_cast< data_node_t<int>* >(dynamic_cast< const data_node_t<int>* >(&container->node_retriever().lookup("B"))));
+    data_node_t<int>& nodeC = *(const_cast< data_node_t<int>* >(dynamic_cast< const data_node_t<int>* >(&container->node_retriever().lookup("C"))));
+    data_node_t<int>& nodeD = *(const_cast< data_node_t<int>* >(dynamic_cast< const data_node_t<int>* >(&container->node_retriever().lookup("D"))));
+    data_node_t<int>& nodeE = *(const_cast< data_node_t<int>* >(dynamic_cast< const data_node_t<int>* >(&container->node_retriever().lookup("E"))));
+    data_node_t<int>& nodeF = *(const_cast< data_node_t<int>* >(dynamic_cast< const data_node_t<int>* >(&container->node_retriever().lookup("F"))));
+    data_node_t<int>& nodeG = *(const_cast< data_node_t<int>* >(dynamic_cast< const data_node_t<int>* >(&container->node_retriever().lookup("G"))));
+
+    //Same sequence as the serial test, resolved level by level
+    container->resolve_all();
+    VALIDATE_ALL_DEPENDENCIES
+
+    tree->access<int>("B").set(3);
+    BOOST_CHECK(nodeB.is_dirty());
+    container->resolve_all();
+    VALIDATE_ALL_DEPENDENCIES
+
+    nodeD.set(2);
+    tree->access<int>("A").set(200);
+    BOOST_CHECK(nodeG.get() == nodeE.get() - nodeF.get());
+    container->resolve_all();
+    VALIDATE_ALL_DEPENDENCIES
+
+    tree->access<int>("A").set(-1);
+    container->resolve_to("C");
+    BOOST_CHECK(nodeC.get() == nodeA.get() + nodeB.get());
+    BOOST_CHECK(!nodeC.is_dirty());
+    container->resolve_to("Consume_G");
+    VALIDATE_ALL_DEPENDENCIES
+
+    //Only dirty workers are resolved and timed
+    worker_stats_map_t stats = container->get_worker_stats();
+    BOOST_CHECK_EQUAL(stats.size(), 6);
+    BOOST_CHECK(stats["A+B=C"].resolve_count > 0);
+    BOOST_CHECK_EQUAL(stats["null_worker"].resolve_count, 0);
+    const size_t count = stats["-B=F"].resolve_count;
+    tree->access<int>("A").set(5);
+    stats = container->get_worker_stats();
+    BOOST_CHECK_EQUAL(stats["-B=F"].resolve_count, count);
+    BOOST_CHECK(stats["A+B=C"].total_time >= stats["A+B=C"].max_time);
+    BOOST_CHECK(container->to_dot().find("avg") != std::string::npos);
+
+    container->reset_worker_stats();
+    stats = container->get_worker_stats();
+    BOOST_CHECK_EQUAL(stats["A+B=C"].resolve_count, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_experts_parallel_error){
+    expert_container::sptr container = expert_factory::create_container("example_error");
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    container->set_resolve_threads(2);
+
+    expert_factory::add_prop_node<int>(container, tree, "X", 0);
+    expert_factory::add_prop_node<int>(container, tree, "Y", 0);
+    expert_factory::add_data_node<int>(container, "P", 0);
+    expert_factory::add_data_node<int>(container, "Q", 0);
+    expert_factory::add_worker_node<worker_negate_t>(container, container->node_retriever(), "X", "P");
+    expert_factory::add_worker_node<worker_negate_t>(container, container->node_retriever(), "Y", "Q");
+
+    tree->access<int>("X").set(1);
+    tree->access<int>("Y").set(2);
+    container->resolve_all();
+    const data_node_t<int>& nodeP = dynamic_cast<const data_node_t<int>&>(container->node_retriever().lookup("P"));
+    const data_node_t<int>& nodeQ = dynamic_cast<const data_node_t<int>&>(container->node_retriever().lookup("Q"));
+    BOOST_CHECK_EQUAL(nodeP.get(), -1);
+    BOOST_CHECK_EQUAL(nodeQ.get(), -2);
+
+    //An error from a concurrent worker is rethrown with its type intact
+    tree->access<int>("Y").set(-2);
+    BOOST_CHECK_THROW(container->resolve_all(), uhd::value_error);
+}
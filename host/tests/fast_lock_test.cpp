@@ -0,0 +1,270 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include "../lib/usrp/common/ad9361_driver/ad9361_device.h"
+#include "../lib/usrp/cores/radio_ctrl_core_3000.hpp"
+#include <uhd/exception.hpp>
+#include <uhd/transport/vrt_if_packet.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/bind.hpp>
+#include <boost/assign/list_of.hpp>
+#include <algorithm>
+#include <queue>
+#include <map>
+#include <vector>
+
+using namespace uhd;
+using namespace uhd::usrp;
+using namespace uhd::transport;
+
+/***********************************************************************
+ * An AD9361 whose registers read back what was written,
+ * with all calibrations done and all synthesizers locked
+ **********************************************************************/
+class fake_ad9361_io : public ad9361_io{
+public:
+    fake_ad9361_io(void){
+        _status[0x005e] = 0x80; //BBPLL locked
+        _status[0x0017] = 0x05; //ENSM in ALERT
+        _status[0x0016] = 0x00; //no calibration running
+        _status[0x0244] = 0x80; //RX charge pump calibrated
+        _status[0x0284] = 0x80; //TX charge pump calibrated
+        _status[0x0247] = 0x02; //RX synthesizer locked
+        _status[0x0287] = 0x02; //TX synthesizer locked
+        _status[0x000c] = 0x02; //temperature measured
+    }
+
+    boost::uint8_t peek8(boost::uint32_t reg){
+        if (_status.count(reg)) return _status[reg];
+        return _regs[reg];
+    }
+
+    void poke8(boost::uint32_t reg, boost::uint8_t val){
+        _regs[reg] = val;
+        pokes.push_back(reg);
+    }
+
+    std::vector<boost::uint32_t> pokes;
+
+private:
+    std::map<boost::uint32_t, boost::uint8_t> _status;
+    std::map<boost::uint32_t, boost::uint8_t> _regs;
+};
+
+class fake_ad9361_client : public ad9361_params{
+public:
+    double get_band_edge(frequency_band_t band){
+        return (band == AD9361_RX_BAND1)? 4.0e9 : (band == AD9361_RX_BAND0)? 2.2e9 : 2.5e9;
+    }
+    clocking_mode_t get_clocking_mode(){
+        return AD9361_XTAL_N_CLK_PATH;
+    }
+    digital_interface_mode_t get_digital_interface_mode(){
+        return AD9361_DDR_FDD_LVCMOS;
+    }
+    digital_interface_delays_t get_digital_interface_timing(){
+        digital_interface_delays_t delays = {0, 0xF, 0, 0xF};
+        return delays;
+    }
+};
+
+static bool is_gain_table_reg(const boost::uint32_t reg){
+    return reg >= 0x130 and reg <= 0x137;
+}
+
+BOOST_AUTO_TEST_CASE(test_ad9361_fast_lock_recall){
+    boost::shared_ptr<fake_ad9361_io> io = boost::make_shared<fake_ad9361_io>();
+    ad9361_device_t device(boost::make_shared<fake_ad9361_client>(), io);
+    device.initialize();
+    device.tune(ad9361_device_t::RX, 1e9);
+
+    //storing tunes to the profile and back
+    const double freq = device.store_fast_lock_profile(ad9361_device_t::RX, 3, 2.4e9);
+    BOOST_CHECK_CLOSE(freq, 2.4e9, 1e-3);
+    BOOST_CHECK_CLOSE(device.get_freq(ad9361_device_t::RX), 1e9, 1e-3);
+    BOOST_CHECK_THROW(device.store_fast_lock_profile(ad9361_device_t::RX, 8, 2.4e9), uhd::value_error);
+    BOOST_CHECK_THROW(device.recall_fast_lock_profile(ad9361_device_t::RX, 2), uhd::value_error);
+    BOOST_CHECK_THROW(device.recall_fast_lock_profile(ad9361_device_t::TX, 3), uhd::value_error);
+
+    //a recall into another gain table band only selects the profile
+    io->pokes.clear();
+    BOOST_CHECK_CLOSE(device.recall_fast_lock_profile(ad9361_device_t::RX, 3), freq, 1e-9);
+    BOOST_CHECK_CLOSE(device.get_freq(ad9361_device_t::RX), freq, 1e-9);
+    BOOST_CHECK_EQUAL(io->pokes.size(), 3);
+    for (size_t i = 0; i < io->pokes.size(); i++){
+        BOOST_CHECK(not is_gain_table_reg(io->pokes[i]));
+    }
+
+    //the next regular tune leaves fast lock and switches the gain table
+    io->pokes.clear();
+    device.tune(ad9361_device_t::RX, 2.41e9);
+    BOOST_CHECK(std::find_if(io->pokes.begin(), io->pokes.end(), &is_gain_table_reg) != io->pokes.end());
+}
+
+/***********************************************************************
+ * A control transport that acks every packet right away
+ * and remembers the command time of every write.
+ * A readback of word N reads back N+1.
+ **********************************************************************/
+class loopback_ctrl_xport : public zero_copy_if{
+public:
+    struct write_type{
+        bool timed;
+        boost::uint64_t ticks;
+        boost::uint32_t data;
+    };
+
+    loopback_ctrl_xport(void): _send_buff(this){}
+
+    managed_send_buffer::sptr get_send_buff(double){
+        return _send_buff.make(&_send_buff, _send_mem, sizeof(_send_mem));
+    }
+
+    managed_recv_buffer::sptr get_recv_buff(double timeout){
+        boost::mutex::scoped_lock lock(_mutex);
+        if (_resps.empty()) _cond.timed_wait(lock, boost::posix_time::microseconds(long(timeout*1e6)));
+        if (_resps.empty()) return managed_recv_buffer::sptr();
+        std::copy(_resps.front().begin(), _resps.front().end(), _recv_mem);
+        _resps.pop();
+        return _recv_buff.make(&_recv_buff, _recv_mem, sizeof(_recv_mem));
+    }
+
+    size_t get_num_recv_frames(void) const{return 4;}
+    size_t get_recv_frame_size(void) const{return sizeof(_recv_mem);}
+    size_t get_num_send_frames(void) const{return 1;}
+    size_t get_send_frame_size(void) const{return sizeof(_send_mem);}
+
+    std::vector<write_type> get_writes(void){
+        boost::mutex::scoped_lock lock(_mutex);
+        return _writes;
+    }
+
+private:
+    struct send_buff_type : managed_send_buffer{
+        send_buff_type(loopback_ctrl_xport *xport): xport(xport){}
+        void release(void){xport->handle_send(cast<const boost::uint32_t *>(), size());}
+        loopback_ctrl_xport *xport;
+    };
+
+    struct recv_buff_type : managed_recv_buffer{
+        void release(void){}
+    };
+
+    void handle_send(const boost::uint32_t *pkt, const size_t size){
+        vrt::if_packet_info_t info;
+        info.link_type = vrt::if_packet_info_t::LINK_TYPE_CHDR;
+        info.num_packet_words32 = size/sizeof(boost::uint32_t);
+        vrt::if_hdr_unpack_le(pkt, info);
+        write_type write;
+        write.timed = info.has_tsf;
+        write.ticks = info.tsf;
+        write.data = uhd::wtohx(pkt[info.num_header_words32+1]);
+
+        //the response has the same sequence number and the reversed SID
+        vrt::if_packet_info_t resp_info = info;
+        resp_info.sid = (info.sid >> 16) | (info.sid << 16);
+        resp_info.has_tsf = false;
+        std::vector<boost::uint32_t> resp(8, 0);
+        vrt::if_hdr_pack_le(&resp.front(), resp_info);
+        resp[resp_info.num_header_words32+1] = uhd::htowx(write.data + 1); //readback value
+
+        boost::mutex::scoped_lock lock(_mutex);
+        _writes.push_back(write);
+        _resps.push(resp);
+        _cond.notify_one();
+    }
+
+    send_buff_type _send_buff;
+    recv_buff_type _recv_buff;
+    boost::uint32_t _send_mem[8];
+    boost::uint32_t _recv_mem[8];
+    boost::mutex _mutex;
+    boost::condition_variable _cond;
+    std::vector<write_type> _writes;
+    std::queue<std::vector<boost::uint32_t> > _resps;
+};
+
+static void poke_untimed(radio_ctrl_core_3000::sptr ctrl){
+    BOOST_CHECK(ctrl->get_time() == time_spec_t(0.0));
+    ctrl->poke32(0, 2);
+}
+
+static void poke_held(radio_ctrl_core_3000::sptr ctrl){
+    ctrl->hold_time(time_spec_t(2.0));
+    ctrl->poke32(0, 3);
+    ctrl->release_time();
+}
+
+BOOST_AUTO_TEST_CASE(test_radio_ctrl_hold_time){
+    boost::shared_ptr<loopback_ctrl_xport> xport = boost::make_shared<loopback_ctrl_xport>();
+    radio_ctrl_core_3000::sptr ctrl = radio_ctrl_core_3000::make(false, xport, xport, 0x00010002);
+    ctrl->set_tick_rate(100e6);
+
+    //the held time is only used by the holding thread
+    ctrl->hold_time(time_spec_t(1.0));
+    BOOST_CHECK(ctrl->get_time() == time_spec_t(1.0));
+    ctrl->poke32(0, 1);
+    boost::thread(boost::bind(&poke_untimed, ctrl)).join();
+
+    //another thread waits for its turn to hold a time
+    boost::thread holder(boost::bind(&poke_held, ctrl));
+    BOOST_CHECK(not holder.timed_join(boost::posix_time::milliseconds(50)));
+    ctrl->release_time();
+    holder.join();
+    ctrl->poke32(0, 4);
+
+    const std::vector<loopback_ctrl_xport::write_type> writes = xport->get_writes();
+    BOOST_REQUIRE_EQUAL(writes.size(), 4);
+    BOOST_CHECK_EQUAL(writes[0].data, 1);
+    BOOST_CHECK(writes[0].timed);
+    BOOST_CHECK_EQUAL(writes[0].ticks, 100000000);
+    BOOST_CHECK_EQUAL(writes[1].data, 2);
+    BOOST_CHECK(not writes[1].timed);
+    BOOST_CHECK_EQUAL(writes[2].data, 3);
+    BOOST_CHECK(writes[2].timed);
+    BOOST_CHECK_EQUAL(writes[2].ticks, 200000000);
+    BOOST_CHECK_EQUAL(writes[3].data, 4);
+    BOOST_CHECK(not writes[3].timed);
+}
+
+BOOST_AUTO_TEST_CASE(test_radio_ctrl_pipelined_peeks){
+    boost::shared_ptr<loopback_ctrl_xport> xport = boost::make_shared<loopback_ctrl_xport>();
+    radio_ctrl_core_3000::sptr ctrl = radio_ctrl_core_3000::make(false, xport, xport, 0x00010002);
+
+    //the readbacks are all sent before the first response is used
+    radio_ctrl_future<boost::uint32_t> peek0 = ctrl->peek32_async(0);
+    radio_ctrl_future<boost::uint64_t> peek1 = ctrl->peek64_async(8);
+    ctrl->poke32(4, 7);
+    radio_ctrl_future<boost::uint32_t> peek2 = ctrl->peek32_async(16);
+    BOOST_CHECK_EQUAL(xport->get_writes().size(), 4);
+    BOOST_CHECK_EQUAL(peek2.get(), 3);
+    BOOST_CHECK_EQUAL(peek1.get(), 2);
+    BOOST_CHECK_EQUAL(peek0.get(), 1);
+    BOOST_CHECK(not radio_ctrl_future<boost::uint32_t>().valid());
+
+    const std::vector<wb_iface::wb_addr_type> addrs = boost::assign::list_of(24)(28)(32);
+    const std::vector<boost::uint32_t> data = ctrl->peek32_batch(addrs);
+    BOOST_REQUIRE_EQUAL(data.size(), 3);
+    BOOST_CHECK_EQUAL(data[0], 4);
+    BOOST_CHECK_EQUAL(data[1], 0); //the upper half of word 3
+    BOOST_CHECK_EQUAL(data[2], 5);
+    BOOST_CHECK_EQUAL(ctrl->peek32(40), 6);
+}
@@ -0,0 +1,251 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/device.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/property_tree.hpp>
+#include <uhd/types/ranges.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/usrp/multi_usrp.hpp>
+#include <uhd/usrp/subdev_spec.hpp>
+#include <uhd/utils/static.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/assign/list_of.hpp>
+#include <boost/bind.hpp>
+#include <boost/math/special_functions/round.hpp>
+#include <vector>
+
+using namespace uhd;
+using namespace uhd::usrp;
+
+/***********************************************************************
+ * A device with one motherboard, two RX and one TX channel,
+ * and only the properties multi_usrp uses
+ **********************************************************************/
+class fake_usrp : public device{
+public:
+    fake_usrp(void){
+        _type = device::USRP;
+        _tree = property_tree::make();
+        const fs_path mb_path = "/mboards/0";
+        _tree->create<std::string>(mb_path / "name").set("fake");
+        _tree->create<time_spec_t>(mb_path / "time/cmd");
+        _tree->create<subdev_spec_t>(mb_path / "rx_subdev_spec").set(subdev_spec_t("A:0 A:1"));
+        _tree->create<subdev_spec_t>(mb_path / "tx_subdev_spec").set(subdev_spec_t("A:0"));
+        _tree->create<std::vector<size_t> >(mb_path / "rx_chan_dsp_mapping")
+            .set(boost::assign::list_of(0)(1));
+        _tree->create<std::vector<size_t> >(mb_path / "tx_chan_dsp_mapping")
+            .set(std::vector<size_t>(1, 0));
+
+        for (size_t i = 0; i < 2; i++){
+            populate_dsp(mb_path / "rx_dsps" / i);
+            populate_frontend(mb_path / "dboards/A/rx_frontends" / i);
+        }
+        populate_dsp(mb_path / "tx_dsps/0");
+        populate_frontend(mb_path / "dboards/A/tx_frontends/0");
+        populate_gain(mb_path / "rx_codecs/A/gains/digital", 0.0);
+        populate_gain(mb_path / "tx_codecs/A/gains/digital", 0.0);
+    }
+
+    rx_streamer::sptr get_rx_stream(const stream_args_t &){
+        throw uhd::not_implemented_error("fake_usrp has no streamers");
+    }
+
+    tx_streamer::sptr get_tx_stream(const stream_args_t &){
+        throw uhd::not_implemented_error("fake_usrp has no streamers");
+    }
+
+    bool recv_async_msg(async_metadata_t &, double){
+        return false;
+    }
+
+private:
+    void populate_dsp(const fs_path &path){
+        _tree->create<meta_range_t>(path / "rate/range").set(meta_range_t(1e3, 100e6));
+        _tree->create<double>(path / "rate/value").set(1e6);
+        _tree->create<meta_range_t>(path / "freq/range").set(meta_range_t(-50e6, 50e6));
+        _tree->create<double>(path / "freq/value").set(0.0);
+    }
+
+    void populate_frontend(const fs_path &path){
+        _tree->create<std::string>(path / "name").set("fake frontend");
+        _tree->create<meta_range_t>(path / "freq/range").set(meta_range_t(50e6, 6e9));
+        _tree->create<double>(path / "freq/value").set(1e9);
+        _tree->create<double>(path / "bandwidth/value").set(10e6);
+        _tree->create<bool>(path / "use_lo_offset").set(false);
+        populate_gain(path / "gains/PGA", 30.0);
+    }
+
+    void populate_gain(const fs_path &path, const double max){
+        _tree->create<meta_range_t>(path / "range").set(meta_range_t(0.0, max, 1.0));
+        _tree->create<double>(path / "value").set(0.0);
+    }
+};
+
+static device_addrs_t fake_usrp_find(const device_addr_t &hint){
+    device_addrs_t addrs;
+    if (hint.has_key("type") and hint["type"] == "fake_usrp") addrs.push_back(hint);
+    return addrs;
+}
+
+static device::sptr fake_usrp_make(const device_addr_t &){
+    return device::sptr(new fake_usrp());
+}
+
+UHD_STATIC_BLOCK(register_fake_usrp){
+    device::register_device(&fake_usrp_find, &fake_usrp_make, device::USRP);
+}
+
+/***********************************************************************
+ * Channel cache
+ **********************************************************************/
+BOOST_AUTO_TEST_CASE(test_multi_usrp_cache_dsp_mapping){
+    multi_usrp::sptr usrp = multi_usrp::make(device_addr_t("type=fake_usrp"));
+    property_tree::sptr tree = usrp->get_device()->get_tree();
+    tree->access<double>("/mboards/0/rx_dsps/1/rate/value").set(2e6);
+
+    //warm up the cache
+    BOOST_CHECK_EQUAL(usrp->get_rx_rate(0), 1e6);
+    BOOST_CHECK_EQUAL(usrp->get_rx_rate(1), 2e6);
+
+    //swapped dsps are picked up on the next call
+    tree->access<std::vector<size_t> >("/mboards/0/rx_chan_dsp_mapping")
+        .set(boost::assign::list_of(1)(0));
+    BOOST_CHECK_EQUAL(usrp->get_rx_rate(0), 2e6);
+    BOOST_CHECK_EQUAL(usrp->get_rx_rate(1), 1e6);
+
+    usrp->set_rx_rate(4e6, 0);
+    BOOST_CHECK_EQUAL(tree->access<double>("/mboards/0/rx_dsps/1/rate/value").get(), 4e6);
+    BOOST_CHECK_EQUAL(tree->access<double>("/mboards/0/rx_dsps/0/rate/value").get(), 1e6);
+
+    //all channels in one transaction
+    usrp->set_rx_rate(5e6);
+    BOOST_CHECK_EQUAL(usrp->get_rx_rate(0), 5e6);
+    BOOST_CHECK_EQUAL(usrp->get_rx_rate(1), 5e6);
+}
+
+BOOST_AUTO_TEST_CASE(test_multi_usrp_cache_subdev_spec){
+    multi_usrp::sptr usrp = multi_usrp::make(device_addr_t("type=fake_usrp"));
+    property_tree::sptr tree = usrp->get_device()->get_tree();
+    tree->access<double>("/mboards/0/dboards/A/rx_frontends/1/freq/value").set(2e9);
+
+    //warm up the cache
+    BOOST_CHECK_EQUAL(usrp->get_rx_num_channels(), 2);
+    BOOST_CHECK_EQUAL(usrp->get_rx_freq(0), 1e9);
+    BOOST_CHECK_EQUAL(usrp->get_rx_freq(1), 2e9);
+    usrp->set_rx_gain(10.0, 0);
+    BOOST_CHECK_EQUAL(tree->access<double>("/mboards/0/dboards/A/rx_frontends/0/gains/PGA/value").get(), 10.0);
+
+    //channel 0 moves to the other frontend
+    usrp->set_rx_subdev_spec(subdev_spec_t("A:1"), 0);
+    BOOST_CHECK_EQUAL(usrp->get_rx_num_channels(), 1);
+    BOOST_CHECK_EQUAL(usrp->get_rx_freq(0), 2e9);
+    usrp->set_rx_gain(20.0, 0);
+    BOOST_CHECK_EQUAL(tree->access<double>("/mboards/0/dboards/A/rx_frontends/1/gains/PGA/value").get(), 20.0);
+    BOOST_CHECK_EQUAL(tree->access<double>("/mboards/0/dboards/A/rx_frontends/0/gains/PGA/value").get(), 10.0);
+    BOOST_CHECK_THROW(usrp->get_rx_freq(1), uhd::index_error);
+}
+
+/***********************************************************************
+ * Hop schedules
+ **********************************************************************/
+typedef std::vector<std::pair<time_spec_t, double> > timed_writes_t;
+
+static void record_timed_write(property_tree::sptr tree, timed_writes_t *writes, const double value){
+    writes->push_back(std::make_pair(tree->access<time_spec_t>("/mboards/0/time/cmd").get(), value));
+}
+
+static double round_to_mhz(const double freq){
+    return boost::math::round(freq/1e6)*1e6;
+}
+
+BOOST_AUTO_TEST_CASE(test_multi_usrp_hop_schedule){
+    multi_usrp::sptr usrp = multi_usrp::make(device_addr_t("type=fake_usrp"));
+    property_tree::sptr tree = usrp->get_device()->get_tree();
+    const fs_path fe_path = "/mboards/0/dboards/A/rx_frontends/0";
+    timed_writes_t freqs, gains, dsp_freqs;
+    tree->access<double>(fe_path / "freq/value")
+        .set_coercer(&round_to_mhz)
+        .add_coerced_subscriber(boost::bind(&record_timed_write, tree, &freqs, _1));
+    tree->access<double>(fe_path / "gains/PGA/value")
+        .add_coerced_subscriber(boost::bind(&record_timed_write, tree, &gains, _1));
+    tree->access<double>("/mboards/0/rx_dsps/0/freq/value")
+        .add_coerced_subscriber(boost::bind(&record_timed_write, tree, &dsp_freqs, _1));
+
+    typedef multi_usrp::hop_t hop_t;
+    multi_usrp::hop_schedule_t schedule;
+    schedule.push_back(hop_t(time_spec_t(3.0), 0, hop_t::SETTING_FREQ, 2.4003e9));
+    schedule.push_back(hop_t(time_spec_t(1.0), 0, hop_t::SETTING_FREQ, 2.4003e9));
+    schedule.push_back(hop_t(time_spec_t(2.0), 0, hop_t::SETTING_GAIN, 10.0));
+    usrp->set_rx_hop_schedule(schedule);
+
+    //the hops are sent in time order, the DSP makes up for the rounding
+    BOOST_REQUIRE_EQUAL(freqs.size(), 2);
+    BOOST_CHECK(freqs[0].first == time_spec_t(1.0));
+    BOOST_CHECK(freqs[1].first == time_spec_t(3.0));
+    BOOST_CHECK_EQUAL(freqs[1].second, 2.4e9);
+    BOOST_REQUIRE_EQUAL(dsp_freqs.size(), 2);
+    BOOST_CHECK(dsp_freqs[1].first == time_spec_t(3.0));
+    BOOST_CHECK_CLOSE(dsp_freqs[1].second, -0.3e6, 1e-6);
+    BOOST_REQUIRE_EQUAL(gains.size(), 1);
+    BOOST_CHECK(gains[0].first == time_spec_t(2.0));
+    BOOST_CHECK_EQUAL(gains[0].second, 10.0);
+    BOOST_CHECK(tree->access<time_spec_t>("/mboards/0/time/cmd").get() == time_spec_t(0.0));
+    BOOST_CHECK_CLOSE(usrp->get_rx_freq(0), 2.4003e9, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(test_multi_usrp_hop_schedule_untimed){
+    multi_usrp::sptr usrp = multi_usrp::make(device_addr_t("type=fake_usrp"));
+    property_tree::sptr tree = usrp->get_device()->get_tree();
+    const fs_path fe_path = "/mboards/0/dboards/A/rx_frontends/1";
+    tree->create<bool>(fe_path / "timed_commands").set(false);
+
+    //a frontend that ignores the command time can't take gain or tune hops
+    typedef multi_usrp::hop_t hop_t;
+    multi_usrp::hop_schedule_t schedule;
+    schedule.push_back(hop_t(time_spec_t(1.0), 0, hop_t::SETTING_FREQ, 2e9));
+    schedule.push_back(hop_t(time_spec_t(2.0), 1, hop_t::SETTING_GAIN, 10.0));
+    BOOST_CHECK_THROW(usrp->set_rx_hop_schedule(schedule), uhd::not_implemented_error);
+    schedule.back() = hop_t(time_spec_t(2.0), 1, hop_t::SETTING_FREQ, 2e9);
+    BOOST_CHECK_THROW(usrp->set_rx_hop_schedule(schedule), uhd::not_implemented_error);
+    BOOST_CHECK_EQUAL(usrp->get_rx_freq(0), 1e9);
+
+    //unless its frequencies fit into the fast lock profiles
+    timed_writes_t recalls;
+    tree->create<size_t>(fe_path / "freq/fast_lock/num_profiles").set(2);
+    tree->create<double>(fe_path / "freq/fast_lock/profiles/0/value").set(0.0);
+    tree->create<double>(fe_path / "freq/fast_lock/profiles/1/value").set(0.0);
+    tree->create<size_t>(fe_path / "freq/fast_lock/recall")
+        .add_coerced_subscriber(boost::bind(&record_timed_write, tree, &recalls, _1));
+    schedule.push_back(hop_t(time_spec_t(3.0), 1, hop_t::SETTING_FREQ, 3e9));
+    schedule.push_back(hop_t(time_spec_t(4.0), 1, hop_t::SETTING_FREQ, 4e9));
+    BOOST_CHECK_THROW(usrp->set_rx_hop_schedule(schedule), uhd::not_implemented_error);
+    BOOST_CHECK_EQUAL(tree->access<double>(fe_path / "freq/fast_lock/profiles/0/value").get(), 0.0);
+    BOOST_CHECK(recalls.empty());
+
+    schedule.back() = hop_t(time_spec_t(4.0), 1, hop_t::SETTING_FREQ, 2e9);
+    usrp->set_rx_hop_schedule(schedule);
+    BOOST_CHECK_EQUAL(tree->access<double>(fe_path / "freq/fast_lock/profiles/0/value").get(), 2e9);
+    BOOST_CHECK_EQUAL(tree->access<double>(fe_path / "freq/fast_lock/profiles/1/value").get(), 3e9);
+    BOOST_REQUIRE_EQUAL(recalls.size(), 3);
+    BOOST_CHECK(recalls[0].first == time_spec_t(2.0));
+    BOOST_CHECK_EQUAL(recalls[0].second, 0);
+    BOOST_CHECK_EQUAL(recalls[1].second, 1);
+    BOOST_CHECK(recalls[2].first == time_spec_t(4.0));
+    BOOST_CHECK_EQUAL(recalls[2].second, 0);
+    BOOST_CHECK_EQUAL(usrp->get_rx_freq(0), 2e9);
+}
@@ -0,0 +1,88 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include "../lib/transport/nco_mixer.hpp"
+#include <complex>
+#include <vector>
+#include <cstdlib>
+
+using namespace uhd::transport::sph;
+
+typedef std::complex<float> fc32_t;
+
+#define MY_CHECK_CLOSE(a, b, f) { \
+    BOOST_CHECK_MESSAGE(std::abs((a)-(b)) < f, "\n\t" << #a << " (" << (a) << ") error " << #b << " (" << (b) << ")"); \
+}
+
+BOOST_AUTO_TEST_CASE(test_nco_mixer_vs_polar){
+    const double freq = 0.0123, phase = 0.3;
+    //odd length to cover the scalar remainder and several blocks
+    const size_t nsamps = 1001;
+
+    std::vector<fc32_t> input(nsamps), output(nsamps);
+    for (size_t i = 0; i < nsamps; i++) input[i] = fc32_t(
+        float(std::rand())/RAND_MAX - 0.5f, float(std::rand())/RAND_MAX - 0.5f
+    );
+
+    nco_mixer nco;
+    nco.set_freq(freq);
+    nco.set_phase(phase);
+    nco.mix(&input.front(), &output.front(), nsamps);
+
+    for (size_t i = 0; i < nsamps; i++){
+        const fc32_t expected = input[i]*fc32_t(std::polar(1.0, 2*M_PI*(phase + i*freq)));
+        MY_CHECK_CLOSE(expected, output[i], float(1e-5));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_nco_mixer_phase_continuity){
+    const size_t nsamps = 300;
+    std::vector<fc32_t> whole(nsamps, fc32_t(1.0f, 0.0f)), split(nsamps, fc32_t(1.0f, 0.0f));
+
+    nco_mixer nco0;
+    nco0.set_freq(-0.21);
+    nco0.mix(&whole.front(), &whole.front(), nsamps);
+
+    //in place, in uneven pieces
+    nco_mixer nco1;
+    nco1.set_freq(-0.21);
+    nco1.mix(&split.front(), &split.front(), 77);
+    nco1.mix(&split.front() + 77, &split.front() + 77, nsamps - 77);
+
+    for (size_t i = 0; i < nsamps; i++){
+        MY_CHECK_CLOSE(whole[i], split[i], float(1e-5));
+    }
+    BOOST_CHECK_CLOSE(nco0.get_phase(), nco1.get_phase(), 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(test_nco_mixer_phase_from_time){
+    const double freq_hz = 1.25e6, rate = 10e6;
+
+    //phase at a time must match the phase accumulated up to that time
+    nco_mixer nco0;
+    nco0.set_phase_at(uhd::time_spec_t(1000, 0.0), freq_hz);
+    nco0.set_freq(freq_hz/rate);
+    std::vector<fc32_t> samps(333);
+    nco0.mix(&samps.front(), &samps.front(), samps.size());
+
+    nco_mixer nco1;
+    nco1.set_phase_at(uhd::time_spec_t::from_ticks(333, rate) + uhd::time_spec_t(1000, 0.0), freq_hz);
+    BOOST_CHECK_SMALL(std::abs(
+        std::polar(1.0, 2*M_PI*nco0.get_phase()) - std::polar(1.0, 2*M_PI*nco1.get_phase())
+    ), 1e-6);
+}
@@ -0,0 +1,86 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/mutex.hpp>
+#include "../lib/usrp/common/parallel_mboard_setup.hpp"
+
+using namespace uhd;
+using namespace uhd::usrp;
+
+class setup_recorder{
+public:
+    setup_recorder(const size_t num, const size_t fail_a, const size_t fail_b):
+        done(num, false), _fail_a(fail_a), _fail_b(fail_b)
+    {}
+
+    void setup(const size_t i, const device_addr_t &args){
+        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+        if (i == _fail_a or i == _fail_b){
+            throw uhd::value_error(args["addr"]);
+        }
+        boost::mutex::scoped_lock lock(_mutex);
+        done[i] = true;
+    }
+
+    std::vector<bool> done;
+
+private:
+    const size_t _fail_a, _fail_b;
+    boost::mutex _mutex;
+};
+
+static device_addrs_t make_args(const size_t num){
+    device_addrs_t args(num);
+    for (size_t i = 0; i < num; i++){
+        args[i]["addr"] = boost::lexical_cast<std::string>(i);
+    }
+    return args;
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_mboard_setup_all){
+    setup_recorder recorder(8, 8, 8);
+    parallel_mboard_setup::run(
+        boost::bind(&setup_recorder::setup, &recorder, _1, _2), make_args(8), 3);
+    for (size_t i = 0; i < 8; i++){
+        BOOST_CHECK(recorder.done[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_mboard_setup_error){
+    //the error of the lowest index wins, whichever thread fails first
+    setup_recorder recorder(8, 5, 2);
+    try{
+        parallel_mboard_setup::run(
+            boost::bind(&setup_recorder::setup, &recorder, _1, _2), make_args(8), 4);
+        BOOST_FAIL("expected a value_error");
+    }
+    catch(const uhd::value_error &e){
+        BOOST_CHECK(std::string(e.what()).find("2") != std::string::npos);
+    }
+    BOOST_CHECK(recorder.done[0]);
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_mboard_setup_serial){
+    //with one thread the setups stop at the first error
+    setup_recorder recorder(4, 1, 4);
+    BOOST_CHECK_THROW(parallel_mboard_setup::run(
+        boost::bind(&setup_recorder::setup, &recorder, _1, _2), make_args(4), 1), uhd::value_error);
+    BOOST_CHECK(recorder.done[0]);
+    BOOST_CHECK(not recorder.done[2]);
+}
@@ -0,0 +1,82 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include "../lib/transport/polyphase_resampler.hpp"
+#include <complex>
+#include <vector>
+
+using namespace uhd::transport::sph;
+
+typedef std::complex<float> fc32_t;
+
+#define MY_CHECK_CLOSE(a, b, f) { \
+    BOOST_CHECK_MESSAGE(std::abs((a)-(b)) < f, "\n\t" << #a << " (" << (a) << ") error " << #b << " (" << (b) << ")"); \
+}
+
+static std::vector<fc32_t> make_tone(const size_t nsamps, const double freq){
+    std::vector<fc32_t> tone(nsamps);
+    for (size_t i = 0; i < nsamps; i++){
+        tone[i] = fc32_t(std::polar(1.0, 2*M_PI*freq*i));
+    }
+    return tone;
+}
+
+BOOST_AUTO_TEST_CASE(test_polyphase_resampler_tone){
+    const size_t interp = 3, decim = 2, ntaps = 32;
+    const double freq = 0.05; //cycles per input sample
+    const std::vector<fc32_t> input = make_tone(2000, freq);
+
+    polyphase_resampler resamp(interp, decim, ntaps);
+    std::vector<fc32_t> output(resamp.get_max_output(input.size()));
+    const double offset0 = resamp.get_next_output_offset();
+    const size_t nout = resamp.process(&input.front(), input.size(), &output.front());
+    BOOST_CHECK_EQUAL(nout, input.size()*interp/decim);
+
+    //each output is the tone at its position on the input timeline
+    for (size_t j = 0; j < nout; j++){
+        const double t = offset0 + double(j*decim)/interp;
+        if (t < ntaps) continue; //filter warm-up
+        MY_CHECK_CLOSE(fc32_t(std::polar(1.0, 2*M_PI*freq*t)), output[j], float(1e-2));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_polyphase_resampler_chunks){
+    const std::vector<fc32_t> input = make_tone(1000, 0.01);
+
+    polyphase_resampler whole(2, 5);
+    std::vector<fc32_t> expected(whole.get_max_output(input.size()));
+    expected.resize(whole.process(&input.front(), input.size(), &expected.front()));
+
+    //the same stream in uneven chunks, also smaller than the filter
+    polyphase_resampler chunked(2, 5);
+    std::vector<fc32_t> output;
+    const size_t chunks[] = {1, 7, 100, 3, 389, 500};
+    size_t offset = 0;
+    for (size_t c = 0; c < sizeof(chunks)/sizeof(chunks[0]); c++){
+        std::vector<fc32_t> out(chunked.get_max_output(chunks[c]));
+        out.resize(chunked.process(&input[offset], chunks[c], &out.front()));
+        output.insert(output.end(), out.begin(), out.end());
+        offset += chunks[c];
+    }
+
+    BOOST_REQUIRE_EQUAL(output.size(), expected.size());
+    for (size_t i = 0; i < output.size(); i++){
+        MY_CHECK_CLOSE(expected[i], output[i], float(1e-5));
+    }
+    BOOST_CHECK_CLOSE(whole.get_next_output_offset(), chunked.get_next_output_offset(), 1e-9);
+}
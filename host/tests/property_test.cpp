@@ -17,7 +17,9 @@
 
 #include <boost/test/unit_test.hpp>
 #include <uhd/property_tree.hpp>
+#include <uhd/utils/atomic.hpp>
 #include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
 #include <exception>
 #include <iostream>
 
@@ -225,6 +227,220 @@ BOOST_AUTO_TEST_CASE(test_prop_subtree){
 
 }
 
+BOOST_AUTO_TEST_CASE(test_prop_transaction){
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    uhd::property<int> &prop0 = tree->create<int>("/test/prop0");
+    uhd::property<int> &prop1 = tree->subtree("/test")->create<int>("prop1");
+    uhd::property<int> &prop2 = tree->create<int>("/test/prop2");
+
+    setter_type setter0, setter1;
+    prop0.add_coerced_subscriber(boost::bind(&setter_type::doit, &setter0, _1));
+    prop1.add_coerced_subscriber(boost::bind(&setter_type::doit, &setter1, _1));
+    prop0.set(1);
+    prop1.set(2);
+
+    tree->begin_transaction();
+    prop0.set(10);
+    prop1.set(20);
+    tree->begin_transaction(); //nested
+    prop0.set(11);
+    prop2.set(30);
+    tree->commit_transaction();
+    tree->remove("/test/prop2"); //dropped from the transaction
+
+    //nothing ran yet, the desired values are stored
+    BOOST_CHECK_EQUAL(setter0._count, 1);
+    BOOST_CHECK_EQUAL(setter1._count, 1);
+    BOOST_CHECK_EQUAL(prop0.get(), 1);
+    BOOST_CHECK_EQUAL(prop0.get_desired(), 11);
+
+    //one update per property, with the last value
+    tree->commit_transaction();
+    BOOST_CHECK_EQUAL(setter0._count, 2);
+    BOOST_CHECK_EQUAL(setter0._x, 11);
+    BOOST_CHECK_EQUAL(setter1._count, 2);
+    BOOST_CHECK_EQUAL(setter1._x, 20);
+    BOOST_CHECK_EQUAL(prop0.get(), 11);
+    BOOST_CHECK_EQUAL(prop1.get(), 20);
+
+    //closed again, updates run right away
+    prop0.set(12);
+    BOOST_CHECK_EQUAL(setter0._count, 3);
+    BOOST_CHECK_THROW(tree->commit_transaction(), uhd::runtime_error);
+}
+
+struct reader_type{
+    reader_type(uhd::property<int> &prop) : _prop(prop), _x(0) {}
+
+    void doit(int){
+        _x = _prop.get();
+    }
+
+    uhd::property<int> &_prop;
+    int _x;
+};
+
+BOOST_AUTO_TEST_CASE(test_prop_transaction_rounds){
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    uhd::property<int> &prop0 = tree->create<int>("/test/prop0");
+    uhd::property<int> &prop1 = tree->create<int>("/test/prop1");
+    uhd::property<int> &prop2 = tree->create<int>("/test/prop2");
+    uhd::property<int> &sum = tree->create<int>("/test/sum");
+
+    //prop0 and prop1 both set sum, prop2 reads it back
+    setter_type setter;
+    reader_type reader(sum);
+    sum.add_coerced_subscriber(boost::bind(&setter_type::doit, &setter, _1));
+    prop0.add_coerced_subscriber(boost::bind(&uhd::property<int>::set, &sum, _1));
+    prop1.add_coerced_subscriber(boost::bind(&uhd::property<int>::set, &sum, _1));
+    prop2.add_coerced_subscriber(boost::bind(&reader_type::doit, &reader, _1));
+
+    //sum depends on prop0 and prop1, it is updated once after both
+    tree->begin_transaction();
+    prop0.set(1);
+    prop1.set(2);
+    tree->commit_transaction();
+    BOOST_CHECK_EQUAL(setter._count, 1);
+    BOOST_CHECK_EQUAL(setter._x, 2);
+    BOOST_CHECK_EQUAL(sum.get(), 2);
+
+    //reading sum during the commit applies its pending update first
+    tree->begin_transaction();
+    prop0.set(5);
+    prop2.set(0);
+    tree->commit_transaction();
+    BOOST_CHECK_EQUAL(reader._x, 5);
+    BOOST_CHECK_EQUAL(setter._count, 2);
+}
+
+static void set_prop(uhd::property<int> *prop, const int x){
+    prop->set(x);
+}
+
+static void try_commit(uhd::property_tree::sptr tree, bool *threw){
+    try{
+        tree->commit_transaction();
+    }
+    catch(const uhd::runtime_error &){
+        *threw = true;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_prop_transaction_per_thread){
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    uhd::property<int> &prop0 = tree->create<int>("/test/prop0");
+    uhd::property<int> &prop1 = tree->create<int>("/test/prop1");
+
+    setter_type setter0, setter1;
+    prop0.add_coerced_subscriber(boost::bind(&setter_type::doit, &setter0, _1));
+    prop1.add_coerced_subscriber(boost::bind(&setter_type::doit, &setter1, _1));
+
+    tree->begin_transaction();
+    prop0.set(1);
+
+    //another thread is not part of this transaction
+    boost::thread other(boost::bind(&set_prop, &prop1, 2));
+    other.join();
+    BOOST_CHECK_EQUAL(setter1._count, 1);
+    BOOST_CHECK_EQUAL(prop1.get(), 2);
+
+    //and cannot commit it
+    bool threw = false;
+    boost::thread other_commit(boost::bind(&try_commit, tree->subtree("/test"), &threw));
+    other_commit.join();
+    BOOST_CHECK(threw);
+    BOOST_CHECK_EQUAL(setter0._count, 0);
+
+    tree->commit_transaction();
+    BOOST_CHECK_EQUAL(setter0._count, 1);
+    BOOST_CHECK_EQUAL(prop0.get(), 1);
+}
+
+struct lazy_dir_type{
+    lazy_dir_type(uhd::property_tree::sptr tree, const uhd::fs_path &path):
+        _tree(tree), _path(path), _count(0) {}
+
+    void doit(void){
+        _count++;
+        _tree->create<int>(_path / "gain").set(_count);
+    }
+
+    uhd::property_tree::sptr _tree;
+    uhd::fs_path _path;
+    int _count;
+};
+
+BOOST_AUTO_TEST_CASE(test_prop_tree_lazy){
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    tree->create<int>("/fe/1/gain");
+
+    lazy_dir_type lazy0(tree, "/fe/0");
+    tree->create_lazy("/fe/0", boost::bind(&lazy_dir_type::doit, &lazy0));
+    lazy_dir_type lazy2(tree, "/fe/2");
+    tree->create_lazy("/fe/2", boost::bind(&lazy_dir_type::doit, &lazy2));
+
+    //listed by the parent without running
+    BOOST_CHECK_EQUAL(tree->list("/fe").size(), 3);
+    tree->access<int>("/fe/1/gain").set(1);
+    BOOST_CHECK_EQUAL(lazy0._count, 0);
+
+    //runs once, on first use, also through a subtree
+    uhd::property_tree::sptr subtree = tree->subtree("/fe/0");
+    BOOST_CHECK_EQUAL(subtree->access<int>("gain").get(), 1);
+    BOOST_CHECK_EQUAL(tree->list("/fe/0").size(), 1);
+    BOOST_CHECK_EQUAL(lazy0._count, 1);
+
+    //removing drops it
+    tree->remove("/fe/2");
+    BOOST_CHECK(not tree->exists("/fe/2/gain"));
+    BOOST_CHECK_EQUAL(lazy2._count, 0);
+}
+
+struct blocking_lazy_dir_type{
+    blocking_lazy_dir_type(uhd::property_tree::sptr tree):
+        _tree(tree) {
+        _started.write(0);
+        _release.write(0);
+    }
+
+    void doit(void){
+        _started.write(1);
+        while (_release.read() == 0){
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        }
+        _tree->create<int>("/fe/0/gain").set(5);
+    }
+
+    void access(void){
+        _value = _tree->access<int>("/fe/0/gain").get();
+    }
+
+    uhd::property_tree::sptr _tree;
+    uhd::atomic_uint32_t _started, _release;
+    int _value;
+};
+
+BOOST_AUTO_TEST_CASE(test_prop_tree_lazy_concurrent){
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    tree->create<int>("/fe/1/gain");
+
+    blocking_lazy_dir_type lazy0(tree);
+    tree->create_lazy("/fe/0", boost::bind(&blocking_lazy_dir_type::doit, &lazy0));
+    boost::thread user(boost::bind(&blocking_lazy_dir_type::access, &lazy0));
+    while (lazy0._started.read() == 0){
+        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    }
+
+    //other paths are not held up by a running init function
+    tree->access<int>("/fe/1/gain").set(1);
+    BOOST_CHECK(tree->exists("/fe/1"));
+    BOOST_CHECK_EQUAL(tree->list("/fe").size(), 2);
+
+    lazy0._release.write(1);
+    user.join();
+    BOOST_CHECK_EQUAL(lazy0._value, 5);
+    BOOST_CHECK_EQUAL(tree->access<int>("/fe/0/gain").get(), 5);
+}
 
 BOOST_AUTO_TEST_CASE(test_prop_operators)
 {
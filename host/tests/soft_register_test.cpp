@@ -0,0 +1,159 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/utils/soft_register.hpp>
+#include <uhd/exception.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <vector>
+
+using namespace uhd;
+
+//! A bus that records every write and can be told to fail batches
+class mock_wb_iface : public wb_iface{
+public:
+    typedef std::pair<wb_addr_type, boost::uint64_t> write_type;
+
+    mock_wb_iface(void): num_batches(0), fail_batches(false){}
+
+    void poke64(const wb_addr_type addr, const boost::uint64_t data){
+        writes.push_back(write_type(addr, data));
+    }
+
+    void poke32(const wb_addr_type addr, const boost::uint32_t data){
+        writes.push_back(write_type(addr, data));
+    }
+
+    void poke32_batch(const poke32_batch_type &pokes){
+        if (on_batch) on_batch();
+        if (fail_batches) throw uhd::io_error("mock_wb_iface: batch failed");
+        num_batches++;
+        wb_iface::poke32_batch(pokes);
+    }
+
+    std::vector<write_type> writes;
+    size_t num_batches;
+    bool fail_batches;
+    boost::function<void(void)> on_batch;
+};
+
+class test_regmap_t : public soft_regmap_t{
+public:
+    test_regmap_t(void): soft_regmap_t("test_regmap"),
+        reg0(0x10, OPTIMIZED_FLUSH),
+        reg1(0x14, OPTIMIZED_FLUSH),
+        reg64(0x18, OPTIMIZED_FLUSH),
+        reg2(0x20, OPTIMIZED_FLUSH)
+    {
+        add_to_map(reg0, "reg0");
+        add_to_map(reg1, "reg1");
+        add_to_map(reg64, "reg64");
+        add_to_map(reg2, "reg2");
+    }
+
+    soft_reg32_wo_t reg0;
+    soft_reg32_wo_sync_t reg1;
+    soft_reg64_wo_t reg64;
+    soft_reg32_wo_t reg2;
+};
+
+BOOST_AUTO_TEST_CASE(test_soft_regmap_flush_order){
+    mock_wb_iface iface;
+    test_regmap_t regmap;
+    regmap.initialize(iface);
+    regmap.reg0.set(soft_reg32_wo_t::REGISTER, 1);
+    regmap.reg1.set(soft_reg32_wo_t::REGISTER, 2);
+    regmap.reg64.set(soft_reg64_wo_t::REGISTER, 3);
+    regmap.reg2.set(soft_reg32_wo_t::REGISTER, 4);
+    regmap.flush();
+
+    //the 64-bit register splits the batch, the order is kept
+    BOOST_CHECK_EQUAL(iface.num_batches, 2);
+    BOOST_REQUIRE_EQUAL(iface.writes.size(), 4);
+    BOOST_CHECK_EQUAL(iface.writes[0].first, 0x10);
+    BOOST_CHECK_EQUAL(iface.writes[1].first, 0x14);
+    BOOST_CHECK_EQUAL(iface.writes[2].first, 0x18);
+    BOOST_CHECK_EQUAL(iface.writes[3].first, 0x20);
+    BOOST_CHECK_EQUAL(iface.writes[3].second, 4);
+
+    //clean registers are not written again
+    iface.writes.clear();
+    regmap.reg1.set(soft_reg32_wo_t::REGISTER, 5);
+    regmap.flush();
+    BOOST_REQUIRE_EQUAL(iface.writes.size(), 1);
+    BOOST_CHECK_EQUAL(iface.writes[0].first, 0x14);
+    BOOST_CHECK_EQUAL(iface.writes[0].second, 5);
+}
+
+BOOST_AUTO_TEST_CASE(test_soft_regmap_flush_failure){
+    mock_wb_iface iface;
+    test_regmap_t regmap;
+    regmap.initialize(iface);
+    regmap.flush();
+    iface.writes.clear();
+
+    regmap.reg0.set(soft_reg32_wo_t::REGISTER, 1);
+    regmap.reg1.set(soft_reg32_wo_t::REGISTER, 2);
+    iface.fail_batches = true;
+    BOOST_CHECK_THROW(regmap.flush(), uhd::io_error);
+    BOOST_CHECK(iface.writes.empty());
+
+    //nothing was marked clean and the sync register was released
+    regmap.reg1.set(soft_reg32_wo_t::REGISTER, 3);
+    iface.fail_batches = false;
+    regmap.flush();
+    BOOST_REQUIRE_EQUAL(iface.writes.size(), 2);
+    BOOST_CHECK_EQUAL(iface.writes[0].first, 0x10);
+    BOOST_CHECK_EQUAL(iface.writes[0].second, 1);
+    BOOST_CHECK_EQUAL(iface.writes[1].first, 0x14);
+    BOOST_CHECK_EQUAL(iface.writes[1].second, 3);
+}
+
+static void set_reg(soft_reg32_wo_sync_t *reg, const boost::uint32_t value){
+    reg->set(soft_reg32_wo_sync_t::REGISTER, value);
+}
+
+static void start_set_during_batch(mock_wb_iface *iface, soft_reg32_wo_sync_t *reg, boost::thread *thread){
+    iface->on_batch.clear();
+    *thread = boost::thread(boost::bind(&set_reg, reg, 7));
+    //the register is held until the batch is written
+    BOOST_CHECK(not thread->timed_join(boost::posix_time::milliseconds(50)));
+}
+
+BOOST_AUTO_TEST_CASE(test_soft_regmap_flush_locked){
+    mock_wb_iface iface;
+    test_regmap_t regmap;
+    regmap.initialize(iface);
+    regmap.flush();
+    iface.writes.clear();
+
+    boost::thread thread;
+    regmap.reg1.set(soft_reg32_wo_t::REGISTER, 6);
+    iface.on_batch = boost::bind(&start_set_during_batch, &iface, &regmap.reg1, &thread);
+    regmap.flush();
+    thread.join();
+    BOOST_REQUIRE_EQUAL(iface.writes.size(), 1);
+    BOOST_CHECK_EQUAL(iface.writes[0].second, 6);
+
+    //the value set while the batch was sent is not lost
+    regmap.flush();
+    BOOST_REQUIRE_EQUAL(iface.writes.size(), 2);
+    BOOST_CHECK_EQUAL(iface.writes[1].first, 0x14);
+    BOOST_CHECK_EQUAL(iface.writes[1].second, 7);
+}
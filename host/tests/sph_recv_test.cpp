@@ -68,7 +68,8 @@ public:
 
     void push_back_packet(
         uhd::transport::vrt::if_packet_info_t &ifpi,
-        const boost::uint32_t optional_msg_word = 0
+        const boost::uint32_t optional_msg_word = 0,
+        const boost::uint32_t *optional_payload = NULL
     ){
         const size_t max_pkt_len = (ifpi.num_payload_words32 + uhd::transport::vrt::max_if_hdr_words32 + 1/*tlr*/)*sizeof(boost::uint32_t);
         _mems.push_back(boost::shared_array<char>(new char[max_pkt_len]));
@@ -79,6 +80,8 @@ public:
             uhd::transport::vrt::if_hdr_pack_le(reinterpret_cast<boost::uint32_t *>(_mems.back().get()), ifpi);
         }
         (reinterpret_cast<boost::uint32_t *>(_mems.back().get()) + ifpi.num_header_words32)[0] = optional_msg_word | uhd::byteswap(optional_msg_word);
+        if (optional_payload != NULL) std::copy(optional_payload, optional_payload + ifpi.num_payload_words32,
+            reinterpret_cast<boost::uint32_t *>(_mems.back().get()) + ifpi.num_header_words32);
         _lens.push_back(ifpi.num_packet_words32*sizeof(boost::uint32_t));
     }
 
@@ -343,6 +346,152 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_inline_message){
     }
 }
 
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_resampled){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    dummy_recv_xport_class dummy_recv_xport("big");
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 0;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+    static const size_t INTERP = 2, DECIM = 5, TAPS = 32;
+
+    //generate a bunch of packets
+    size_t num_input_samps = 0;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        ifpi.num_payload_words32 = 10 + i%10;
+        dummy_recv_xport.push_back_packet(ifpi);
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+        num_input_samps += ifpi.num_payload_words32;
+    }
+
+    //create the super receive packet handler
+    uhd::transport::sph::recv_packet_handler handler(1);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    handler.set_xport_chan_get_buff(0, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xport, _1));
+    handler.set_converter(id, uhd::device_addr_t(str(boost::format(
+        "resamp_interp=%u,resamp_decim=%u,resamp_taps=%u") % INTERP % DECIM % TAPS)));
+
+    //the first output lies before the first input by the filter delay
+    const uhd::time_spec_t time0(-((TAPS*INTERP - 1)/2.0)/INTERP/SAMP_RATE);
+
+    //check the received samples, buffer smaller than the resampled packets
+    size_t num_accum_samps = 0;
+    std::vector<std::complex<float> > buff(3);
+    uhd::rx_metadata_t metadata;
+    while (true){
+        size_t num_samps_ret = handler.recv(
+            &buff.front(), buff.size(), metadata, 1.0, false
+        );
+        if (metadata.error_code != uhd::rx_metadata_t::ERROR_CODE_NONE) break;
+        BOOST_CHECK(metadata.has_time_spec);
+        BOOST_CHECK_TS_CLOSE(metadata.time_spec, time0 + uhd::time_spec_t::from_ticks(
+            num_accum_samps*DECIM, SAMP_RATE*INTERP));
+        num_accum_samps += num_samps_ret;
+    }
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+    BOOST_CHECK_EQUAL(num_accum_samps, (num_input_samps*INTERP + DECIM - 1)/DECIM);
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_sc4){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc4_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    dummy_recv_xport_class dummy_recv_xport("big");
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = uhd::transport::vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 0;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+
+    //generate a bunch of packets with a known ramp, four samples per word
+    size_t num_input_samps = 0;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        ifpi.num_payload_words32 = 10 + i%10;
+        std::vector<boost::uint32_t> payload(ifpi.num_payload_words32, 0);
+        for (size_t j = 0; j < payload.size()*4; j++){
+            const size_t n = (num_input_samps + j)%16; //I = n - 8, Q = 7 - n
+            payload[j/4] |= boost::uint32_t((((n - 8) & 0xf) << 4) | ((7 - n) & 0xf)) << (24 - 8*(j%4));
+        }
+        for (size_t j = 0; j < payload.size(); j++) payload[j] = uhd::htonx(payload[j]);
+        dummy_recv_xport.push_back_packet(ifpi, 0, &payload.front());
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*4*size_t(TICK_RATE/SAMP_RATE);
+        num_input_samps += ifpi.num_payload_words32*4;
+    }
+
+    //create the super receive packet handler
+    uhd::transport::sph::recv_packet_handler handler(1);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    handler.set_xport_chan_get_buff(0, boost::bind(&dummy_recv_xport_class::get_recv_buff, &dummy_recv_xport, _1));
+    handler.set_converter(id);
+    handler.set_scale_factor(1.0);
+
+    //check the received samples, odd buffer size so packets resume inside of words
+    size_t num_accum_samps = 0;
+    std::vector<std::complex<float> > buff(7);
+    uhd::rx_metadata_t metadata;
+    while (num_accum_samps < num_input_samps){
+        size_t num_samps_ret = handler.recv(
+            &buff.front(), buff.size(), metadata, 1.0, true
+        );
+        BOOST_REQUIRE_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_CHECK(metadata.has_time_spec);
+        BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
+        for (size_t j = 0; j < num_samps_ret; j++){
+            const int n = int((num_accum_samps + j)%16);
+            BOOST_CHECK_EQUAL(buff[j], std::complex<float>(float(n - 8), float(7 - n)));
+        }
+        num_accum_samps += num_samps_ret;
+    }
+    BOOST_CHECK_EQUAL(num_accum_samps, num_input_samps);
+
+    //subsequent receives should be a timeout
+    handler.recv(&buff.front(), buff.size(), metadata, 1.0, true);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+}
+
 ////////////////////////////////////////////////////////////////////////
 BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_normal){
 ////////////////////////////////////////////////////////////////////////
@@ -190,3 +190,58 @@ BOOST_AUTO_TEST_CASE(test_sph_send_one_channel_full_buffer_mode){
         num_accum_samps += ifpi.num_payload_words32;
     }
 }
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_send_one_channel_sc4){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "fc32";
+    id.num_inputs = 1;
+    id.output_format = "sc4_item32_be";
+    id.num_outputs = 1;
+
+    dummy_send_xport_class dummy_send_xport("big");
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+
+    //create the super send packet handler
+    uhd::transport::sph::send_packet_handler handler(1);
+    handler.set_vrt_packer(&uhd::transport::vrt::if_hdr_pack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    handler.set_xport_chan_get_buff(0, boost::bind(&dummy_send_xport_class::get_send_buff, &dummy_send_xport, _1));
+    handler.set_converter(id);
+    handler.set_max_samples_per_packet(80);
+
+    //allocate metadata and buffer
+    std::vector<std::complex<float> > buff(80);
+    uhd::tx_metadata_t metadata;
+    metadata.has_time_spec = true;
+    metadata.time_spec = uhd::time_spec_t(0.0);
+
+    //generate the test data, also sample counts that do not fill the last word
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        metadata.start_of_burst = (i == 0);
+        metadata.end_of_burst = (i == NUM_PKTS_TO_TEST-1);
+        const size_t num_sent = handler.send(
+            &buff.front(), 40 + i%10, metadata, 1.0
+        );
+        BOOST_CHECK_EQUAL(num_sent, 40 + i%10);
+        metadata.time_spec += uhd::time_spec_t(0, num_sent, SAMP_RATE);
+    }
+
+    //check the sent packets, four samples per word
+    size_t num_accum_samps = 0;
+    uhd::transport::vrt::if_packet_info_t ifpi;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        dummy_send_xport.pop_front_packet(ifpi);
+        BOOST_CHECK_EQUAL(ifpi.num_payload_words32, (40 + i%10 + 3)/4);
+        BOOST_CHECK(ifpi.has_tsf);
+        BOOST_CHECK_EQUAL(ifpi.tsf, num_accum_samps*TICK_RATE/SAMP_RATE);
+        BOOST_CHECK_EQUAL(ifpi.sob, i == 0);
+        BOOST_CHECK_EQUAL(ifpi.eob, i == NUM_PKTS_TO_TEST-1);
+        num_accum_samps += 40 + i%10;
+    }
+}
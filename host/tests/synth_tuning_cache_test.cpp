@@ -0,0 +1,69 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <boost/tuple/tuple.hpp>
+#include <boost/tuple/tuple_comparison.hpp>
+#include "../lib/usrp/common/synth_tuning_cache.hpp"
+
+typedef boost::tuple<double, double, bool> key_type;
+
+BOOST_AUTO_TEST_CASE(test_synth_tuning_cache_lookup){
+    synth_tuning_cache<key_type, int> cache(4);
+    int solution = 0;
+    BOOST_CHECK(not cache.get(key_type(1e9, 10e6, false), solution));
+
+    cache.put(key_type(1e9, 10e6, false), 1);
+    cache.put(key_type(1e9, 10e6, true), 2);
+    BOOST_CHECK_EQUAL(cache.size(), 2);
+
+    BOOST_CHECK(cache.get(key_type(1e9, 10e6, false), solution));
+    BOOST_CHECK_EQUAL(solution, 1);
+    BOOST_CHECK(cache.get(key_type(1e9, 10e6, true), solution));
+    BOOST_CHECK_EQUAL(solution, 2);
+    BOOST_CHECK(not cache.get(key_type(1e9, 20e6, false), solution));
+
+    //storing a key again replaces its solution
+    cache.put(key_type(1e9, 10e6, true), 3);
+    BOOST_CHECK_EQUAL(cache.size(), 2);
+    BOOST_CHECK(cache.get(key_type(1e9, 10e6, true), solution));
+    BOOST_CHECK_EQUAL(solution, 3);
+
+    cache.clear();
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+    BOOST_CHECK(not cache.get(key_type(1e9, 10e6, false), solution));
+}
+
+BOOST_AUTO_TEST_CASE(test_synth_tuning_cache_eviction){
+    synth_tuning_cache<key_type, int> cache(3);
+    int solution = 0;
+    cache.put(key_type(1e9, 10e6, false), 1);
+    cache.put(key_type(2e9, 10e6, false), 2);
+    cache.put(key_type(3e9, 10e6, false), 3);
+
+    //use the oldest, so the second one is the least recently used
+    BOOST_CHECK(cache.get(key_type(1e9, 10e6, false), solution));
+    cache.put(key_type(4e9, 10e6, false), 4);
+    BOOST_CHECK_EQUAL(cache.size(), 3);
+
+    BOOST_CHECK(not cache.get(key_type(2e9, 10e6, false), solution));
+    BOOST_CHECK(cache.get(key_type(1e9, 10e6, false), solution));
+    BOOST_CHECK_EQUAL(solution, 1);
+    BOOST_CHECK(cache.get(key_type(3e9, 10e6, false), solution));
+    BOOST_CHECK(cache.get(key_type(4e9, 10e6, false), solution));
+    BOOST_CHECK_EQUAL(solution, 4);
+}
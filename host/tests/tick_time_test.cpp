@@ -0,0 +1,62 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include "../lib/transport/tick_time.hpp"
+
+using namespace uhd::transport::sph;
+using uhd::time_spec_t;
+
+BOOST_AUTO_TEST_CASE(test_tick_time_whole_ratio){
+    const double tick_rate = 200e6, samp_rate = 200e6/3;
+    samp_clock clock;
+    clock.set_rates(tick_rate, samp_rate);
+
+    const tick_time t0(123456789, tick_rate);
+    BOOST_CHECK_EQUAL(clock.offset(t0, 100).get_ticks(), 123456789 + 300);
+    BOOST_CHECK(clock.offset(t0, 1) > t0);
+    BOOST_CHECK(clock.offset(t0, 0) == t0);
+
+    //same result as the time spec arithmetic
+    const time_spec_t expected = t0.to_time_spec() + time_spec_t::from_ticks(100, samp_rate);
+    BOOST_CHECK_EQUAL(clock.offset_time_spec(t0, 100).to_ticks(tick_rate), expected.to_ticks(tick_rate));
+}
+
+BOOST_AUTO_TEST_CASE(test_tick_time_other_ratio){
+    const double tick_rate = 100e6, samp_rate = 30e6;
+    samp_clock clock;
+    clock.set_rates(tick_rate, samp_rate);
+
+    const tick_time t0(1000, tick_rate);
+    const time_spec_t expected = t0.to_time_spec() + time_spec_t::from_ticks(3, samp_rate);
+    BOOST_CHECK_CLOSE(clock.offset_time_spec(t0, 3).get_real_secs(), expected.get_real_secs(), 1e-9);
+    BOOST_CHECK_EQUAL(clock.offset(t0, 3).get_ticks(), expected.to_ticks(tick_rate));
+}
+
+BOOST_AUTO_TEST_CASE(test_tick_time_long_capture){
+    //a day of packets stays on the exact tick
+    const double tick_rate = 184.32e6, samp_rate = 184.32e6/8;
+    samp_clock clock;
+    clock.set_rates(tick_rate, samp_rate);
+
+    tick_time t(0, tick_rate);
+    const size_t spp = 364;
+    const long long npackets = (long long)(samp_rate*86400)/spp;
+    for (long long i = 0; i < npackets; i++) t = clock.offset(t, spp);
+    BOOST_CHECK_EQUAL(t.get_ticks(), npackets*spp*8);
+    BOOST_CHECK_EQUAL(t.to_time_spec().to_ticks(tick_rate), npackets*spp*8);
+}
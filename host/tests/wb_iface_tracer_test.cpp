@@ -0,0 +1,111 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include "../lib/usrp/cores/wb_iface_tracer.hpp"
+#include <uhd/exception.hpp>
+#include <uhd/utils/atomic.hpp>
+#include <vector>
+
+using namespace uhd;
+
+//! A bus where every register reads back as its address plus one
+class fake_wb_iface : public wb_iface{
+public:
+    void poke32(const wb_addr_type, const boost::uint32_t){}
+
+    boost::uint32_t peek32(const wb_addr_type addr){
+        return addr + 1;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(test_wb_iface_tracer_records){
+    wb_iface_tracer::sptr tracer = wb_iface_tracer::make(wb_iface::sptr(new fake_wb_iface()), 8);
+    tracer->poke32(0x10, 0x1234);
+    BOOST_CHECK_EQUAL(tracer->peek32(0x20), 0x21);
+
+    const std::vector<wb_iface_tracer::record_type> records = tracer->get_records();
+    BOOST_REQUIRE_EQUAL(records.size(), 2);
+    BOOST_CHECK_EQUAL(records[0].op, wb_iface_tracer::OP_POKE32);
+    BOOST_CHECK_EQUAL(records[0].addr, 0x10);
+    BOOST_CHECK_EQUAL(records[0].data, 0x1234);
+    BOOST_CHECK_EQUAL(records[1].op, wb_iface_tracer::OP_PEEK32);
+    BOOST_CHECK_EQUAL(records[1].addr, 0x20);
+    BOOST_CHECK_EQUAL(records[1].data, 0x21);
+    BOOST_CHECK(records[0].time <= records[1].time);
+    BOOST_CHECK(records[1].latency >= 0.0);
+
+    //the traced bus has no command time
+    BOOST_CHECK_THROW(tracer->get_time(), uhd::not_implemented_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_wb_iface_tracer_wraparound){
+    //the capacity is rounded up to 8
+    wb_iface_tracer::sptr tracer = wb_iface_tracer::make(wb_iface::sptr(new fake_wb_iface()), 5);
+    for (size_t i = 0; i < 20; i++){
+        tracer->poke32(i, 0);
+    }
+
+    //only the most recent accesses are kept, oldest first
+    std::vector<wb_iface_tracer::record_type> records = tracer->get_records();
+    BOOST_CHECK_EQUAL(tracer->get_num_accesses(), 20);
+    BOOST_REQUIRE_EQUAL(records.size(), 8);
+    for (size_t i = 0; i < records.size(); i++){
+        BOOST_CHECK_EQUAL(records[i].addr, 12 + i);
+    }
+
+    //a clear forgets everything up to now, also in a wrapped ring
+    tracer->clear();
+    BOOST_CHECK_EQUAL(tracer->get_num_accesses(), 0);
+    BOOST_CHECK(tracer->get_records().empty());
+    tracer->poke32(100, 0);
+    tracer->poke32(101, 0);
+    records = tracer->get_records();
+    BOOST_CHECK_EQUAL(tracer->get_num_accesses(), 2);
+    BOOST_REQUIRE_EQUAL(records.size(), 2);
+    BOOST_CHECK_EQUAL(records[0].addr, 100);
+    BOOST_CHECK_EQUAL(records[1].addr, 101);
+}
+
+static void hammer(wb_iface_tracer::sptr tracer, atomic_uint32_t *running){
+    for (boost::uint32_t addr = 0; running->read(); addr++){
+        tracer->peek32(addr);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_wb_iface_tracer_concurrent){
+    wb_iface_tracer::sptr tracer = wb_iface_tracer::make(wb_iface::sptr(new fake_wb_iface()), 16);
+    atomic_uint32_t running;
+    running.write(1);
+    boost::thread writer(boost::bind(&hammer, tracer, &running));
+
+    //records that a writer was filling are skipped, the rest are whole and in order
+    for (size_t n = 0; n < 2000; n++){
+        const std::vector<wb_iface_tracer::record_type> records = tracer->get_records();
+        BOOST_REQUIRE(records.size() <= 16);
+        for (size_t i = 0; i < records.size(); i++){
+            BOOST_REQUIRE_EQUAL(records[i].op, wb_iface_tracer::OP_PEEK32);
+            BOOST_REQUIRE_EQUAL(records[i].data, records[i].addr + 1);
+            if (i > 0) BOOST_REQUIRE(records[i].addr > records[i-1].addr);
+        }
+    }
+
+    running.write(0);
+    writer.join();
+}
@@ -17,14 +17,21 @@
 
 #include <uhd/utils/safe_main.hpp>
 #include <uhd/types/dict.hpp>
+#include <uhd/types/time_spec.hpp>
 #include <uhd/convert.hpp>
 #include <uhd/exception.hpp>
+#include <uhd/version.hpp>
 #include <boost/program_options.hpp>
 #include <boost/format.hpp>
 #include <boost/timer.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/barrier.hpp>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/algorithm/string.hpp>
 #include <iostream>
 #include <iomanip>
+#include <fstream>
 #include <map>
 #include <complex>
 
@@ -51,27 +58,39 @@ std::string format_to_type(const std::string &format)
     return ret_val;
 }
 
-void configure_conv(
-        converter::sptr conv,
+// Returns the scalar a converter between these types needs,
+// or 0 if it needs no configuration.
+double get_default_scalar(
         const std::string &in_type,
         const std::string &out_type
 ) {
     if (in_type == "sc16") {
-        if (out_type == "fc32") {
-            std::cout << "Setting scalar to 32767." << std::endl;
-            conv->set_scalar(32767.);
-            return;
+        if (out_type == "fc32" or out_type == "sc8") {
+            return 32767.;
         }
     }
 
     if (in_type == "fc32") {
         if (out_type == "sc16") {
-            std::cout << "Setting scalar to 32767." << std::endl;
-            conv->set_scalar(32767.);
-            return;
+            return 32767.;
         }
     }
 
+    return 0.0;
+}
+
+void configure_conv(
+        converter::sptr conv,
+        const std::string &in_type,
+        const std::string &out_type
+) {
+    const double scalar = get_default_scalar(in_type, out_type);
+    if (scalar != 0.0) {
+        std::cout << "Setting scalar to " << scalar << "." << std::endl;
+        conv->set_scalar(scalar);
+        return;
+    }
+
     std::cout << "No configuration required." << std::endl;
 }
 
@@ -129,7 +148,9 @@ void init_buffers(
     /// Fill with incrementing integers
     if (buf_seed_mode == INC) {
         for (size_t i = 0; i < buf.size(); i++) {
-            if (type == "sc8") {
+            if (type == "sc4") {
+                init_inc_vector< boost::uint8_t >(buf[i], n_items);
+            } else if (type == "sc8") {
                 init_inc_vector< std::complex<boost::int8_t> >(buf[i], n_items);
             } else if (type == "sc16") {
                 init_inc_vector< std::complex<boost::int16_t> >(buf[i], n_items);
@@ -160,7 +181,9 @@ void init_buffers(
 
     /// Fill with random data
     for (size_t i = 0; i < buf.size(); i++) {
-        if (type == "sc8") {
+        if (type == "sc4") {
+            init_random_vector_real_int<boost::uint8_t>(buf[i], n_items);
+        } else if (type == "sc8") {
             init_random_vector_complex_int<boost::int8_t>(buf[i], n_items);
         } else if (type == "sc16") {
             init_random_vector_complex_int<boost::int16_t>(buf[i], n_items);
@@ -199,6 +222,232 @@ double run_benchmark(
     return benchmark_timer.elapsed();
 }
 
+/***********************************************************************
+ * Suite mode:
+ * Every registered converter ID and priority, over a sweep of buffer
+ * sizes and thread counts. Every thread runs its own converter instance
+ * on its own buffers, so the aggregate rate shows where the memory
+ * bandwidth saturates.
+ **********************************************************************/
+struct suite_buffers_t
+{
+    std::vector< std::vector<char> > input, output;
+    std::vector<const void *> input_refs;
+    std::vector<void *> output_refs;
+};
+
+struct suite_result_t
+{
+    id_type id;
+    priority_type prio;
+    size_t n_samples, n_threads, iterations;
+    double ns_per_sample, gbytes_per_sec;
+};
+
+void init_suite_buffers(
+        suite_buffers_t &buffs,
+        const id_type &id,
+        const size_t in_size,
+        const size_t out_size,
+        const size_t n_samples
+) {
+    // Interleaving converters (e.g. 1 -> 2) have n_samples per channel in the
+    // single buffer. Pad the buffers, some converters work on whole words.
+    const size_t n_chans = std::max(id.num_inputs, id.num_outputs);
+    buffs.input.assign(id.num_inputs, std::vector<char>(in_size * n_samples * n_chans + 16, 0));
+    buffs.output.assign(id.num_outputs, std::vector<char>(out_size * n_samples * n_chans + 16, 0));
+    try {
+        init_buffers(buffs.input, format_to_type(id.input_format), in_size, RANDOM);
+    } catch (const uhd::runtime_error &) {
+        // Not a type we know how to fill, random bytes will do
+        for (size_t i = 0; i < buffs.input.size(); i++) {
+            init_random_vector_real_int<boost::uint8_t>(buffs.input[i], buffs.input[i].size());
+        }
+    }
+    buffs.input_refs.resize(id.num_inputs);
+    buffs.output_refs.resize(id.num_outputs);
+    for (size_t i = 0; i < id.num_inputs; i++) {
+        buffs.input_refs[i] = reinterpret_cast<const void *>(&buffs.input[i][0]);
+    }
+    for (size_t i = 0; i < id.num_outputs; i++) {
+        buffs.output_refs[i] = reinterpret_cast<void *>(&buffs.output[i][0]);
+    }
+}
+
+void suite_thread(
+        boost::barrier *start,
+        converter::sptr conv,
+        const suite_buffers_t *buffs,
+        const size_t n_samples,
+        const size_t iterations
+) {
+    start->wait();
+    for (size_t i = 0; i < iterations; i++) {
+        conv->conv(buffs->input_refs, buffs->output_refs, n_samples);
+    }
+}
+
+// Returns the wall clock time for all threads to finish their iterations
+double run_suite_threads(
+        const std::vector<converter::sptr> &convs,
+        const std::vector< boost::shared_ptr<suite_buffers_t> > &buffs,
+        const size_t n_threads,
+        const size_t n_samples,
+        const size_t iterations
+) {
+    boost::barrier start(n_threads + 1);
+    boost::thread_group threads;
+    for (size_t i = 0; i < n_threads; i++) {
+        threads.create_thread(boost::bind(
+            &suite_thread, &start, convs[i], buffs[i].get(), n_samples, iterations
+        ));
+    }
+    start.wait();
+    const uhd::time_spec_t t0 = uhd::time_spec_t::get_system_time();
+    threads.join_all();
+    return (uhd::time_spec_t::get_system_time() - t0).get_real_secs();
+}
+
+std::vector<suite_result_t> run_suite_for_converter(
+        const id_type &id,
+        const priority_type prio,
+        const std::vector<size_t> &sizes,
+        const std::vector<size_t> &thread_counts,
+        const double min_time
+) {
+    std::vector<suite_result_t> results;
+    const size_t in_size = get_bytes_per_item(id.input_format);
+    const size_t out_size = get_bytes_per_item(id.output_format);
+    const double scalar = get_default_scalar(
+        format_to_type(id.input_format), format_to_type(id.output_format)
+    );
+    const size_t max_threads = thread_counts.back();
+
+    // One converter instance per thread, they can hold state
+    std::vector<converter::sptr> convs(max_threads);
+    for (size_t i = 0; i < max_threads; i++) {
+        convs[i] = get_converter(id, prio)();
+        if (scalar != 0.0) {
+            convs[i]->set_scalar(scalar);
+        }
+    }
+
+    BOOST_FOREACH(const size_t n_samples, sizes) {
+        std::vector< boost::shared_ptr<suite_buffers_t> > buffs(max_threads);
+        for (size_t i = 0; i < max_threads; i++) {
+            buffs[i].reset(new suite_buffers_t);
+            init_suite_buffers(*buffs[i], id, in_size, out_size, n_samples);
+        }
+
+        // Find the number of iterations that runs for min_time on one thread
+        size_t iterations = 1;
+        run_suite_threads(convs, buffs, 1, n_samples, 1); // warm up
+        while (true) {
+            const double elapsed = run_suite_threads(convs, buffs, 1, n_samples, iterations);
+            if (elapsed >= min_time / 4 or iterations >= (size_t(1) << 30)) {
+                iterations = std::max<size_t>(1, size_t(iterations * min_time / std::max(elapsed, 1e-9)));
+                break;
+            }
+            iterations *= 2;
+        }
+
+        BOOST_FOREACH(const size_t n_threads, thread_counts) {
+            const double elapsed = run_suite_threads(convs, buffs, n_threads, n_samples, iterations);
+            const double samps_per_thread = double(iterations) * n_samples;
+            const double bytes_per_samp = double((in_size + out_size) * std::max(id.num_inputs, id.num_outputs));
+            suite_result_t result;
+            result.id = id;
+            result.prio = prio;
+            result.n_samples = n_samples;
+            result.n_threads = n_threads;
+            result.iterations = iterations;
+            result.ns_per_sample = elapsed * 1e9 / samps_per_thread;
+            result.gbytes_per_sec = samps_per_thread * n_threads * bytes_per_samp / elapsed / 1e9;
+            results.push_back(result);
+            std::cerr << boost::format("%s prio %d: %d samples, %d thread(s): %.3f ns/sample, %.3f GB/s")
+                % id.to_string() % prio % n_samples % n_threads
+                % result.ns_per_sample % result.gbytes_per_sec
+                << std::endl;
+        }
+    }
+
+    return results;
+}
+
+void write_suite_json(std::ostream &os, const std::vector<suite_result_t> &results)
+{
+    os << "{" << std::endl;
+    os << "  \"uhd_version\": \"" << uhd::get_version_string() << "\"," << std::endl;
+    os << "  \"results\": [" << std::endl;
+    for (size_t i = 0; i < results.size(); i++) {
+        const suite_result_t &r = results[i];
+        os << boost::format(
+                "    {\"in\": \"%s\", \"out\": \"%s\", \"n_inputs\": %d, \"n_outputs\": %d, "
+                "\"prio\": %d, \"n_samples\": %d, \"threads\": %d, \"iterations\": %d, "
+                "\"ns_per_sample\": %.6f, \"gbytes_per_sec\": %.6f}%s")
+            % r.id.input_format % r.id.output_format % r.id.num_inputs % r.id.num_outputs
+            % r.prio % r.n_samples % r.n_threads % r.iterations
+            % r.ns_per_sample % r.gbytes_per_sec
+            % ((i + 1 < results.size()) ? "," : "")
+            << std::endl;
+    }
+    os << "  ]" << std::endl;
+    os << "}" << std::endl;
+}
+
+int run_suite(
+        const std::string &in_format,
+        const std::string &out_format,
+        const std::string &sizes_str,
+        size_t max_threads,
+        const double min_time,
+        const std::string &json_file
+) {
+    std::vector<std::string> sizes_list;
+    boost::split(sizes_list, sizes_str, boost::is_any_of(","), boost::token_compress_on);
+    std::vector<size_t> sizes;
+    BOOST_FOREACH(const std::string &size, sizes_list) {
+        sizes.push_back(boost::lexical_cast<size_t>(size));
+    }
+
+    // Powers of two up to the maximum, and the maximum itself
+    if (max_threads == 0) {
+        max_threads = std::max<size_t>(1, boost::thread::hardware_concurrency());
+    }
+    std::vector<size_t> thread_counts;
+    for (size_t n = 1; n < max_threads; n *= 2) {
+        thread_counts.push_back(n);
+    }
+    thread_counts.push_back(max_threads);
+
+    std::vector<suite_result_t> results;
+    BOOST_FOREACH(const id_type &id, get_converter_ids()) {
+        if (not in_format.empty() and id.input_format != in_format) continue;
+        if (not out_format.empty() and id.output_format != out_format) continue;
+        BOOST_FOREACH(const priority_type prio, get_converter_priorities(id)) {
+            if (prio < 0) continue; // placeholders
+            try {
+                const std::vector<suite_result_t> conv_results =
+                    run_suite_for_converter(id, prio, sizes, thread_counts, min_time);
+                results.insert(results.end(), conv_results.begin(), conv_results.end());
+            } catch (const uhd::exception &e) {
+                std::cerr << "Skipping " << id.to_string() << " prio " << prio
+                          << ": " << e.what() << std::endl;
+            }
+        }
+    }
+
+    if (json_file.empty()) {
+        std::cout << "{{{" << std::endl;
+        write_suite_json(std::cout, results);
+        std::cout << "}}}" << std::endl;
+    } else {
+        std::ofstream json(json_file.c_str());
+        write_suite_json(json, results);
+    }
+    return EXIT_SUCCESS;
+}
+
 template <typename T>
 std::string void_ptr_to_hexstring(const void *v_ptr, size_t index)
 {
@@ -268,8 +517,11 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
     std::string in_format, out_format;
     std::string priorities;
     std::string seed_mode;
+    std::string sizes, json_file;
     priority_type prio = -1, max_prio;
     size_t iterations, n_samples;
+    size_t max_threads;
+    double min_time;
     size_t n_inputs, n_outputs;
     buf_init_t buf_seed_mode = RANDOM;
 
@@ -288,6 +540,11 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
         ("debug-converter", "Skip benchmark and print conversion results. Implies iterations==1 and will only run on a single converter.")
         ("seed-mode", po::value<std::string>(&seed_mode)->default_value("random"), "How to initialize the data: random, incremental")
         ("hex", "When using debug mode, dump memory in hex")
+        ("suite", "Benchmark every registered converter and priority (optionally only those matching --in/--out) and print the results as JSON.")
+        ("sizes", po::value<std::string>(&sizes)->default_value("256,4096,65536,1048576,4194304"), "Suite mode: comma-separated list of buffer sizes in samples")
+        ("threads", po::value<size_t>(&max_threads)->default_value(0), "Suite mode: largest number of concurrent threads (0 for the number of CPUs)")
+        ("min-time", po::value<double>(&min_time)->default_value(0.05), "Suite mode: minimum duration of every measurement in seconds")
+        ("json-file", po::value<std::string>(&json_file), "Suite mode: write the JSON results to this file instead of stdout")
     ;
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -301,10 +558,19 @@ int UHD_SAFE_MAIN(int argc, char *argv[])
                      "  for every conversion run in CSV format to stdout. Every line between\n"
                      "  the output delimiters {{{ }}} is of the format: <PRIO>,<TIME IN MILLISECONDS>\n"
                      "  When using for converter debugging, every line is formatted as\n"
-                     "  <INPUT_VALUE>,<OUTPUT_VALUE>\n" << std::endl;
+                     "  <INPUT_VALUE>,<OUTPUT_VALUE>\n"
+                     "  In suite mode, every converter is run for every buffer size with\n"
+                     "  1, 2, 4, ... threads, and the results are printed as JSON with the\n"
+                     "  time per sample (per thread) and the aggregate rate in GB/s\n"
+                     "  (input and output bytes), between the output delimiters or into\n"
+                     "  --json-file. Progress goes to stderr.\n" << std::endl;
         return EXIT_FAILURE;
     }
 
+    if (vm.count("suite")) {
+        return run_suite(in_format, out_format, sizes, max_threads, min_time, json_file);
+    }
+
     // Parse more arguments
     if (seed_mode == "incremental") {
         buf_seed_mode = INC;
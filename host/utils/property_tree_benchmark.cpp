@@ -0,0 +1,167 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/utils/safe_main.hpp>
+#include <uhd/property_tree.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/utils/atomic.hpp>
+#include <boost/program_options.hpp>
+#include <boost/format.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/barrier.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <iostream>
+#include <vector>
+
+namespace po = boost::program_options;
+using uhd::fs_path;
+
+/***********************************************************************
+ * A tree shaped like a multi channel device:
+ * per motherboard a few dsps and dboards with frontends and gains.
+ **********************************************************************/
+static std::vector<fs_path> make_device_tree(uhd::property_tree::sptr tree, const size_t num_mboards){
+    std::vector<fs_path> paths; //the paths a control loop would touch
+    for (size_t m = 0; m < num_mboards; m++){
+        const fs_path mb_path = fs_path("/mboards") / m;
+        tree->create<double>(mb_path / "tick_rate").set(200e6);
+        tree->create<uhd::time_spec_t>(mb_path / "time/now");
+        for (size_t i = 0; i < 4; i++){
+            const fs_path dsp_path = mb_path / "rx_dsps" / i;
+            tree->create<double>(dsp_path / "rate/value").set(1e6);
+            tree->create<double>(dsp_path / "freq/value").set(0.0);
+            paths.push_back(dsp_path / "freq/value");
+        }
+        for (size_t db = 0; db < 2; db++){
+            for (size_t i = 0; i < 2; i++){
+                const fs_path fe_path = mb_path / "dboards" / (db? "B" : "A") / "rx_frontends" / i;
+                tree->create<double>(fe_path / "freq/value").set(1e9);
+                tree->create<std::string>(fe_path / "antenna/value").set("RX2");
+                tree->create<double>(fe_path / "gains/PGA0/value").set(0.0);
+                tree->create<double>(fe_path / "bandwidth/value").set(20e6);
+                paths.push_back(fe_path / "freq/value");
+                paths.push_back(fe_path / "gains/PGA0/value");
+            }
+        }
+    }
+    return paths;
+}
+
+/***********************************************************************
+ * Reader threads access() and get() the paths round robin,
+ * an optional writer keeps creating and removing a branch.
+ **********************************************************************/
+static void reader_task(
+    uhd::property_tree::sptr tree, const std::vector<fs_path> &paths,
+    boost::barrier &start, uhd::atomic_uint32_t &running, size_t &count
+){
+    size_t n = 0;
+    start.wait();
+    while (running.read()){
+        for (size_t i = 0; i < paths.size(); i++){
+            tree->access<double>(paths[i]).get();
+        }
+        n += paths.size();
+    }
+    count = n;
+}
+
+static void writer_task(
+    uhd::property_tree::sptr tree, boost::barrier &start, uhd::atomic_uint32_t &running, size_t &count
+){
+    size_t n = 0;
+    start.wait();
+    while (running.read()){
+        const fs_path path = fs_path("/scratch") / (n % 16);
+        tree->create<double>(path / "value").set(double(n));
+        tree->remove(path);
+        n++;
+    }
+    count = n;
+}
+
+int UHD_SAFE_MAIN(int argc, char *argv[])
+{
+    size_t max_threads, num_mboards;
+    double duration;
+
+    po::options_description desc("Property tree benchmark options:");
+    desc.add_options()
+        ("help", "help message")
+        ("threads", po::value<size_t>(&max_threads)->default_value(0), "Largest number of concurrent reader threads (0 for the number of CPUs)")
+        ("mboards", po::value<size_t>(&num_mboards)->default_value(2), "Number of motherboards in the test tree")
+        ("duration", po::value<double>(&duration)->default_value(1.0), "Duration of every measurement in seconds")
+        ("writer", "Also run a thread that keeps creating and removing properties")
+    ;
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    //print the help message
+    if (vm.count("help")){
+        std::cout << boost::format("UHD Property Tree Benchmark %s") % desc << std::endl << std::endl;
+        std::cout << "Measures the access() throughput of concurrent control threads." << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    if (max_threads == 0) max_threads = std::max<size_t>(1, boost::thread::hardware_concurrency());
+    const bool with_writer = vm.count("writer") > 0;
+
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    const std::vector<fs_path> paths = make_device_tree(tree, num_mboards);
+
+    std::cout << boost::format("%u properties accessed per pass%s") % paths.size()
+        % (with_writer? ", with a writer thread" : "") << std::endl;
+    std::cout << boost::format("%8s %16s %16s") % "threads" % "accesses/s" % "per thread/s" << std::endl;
+
+    for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2){
+        uhd::atomic_uint32_t running;
+        running.write(1);
+        std::vector<size_t> counts(num_threads, 0);
+        size_t writes = 0;
+        boost::barrier start(num_threads + (with_writer? 2 : 1));
+
+        boost::thread_group threads;
+        for (size_t i = 0; i < num_threads; i++){
+            threads.create_thread(boost::bind(&reader_task,
+                tree, boost::cref(paths), boost::ref(start), boost::ref(running), boost::ref(counts[i])));
+        }
+        if (with_writer){
+            threads.create_thread(boost::bind(&writer_task,
+                tree, boost::ref(start), boost::ref(running), boost::ref(writes)));
+        }
+
+        start.wait();
+        const uhd::time_spec_t t0 = uhd::time_spec_t::get_system_time();
+        boost::this_thread::sleep(boost::posix_time::microseconds(long(duration*1e6)));
+        running.write(0);
+        threads.join_all();
+        const double elapsed = (uhd::time_spec_t::get_system_time() - t0).get_real_secs();
+
+        size_t total = 0;
+        BOOST_FOREACH(const size_t count, counts) total += count;
+        std::cout << boost::format("%8u %16.0f %16.0f") % num_threads
+            % (total/elapsed) % (total/elapsed/num_threads);
+        if (with_writer) std::cout << boost::format("   (%.0f writes/s)") % (writes/elapsed);
+        std::cout << std::endl;
+
+        if (num_threads < max_threads and num_threads*2 > max_threads) num_threads = max_threads/2;
+    }
+
+    return EXIT_SUCCESS;
+}
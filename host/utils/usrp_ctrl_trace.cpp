@@ -0,0 +1,122 @@
+//
+// Copyright 2016 Ettus Research LLC
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <uhd/utils/safe_main.hpp>
+#include <uhd/usrp/multi_usrp.hpp>
+#include <uhd/property_tree.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <boost/program_options.hpp>
+#include <boost/format.hpp>
+#include <boost/foreach.hpp>
+#include <iostream>
+#include <vector>
+
+namespace po = boost::program_options;
+using uhd::fs_path;
+
+/***********************************************************************
+ * The traced register interfaces of all motherboards
+ **********************************************************************/
+static std::vector<fs_path> get_trace_paths(uhd::property_tree::sptr tree){
+    std::vector<fs_path> paths;
+    BOOST_FOREACH(const std::string &mb, tree->list("/mboards")){
+        const fs_path trace_path = fs_path("/mboards") / mb / "ctrl_trace";
+        if (not tree->exists(trace_path)) continue;
+        BOOST_FOREACH(const std::string &name, tree->list(trace_path)){
+            paths.push_back(trace_path / name);
+        }
+    }
+    return paths;
+}
+
+static void clear_traces(uhd::property_tree::sptr tree){
+    BOOST_FOREACH(const fs_path &path, get_trace_paths(tree)){
+        tree->access<bool>(path / "clear").set(true);
+    }
+}
+
+static void print_traces(uhd::property_tree::sptr tree, const std::string &title, const double elapsed, const bool records){
+    std::cout << std::endl << boost::format("=== %s (%.3f ms) ===") % title % (elapsed*1e3) << std::endl;
+    BOOST_FOREACH(const fs_path &path, get_trace_paths(tree)){
+        std::cout << std::endl << path << std::endl;
+        std::cout << tree->access<std::string>(path / "summary").get();
+        if (records) std::cout << tree->access<std::string>(path / "records").get();
+    }
+}
+
+int UHD_SAFE_MAIN(int argc, char *argv[]){
+    std::string args;
+    double rate, freq, gain;
+    size_t chan;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "help message")
+        ("args", po::value<std::string>(&args)->default_value(""), "multi uhd device address args")
+        ("chan", po::value<size_t>(&chan)->default_value(0), "the channel to configure")
+        ("rate", po::value<double>(&rate)->default_value(1e6), "RX rate to set in samples/s")
+        ("freq", po::value<double>(&freq)->default_value(1e9), "RX frequency to set in Hz")
+        ("gain", po::value<double>(&gain)->default_value(10), "RX gain to set in dB")
+        ("records", "also print every recorded register access")
+    ;
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    //print the help message
+    if (vm.count("help")){
+        std::cout << boost::format("UHD Control Trace %s") % desc << std::endl;
+        std::cout
+            << "Counts and times the register accesses of common settings calls." << std::endl
+            << "The device is opened with the trace_ctrl device argument," << std::endl
+            << "which only some devices support (X300 series)." << std::endl
+            << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    const bool records = vm.count("records") > 0;
+    uhd::device_addr_t dev_addr(args);
+    dev_addr["trace_ctrl"] = "1";
+
+    std::cout << boost::format("Creating the usrp device with: %s...") % dev_addr.to_string() << std::endl;
+    uhd::usrp::multi_usrp::sptr usrp = uhd::usrp::multi_usrp::make(dev_addr);
+    uhd::property_tree::sptr tree = usrp->get_device()->get_tree();
+    if (get_trace_paths(tree).empty()){
+        std::cerr << "This device does not support control tracing." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    //each settings call is run with fresh traces
+    uhd::time_spec_t start;
+
+    clear_traces(tree);
+    start = uhd::time_spec_t::get_system_time();
+    usrp->set_rx_rate(rate, chan);
+    print_traces(tree, "set_rx_rate", (uhd::time_spec_t::get_system_time() - start).get_real_secs(), records);
+
+    clear_traces(tree);
+    start = uhd::time_spec_t::get_system_time();
+    usrp->set_rx_freq(uhd::tune_request_t(freq), chan);
+    print_traces(tree, "set_rx_freq", (uhd::time_spec_t::get_system_time() - start).get_real_secs(), records);
+
+    clear_traces(tree);
+    start = uhd::time_spec_t::get_system_time();
+    usrp->set_rx_gain(gain, chan);
+    print_traces(tree, "set_rx_gain", (uhd::time_spec_t::get_system_time() - start).get_real_secs(), records);
+
+    return EXIT_SUCCESS;
+}